@@ -0,0 +1,4 @@
+(variance (0.5 1 1.5 2))
+(kernelSize (5 7 9))
+(thresholdMin (0.300000012 0.5 0.699999988))
+(thresholdMax (0.0199999996 0.0399999991 0.0799999982 0.159999996))
@@ -10,6 +10,15 @@
 #include <ltiLispStreamHandler.h>
 
 #include <ltiCannyEdges.h>
+#include "ltiStagedCannyEdges.h"
+#include "ltiRecursiveGaussian.h"
+#include "ltiTiledCannyEdges.h"
+#include "ltiRowStream.h"
+#include <ltiGaussKernels.h>
+#include <ltiConvolution.h>
+#include "ltiWorkerPool.h"
+#include "ltiImageFiles.h"
+#include "ltiBitMask.h"
 
 #include <ltiDraw.h>
 #include <ltiViewer2D.h>
@@ -26,6 +35,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <vector>
 
 // Debug
 
@@ -40,7 +50,8 @@ using std::endl;
 
 
 canny::canny(int argc, char* argv[]) 
-  : task_(None) {
+  : task_(None),batch_(false),sweep_(false),tiled_(false),threads_(0),
+    bandHeight_(256),outputDir_(".") {
   parse(argc,argv);
 }
 
@@ -50,10 +61,22 @@ canny::canny(int argc, char* argv[])
  */
 void canny::usage() const {
   cout <<
-    "usage: canny [options] <image> \n\n" \
+    "usage: canny [options] <image> \n" \
+    "       canny -b [options] [<image>|<dir> ...]\n" \
+    "       canny -t [options] [<image> ...]\n\n" \
     "       -f      Use gray-channel of floats\n" \
     "       -8      Use gray-channel of bytes\n" \
-    "       <image>  input image" << std::endl; 
+    "       -b      Batch mode: no viewer, save the masks of all images\n" \
+    "       -j n    Number of threads in batch mode (default: one per CPU)\n"\
+    "       -o dir  Output directory for the masks in batch mode\n" \
+    "       -L file File with one image name per line (batch mode)\n" \
+    "       -s      Sweep the parameter grid of canny-sweep.lsp over all\n" \
+    "               images and print a table with the edge counts\n" \
+    "       -t      Tiled mode: stream huge PGM/PPM/PNG images in bands of\n"\
+    "               rows and write the masks as PGM or PNG\n" \
+    "       -B rows Rows per band in tiled mode (default: 256)\n" \
+    "       <image>  input image\n" \
+    "       <dir>    all images in the directory (batch mode)" << std::endl; 
 }
 
 void canny::help() const {
@@ -64,6 +87,9 @@ void canny::help() const {
     " m      Select max theshold (all > IS edge).\n" \
     " l      Select low theshold (edge only if neighbor is edge).\n" \
     " g      Gradient type.\n" \
+    " r      Toggle recursive/convolution Gaussian smoothing.\n" \
+    " p      Toggle serial/parallel hysteresis.\n" \
+    " i      Toggle fixed point/floating point stages (with -8).\n" \
     " Arrows Increase/Decrease selected value.\n" \
     " ?      Print this message.\n" << std::endl;
 }
@@ -83,12 +109,19 @@ void canny::parse(int argc, char*argv[]) {
     {"float",no_argument,0,'f'},
     {"byte",no_argument,0,'8'},
     {"help",no_argument,0,'h'},
+    {"batch",no_argument,0,'b'},
+    {"threads",required_argument,0,'j'},
+    {"output",required_argument,0,'o'},
+    {"list",required_argument,0,'L'},
+    {"sweep",no_argument,0,'s'},
+    {"tiled",no_argument,0,'t'},
+    {"band",required_argument,0,'B'},
     {0,0,0,0}
   };
 
   int optionIdx;
 
-  while ((c = getopt_long(argc, argv, "f8h", lopts,&optionIdx)) != -1) {
+  while ((c = getopt_long(argc, argv, "f8hbstj:o:L:B:", lopts,&optionIdx)) != -1) {
     switch (c) {
     case 'f':
       task_=Float;
@@ -96,6 +129,28 @@ void canny::parse(int argc, char*argv[]) {
     case '8':
       task_=Byte;
       break;
+    case 'b':
+      batch_=true;
+      break;
+    case 's':
+      sweep_=true;
+      break;
+    case 't':
+      tiled_=true;
+      break;
+    case 'B':
+      bandHeight_=atoi(optarg);
+      break;
+    case 'j':
+      threads_=atoi(optarg);
+      break;
+    case 'o':
+      outputDir_=optarg;
+      break;
+    case 'L':
+      listFile_=optarg;
+      batch_=true;
+      break;
     case 'h':
       usage();
       exit(EXIT_SUCCESS);
@@ -109,13 +164,14 @@ void canny::parse(int argc, char*argv[]) {
   if (optind < argc) {
     imgFile_ = argv[optind];
   }
-  
 
-}
+  while (optind < argc) {
+    inputs_.push_back(argv[optind++]);
+  }
 
+}
 
-bool canny::apply() {
-  lti::cannyEdges::parameters thPar;
+void canny::loadParameters(lti::cannyEdges::parameters& thPar) const {
   static const char* filecanny = "canny.lsp";
 
   lti::lispStreamHandler lsh;
@@ -130,10 +186,163 @@ bool canny::apply() {
     out.close();
   }
   in.close();
+}
+
+/*
+ * Compare the recursive Gaussian with the convolution kernel of the given
+ * parameters, reporting the time and the deviation of both.
+ */
+static void compareSmoothing(const lti::channel& chnl,
+                             const lti::stagedCannyEdges::parameters& par) {
+  lti::timer chrono;
+  lti::channel fir,iir;
+
+  lti::gaussKernel2D<float> kern(par.kernelSize,par.variance);
+  lti::convolution::parameters convPar;
+  convPar.boundaryType = lti::Constant;
+  convPar.setKernel(kern);
+  lti::convolution conv(convPar);
+
+  chrono.start();
+  conv.apply(chnl,fir);
+  chrono.stop();
+  const double tfir = chrono.getTime();
+
+  lti::recursiveGaussian gauss(par.variance);
+  chrono.start();
+  gauss.apply(chnl,iir);
+  chrono.stop();
+  const double tiir = chrono.getTime();
+
+  double sum2 = 0.0;
+  float maxErr = 0.0f;
+  lti::channel::const_iterator fit,iit,eit;
+  for (fit=fir.begin(),iit=iir.begin(),eit=fir.end();fit!=eit;++fit,++iit) {
+    const float err = lti::abs(*fit - *iit);
+    sum2 += err*err;
+    maxErr = lti::max(maxErr,err);
+  }
+  const double rms = sqrt(sum2/(static_cast<double>(chnl.rows())*
+                                chnl.columns()));
+
+  std::cout << "  Convolution (" << par.kernelSize << " taps): "
+            << tfir/1000.0 << " ms\n"
+            << "  Recursive: " << tiir/1000.0 << " ms\n"
+            << "  Deviation from the kernel: RMS " << rms
+            << ", max " << maxErr << " (input range [0,1])" << std::endl;
+}
+
+/*
+ * Compare the serial and the parallel hysteresis on the cached stages of
+ * the detector, reporting the time of both, the speedup and whether the
+ * masks are identical.
+ */
+static void compareHysteresis(lti::stagedCannyEdges& staged,
+                              const lti::stagedCannyEdges::parameters& par) {
+  const float high = par.thresholdMax*staged.getMaxMagnitude();
+  const float low = par.thresholdMin*high;
+
+  lti::stagedCannyEdges::parameters hPar(par);
+  lti::channel8 serial,parallel;
+  lti::timer chrono;
+
+  hPar.hysteresisThreads = 1;
+  staged.setParameters(hPar);
+  chrono.start();
+  staged.hysteresis(low,high,serial);
+  chrono.stop();
+  const double ts = chrono.getTime();
+
+  hPar.hysteresisThreads = (par.hysteresisThreads == 1) ?
+    0 : par.hysteresisThreads;
+  staged.setParameters(hPar);
+  chrono.start();
+  staged.hysteresis(low,high,parallel);
+  chrono.stop();
+  const double tp = chrono.getTime();
+
+  staged.setParameters(par);
+
+  int diff = 0;
+  lti::channel8::const_iterator sit,pit,eit;
+  for (sit=serial.begin(),pit=parallel.begin(),eit=serial.end();
+       sit!=eit;++sit,++pit) {
+    if (*sit != *pit) {
+      ++diff;
+    }
+  }
+
+  std::cout << "  Serial hysteresis: " << ts/1000.0 << " ms\n"
+            << "  Parallel hysteresis ("
+            << lti::workerPool::getNumberOfProcessors()
+            << " processors): " << tp/1000.0 << " ms, speedup "
+            << ts/tp << "\n"
+            << "  Pixels differing: " << diff << std::endl;
+}
+
+/*
+ * Compare the floating point and the fixed point stages on the given
+ * channel, reporting the time of both and the pixels where the masks differ.
+ */
+static void compareFixedPoint(const lti::channel8& chnl8,
+                              const lti::stagedCannyEdges::parameters& par) {
+  lti::stagedCannyEdges::parameters fPar(par);
+  lti::stagedCannyEdges staged;
+  lti::channel8 floating,fixed;
+  lti::timer chrono;
+
+  staged.use(chnl8);
+
+  fPar.fixedPoint = false;
+  staged.setParameters(fPar);
+  chrono.start();
+  staged.apply(floating);
+  chrono.stop();
+  const double tf = chrono.getTime();
+
+  fPar.fixedPoint = true;
+  staged.setParameters(fPar);
+  chrono.start();
+  staged.apply(fixed);
+  chrono.stop();
+  const double ti = chrono.getTime();
+
+  int diff = 0;
+  lti::channel8::const_iterator fit,iit,eit;
+  for (fit=floating.begin(),iit=fixed.begin(),eit=floating.end();
+       fit!=eit;++fit,++iit) {
+    if (*fit != *iit) {
+      ++diff;
+    }
+  }
+
+  std::cout << "  Floating point: " << tf/1000.0 << " ms\n"
+            << "  Fixed point" << (staged.useFixedPoint() ? "" :
+                                   " (not applicable, floating point)")
+            << ": " << ti/1000.0 << " ms\n"
+            << "  Pixels differing: " << diff << std::endl;
+}
+
+bool canny::apply() {
+  if (sweep_) {
+    return sweep();
+  }
+
+  if (tiled_) {
+    return tiled();
+  }
+
+  if (batch_) {
+    return batch();
+  }
+
+  lti::stagedCannyEdges::parameters thPar;
+  loadParameters(thPar);
 
   help();
 
   lti::cannyEdges canny(thPar);
+  lti::stagedCannyEdges staged(thPar);
 
   lti::ioImage loader;
   lti::image img;
@@ -152,9 +361,31 @@ bool canny::apply() {
   chnl.castFrom(img);
   chnl8.castFrom(img);
 
+  // The staged detector keeps the intermediate results of the channel, so
+  // that each parameter change recomputes only the stages depending on it
+  switch(task_) {
+  case Byte:
+    staged.use(chnl8);
+    break;
+  case Float:
+    staged.use(chnl);
+    break;
+  default:
+    break;
+  }
+
+  static const char* stageNames[] = {
+    "smoothing",
+    "gradient",
+    "suppression",
+    "hysteresis",
+    "cache"
+  };
+
   static lti::viewer2D oview("input image");
   oview.show(chnl8);
 
+  lti::timer chrono;
   lti::viewer2D::interaction action;
   lti::viewer2D view("canny");
 
@@ -194,21 +425,36 @@ bool canny::apply() {
 
   int ktypeIdx = 0;
 
+  lti::bitMask edges;
+  double edgeDensity = 0.0;
+
   do {
-    canny.setParameters(thPar);
+    chrono.start();
 
     switch(task_) {
     case Byte:
-      canny.apply(chnl8,mask);
-      break;
     case Float:
-      canny.apply(chnl,mask);
+      staged.setParameters(thPar);
+      staged.apply(mask);
+      // the edges are cached, so that packing them is all this costs
+      if (staged.apply(edges)) {
+        edgeDensity = edges.fraction();
+      }
       break;
     default:
+      canny.setParameters(thPar);
       canny.apply(img,mask);
       break;
     }      
 
+    chrono.stop();
+    if (task_ != None) {
+      std::cout << "  Recomputed from "
+                << stageNames[staged.getFirstRecomputedStage()] << " in "
+                << chrono.getTime()/1000.0 << " ms, edge density "
+                << 100.0*edgeDensity << "%" << std::endl;
+    }
+
     view.show(mask);
     view.waitInteraction(action,pos);
 
@@ -232,6 +478,44 @@ bool canny::apply() {
 		  << std::endl;
 	state = MnThresh;
         break;
+      case 'r':
+        if (task_ == None) {
+          std::cout << "Use -f or -8 for the staged detector" << std::endl;
+          break;
+        }
+        if (thPar.smoothingType == lti::stagedCannyEdges::Convolution) {
+          thPar.smoothingType = lti::stagedCannyEdges::Recursive;
+          std::cout << "Recursive Gaussian smoothing" << std::endl;
+        } else {
+          thPar.smoothingType = lti::stagedCannyEdges::Convolution;
+          std::cout << "Gaussian kernel convolution" << std::endl;
+        }
+        compareSmoothing(chnl,thPar);
+        break;
+      case 'p':
+        if (task_ == None) {
+          std::cout << "Use -f or -8 for the staged detector" << std::endl;
+          break;
+        }
+        if (thPar.hysteresisThreads == 1) {
+          thPar.hysteresisThreads = 0;
+          std::cout << "Parallel hysteresis" << std::endl;
+        } else {
+          thPar.hysteresisThreads = 1;
+          std::cout << "Serial hysteresis" << std::endl;
+        }
+        compareHysteresis(staged,thPar);
+        break;
+      case 'i':
+        if (task_ != Byte) {
+          std::cout << "Use -8 for the fixed point stages" << std::endl;
+          break;
+        }
+        thPar.fixedPoint = !thPar.fixedPoint;
+        std::cout << (thPar.fixedPoint ? "Fixed point" : "Floating point")
+                  << " stages" << std::endl;
+        compareFixedPoint(chnl8,thPar);
+        break;
       case 'g':
 	std::cout << "Setting gradient kernel type" << std::endl;
 	state = GType;
@@ -325,6 +609,459 @@ bool canny::apply() {
   return false;
 }
 
+/*
+ * Batch mode
+ */
+
+/**
+ * Work done by each thread of the batch mode: each item is one image file.
+ *
+ * Every worker has its own lti::cannyEdges, loader and buffers, so that the
+ * threads never share anything but the (read-only) list of files.
+ */
+class canny::batchJob : public lti::workerPool::job {
+public:
+  batchJob(const std::vector<std::string>& files,
+           const lti::cannyEdges::parameters& par,
+           const eTasks task,
+           const std::string& outputDir,
+           const int workers)
+    : files_(files),task_(task),outputDir_(outputDir),
+      edgeValue_(par.edgeValue),data_(workers,static_cast<workerData*>(0)) {
+    for (int i=0;i<workers;++i) {
+      data_[i]=new workerData(par);
+    }
+  }
+
+  ~batchJob() {
+    for (unsigned int i=0;i<data_.size();++i) {
+      delete data_[i];
+      data_[i]=0;
+    }
+  }
+
+  virtual void process(const int from,const int to,const int worker) {
+    workerData& d = *data_[worker];
+
+    for (int i=from;i<to;++i) {
+      const std::string& file = files_[i];
+      if (!d.loader.load(file,d.img)) {
+        report("Image '" + file + "' could not be read: " +
+               d.loader.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      switch(task_) {
+      case Byte:
+        d.chnl8.castFrom(d.img);
+        d.canny.apply(d.chnl8,d.mask);
+        break;
+      case Float:
+        d.chnl.castFrom(d.img);
+        d.canny.apply(d.chnl,d.mask);
+        break;
+      default:
+        d.canny.apply(d.img,d.mask);
+        break;
+      }
+
+      const std::string out = lti::maskName(file,outputDir_,"-canny","png");
+      if (!d.saver.save(out,d.mask)) {
+        report("Mask '" + out + "' could not be written: " +
+               d.saver.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      d.processed++;
+      d.pixels += static_cast<double>(d.img.rows())*d.img.columns();
+      d.edges.castFrom(d.mask,edgeValue_);
+      d.edgePixels += d.edges.count();
+    }
+  }
+
+  /**
+   * Number of images processed successfully
+   */
+  int processed() const {
+    int n=0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->processed;
+    }
+    return n;
+  }
+
+  /**
+   * Number of images that could not be read or written
+   */
+  int failed() const {
+    int n=0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->failed;
+    }
+    return n;
+  }
+
+  /**
+   * Total number of pixels processed
+   */
+  double pixels() const {
+    double n=0.0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->pixels;
+    }
+    return n;
+  }
+
+  /**
+   * Total number of edge pixels found
+   */
+  double edgePixels() const {
+    double n=0.0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->edgePixels;
+    }
+    return n;
+  }
+
+private:
+  /**
+   * Everything a worker needs for itself
+   */
+  struct workerData {
+    workerData(const lti::cannyEdges::parameters& par)
+      : canny(par),processed(0),failed(0),pixels(0.0),edgePixels(0.0) {
+    }
+
+    lti::cannyEdges canny;
+    lti::ioImage loader;
+    lti::ioImage saver;
+    lti::image img;
+    lti::channel chnl;
+    lti::channel8 chnl8;
+    lti::channel8 mask;
+    lti::bitMask edges;
+    int processed;
+    int failed;
+    double pixels;
+    double edgePixels;
+  };
+
+  /**
+   * Print an error message without mixing the output of several threads
+   */
+  void report(const std::string& msg) {
+    lock_.lock();
+    std::cerr << msg << std::endl;
+    lock_.unlock();
+  }
+
+  const std::vector<std::string>& files_;
+  const eTasks task_;
+  const std::string outputDir_;
+  const lti::ubyte edgeValue_;
+  std::vector<workerData*> data_;
+  lti::mutex lock_;
+};
+
+bool canny::batch() {
+  lti::cannyEdges::parameters thPar;
+  loadParameters(thPar);
+
+  std::vector<std::string> files;
+  if (!lti::collectImageFiles(inputs_,listFile_,files)) {
+    cerr << "List file '" << listFile_ << "' could not be read." << endl;
+  }
+
+  if (files.empty()) {
+    cerr << "No images to process." << endl;
+    usage();
+    return false;
+  }
+
+  std::vector<std::string> conflicts;
+  if (!lti::uniqueMaskNames(files,outputDir_,"-canny","png",conflicts)) {
+    for (unsigned int i=0;i<conflicts.size();++i) {
+      cerr << conflicts[i] << endl;
+    }
+    return false;
+  }
+
+  lti::workerPool pool(threads_);
+  batchJob job(files,thPar,task_,outputDir_,pool.size());
+
+  cout << "Processing " << files.size() << " images with "
+       << pool.size() << " threads..." << endl;
+
+  lti::timer chrono;
+  chrono.start();
+  pool.apply(job,static_cast<int>(files.size()));
+  chrono.stop();
+
+  const double secs = chrono.getTime()/1000000.0;
+  cout << "Processed " << job.processed() << " images ("
+       << job.failed() << " failed) in " << secs << " s: "
+       << job.processed()/secs << " images/s, "
+       << job.pixels()/(secs*1000000.0) << " Mpixel/s" << endl;
+  if (job.pixels() > 0.0) {
+    cout << "Edge density " << 100.0*job.edgePixels()/job.pixels() << "%"
+         << endl;
+  }
+
+  return (job.failed() == 0);
+}
+
+/*
+ * Sweep mode
+ */
+
+/**
+ * Work done by each thread of the sweep: each item is one pair of
+ * thresholds evaluated on the stages already cached in the detector.
+ */
+class canny::sweepJob : public lti::workerPool::job {
+public:
+  sweepJob(const lti::stagedCannyEdges& detector,
+           const lti::fvector& thresholdsMin,
+           const lti::fvector& thresholdsMax,
+           const int workers)
+    : edges(thresholdsMin.size()*thresholdsMax.size(),0),
+      detector_(detector),thresholdsMin_(thresholdsMin),
+      thresholdsMax_(thresholdsMax),masks_(workers),bits_(workers) {
+  }
+
+  virtual void process(const int from,const int to,const int worker) {
+    lti::channel8& mask = masks_[worker];
+    lti::bitMask& bits = bits_[worker];
+    const lti::ubyte edgeValue = detector_.getParameters().edgeValue;
+    const float maxMag = detector_.getMaxMagnitude();
+
+    for (int i=from;i<to;++i) {
+      const float high = thresholdsMax_.at(i%thresholdsMax_.size())*maxMag;
+      const float low = thresholdsMin_.at(i/thresholdsMax_.size())*high;
+      detector_.hysteresis(low,high,mask);
+
+      // the edge pixels are a population count of the packed mask
+      bits.castFrom(mask,edgeValue);
+      edges.at(i)=bits.count();
+    }
+  }
+
+  /**
+   * Number of edge pixels for each pair of thresholds.  The index is
+   * minIdx*thresholdsMax.size()+maxIdx.
+   */
+  lti::ivector edges;
+
+private:
+  const lti::stagedCannyEdges& detector_;
+  const lti::fvector& thresholdsMin_;
+  const lti::fvector& thresholdsMax_;
+  std::vector<lti::channel8> masks_;
+  std::vector<lti::bitMask> bits_;
+};
+
+bool canny::sweep() {
+  lti::stagedCannyEdges::parameters thPar;
+  loadParameters(thPar);
+
+  // the grid of values to be evaluated
+  static const char* filesweep = "canny-sweep.lsp";
+  lti::fvector variances,thresholdsMin,thresholdsMax;
+  lti::ivector kernelSizes;
+
+  std::ifstream in(filesweep);
+  bool ok = false;
+  if (in) {
+    lti::lispStreamHandler lsh(in);
+    ok = (lti::read(lsh,"variance",variances) &&
+          lti::read(lsh,"kernelSize",kernelSizes) &&
+          lti::read(lsh,"thresholdMin",thresholdsMin) &&
+          lti::read(lsh,"thresholdMax",thresholdsMax));
+    in.close();
+  }
+
+  if (!ok) {
+    static const float defVariances[] = {0.5f,1.0f,1.5f,2.0f};
+    static const int defKernelSizes[] = {5,7,9};
+    static const float defThresholdsMin[] = {0.3f,0.5f,0.7f};
+    static const float defThresholdsMax[] = {0.02f,0.04f,0.08f,0.16f};
+
+    variances.allocate(4);
+    variances.fill(defVariances);
+    kernelSizes.allocate(3);
+    kernelSizes.fill(defKernelSizes);
+    thresholdsMin.allocate(3);
+    thresholdsMin.fill(defThresholdsMin);
+    thresholdsMax.allocate(4);
+    thresholdsMax.fill(defThresholdsMax);
+
+    std::ofstream out(filesweep);
+    lti::lispStreamHandler lsh(out);
+    lti::write(lsh,"variance",variances);
+    lti::write(lsh,"kernelSize",kernelSizes);
+    lti::write(lsh,"thresholdMin",thresholdsMin);
+    lti::write(lsh,"thresholdMax",thresholdsMax);
+    out << std::endl;
+    out.close();
+  }
+
+  if (variances.empty() || kernelSizes.empty() ||
+      thresholdsMin.empty() || thresholdsMax.empty()) {
+    cerr << "Empty parameter grid in " << filesweep << endl;
+    return false;
+  }
+
+  std::vector<std::string> files;
+  if (!lti::collectImageFiles(inputs_,listFile_,files)) {
+    cerr << "List file '" << listFile_ << "' could not be read." << endl;
+  }
+
+  if (files.empty()) {
+    cerr << "No images to process." << endl;
+    usage();
+    return false;
+  }
+
+  if (task_ == None) {
+    cerr << "Sweep uses the gray-channel of floats (use -8 for bytes)"
+         << endl;
+  }
+
+  // the threshold pairs already run in parallel, each one serially
+  thPar.hysteresisThreads = 1;
+
+  lti::workerPool pool(threads_);
+  lti::stagedCannyEdges detector(thPar);
+  sweepJob job(detector,thresholdsMin,thresholdsMax,pool.size());
+  const int variants = job.edges.size();
+
+  lti::ioImage loader;
+  lti::image img;
+  lti::channel chnl;
+  lti::channel8 chnl8;
+  lti::timer chrono;
+  chrono.start();
+
+  int combinations=0;
+
+  cout << "image\tvariance\tkernelSize\tthresholdMin\tthresholdMax"
+       << "\tedges\tdensity" << endl;
+
+  for (unsigned int f=0;f<files.size();++f) {
+    if (!loader.load(files[f],img)) {
+      cerr << "Image '" << files[f] << "' could not be read: "
+           << loader.getStatusString() << endl;
+      continue;
+    }
+
+    if (task_ == Byte) {
+      chnl8.castFrom(img);
+      detector.use(chnl8);
+    } else {
+      chnl.castFrom(img);
+      detector.use(chnl);
+    }
+
+    const double pixels = static_cast<double>(img.rows())*img.columns();
+
+    for (int v=0;v<variances.size();++v) {
+      for (int k=0;k<kernelSizes.size();++k) {
+        // smoothing, gradient and suppression once per scale...
+        thPar.variance = variances.at(v);
+        thPar.kernelSize = kernelSizes.at(k);
+        detector.setParameters(thPar);
+        if (!detector.update()) {
+          cerr << detector.getStatusString() << endl;
+          return false;
+        }
+
+        // ... and all the hysteresis variants in parallel
+        pool.apply(job,variants);
+        combinations+=variants;
+
+        for (int i=0;i<variants;++i) {
+          cout << files[f] << "\t"
+               << variances.at(v) << "\t"
+               << kernelSizes.at(k) << "\t"
+               << thresholdsMin.at(i/thresholdsMax.size()) << "\t"
+               << thresholdsMax.at(i%thresholdsMax.size()) << "\t"
+               << job.edges.at(i) << "\t"
+               << job.edges.at(i)/pixels << endl;
+        }
+      }
+    }
+  }
+
+  chrono.stop();
+  cerr << "Evaluated " << combinations << " combinations in "
+       << chrono.getTime()/1000000.0 << " s with " << pool.size()
+       << " threads" << endl;
+
+  return true;
+}
+
+/*
+ * Tiled mode
+ */
+bool canny::tiled() {
+  lti::stagedCannyEdges::parameters thPar;
+  loadParameters(thPar);
+
+  lti::tiledCannyEdges::parameters tiPar;
+  tiPar.lti::stagedCannyEdges::parameters::copy(thPar);
+  tiPar.bandHeight = bandHeight_;
+  tiPar.threads = threads_;
+  lti::tiledCannyEdges detector(tiPar);
+
+  if (inputs_.empty()) {
+    cerr << "No images to process." << endl;
+    usage();
+    return false;
+  }
+
+  const std::string ext =
+    lti::rowWriter::supported("mask.png") ? "png" : "pgm";
+
+  std::vector<std::string> conflicts;
+  if (!lti::uniqueMaskNames(inputs_,outputDir_,"-canny",ext,conflicts)) {
+    for (unsigned int i=0;i<conflicts.size();++i) {
+      cerr << conflicts[i] << endl;
+    }
+    return false;
+  }
+
+  bool ok = true;
+  lti::timer chrono;
+  for (unsigned int i=0;i<inputs_.size();++i) {
+    const std::string out =
+      lti::maskName(inputs_[i],outputDir_,"-canny",ext);
+
+    chrono.start();
+    if (!detector.apply(inputs_[i],out)) {
+      cerr << "Image '" << inputs_[i] << "' could not be processed: "
+           << detector.getStatusString() << endl;
+      ok = false;
+      continue;
+    }
+    chrono.stop();
+
+    const double secs = chrono.getTime()/1000000.0;
+    const double pixels =
+      static_cast<double>(detector.getRows())*detector.getColumns();
+    cout << inputs_[i] << ": " << detector.getColumns() << "x"
+         << detector.getRows() << " in " << detector.getBands()
+         << " bands (halo " << detector.getHalo() << " rows, "
+         << detector.getBorderComponents() << " border components), "
+         << secs << " s, " << pixels/(secs*1000000.0) << " Mpixel/s, "
+         << detector.getBufferSize()/(1024.0*1024.0) << " MB buffers -> "
+         << out << endl;
+  }
+
+  return ok;
+}
+
 /*
  * Main method
  */
@@ -46,6 +46,8 @@
 
 
 #include <string>
+#include <vector>
+#include <ltiCannyEdges.h>
 
 /**
  * This class is creates and shows adaptive shape models
@@ -92,6 +94,43 @@ private:
    */
   void help() const;
 
+  /**
+   * Read the parameters from canny.lsp, or create that file with the
+   * default values if it cannot be read.
+   */
+  void loadParameters(lti::cannyEdges::parameters& thPar) const;
+
+  /**
+   * Headless processing of all images given in the command line, in
+   * the list file and in the given directories.
+   * \return true if all images could be processed, false otherwise
+   */
+  bool batch();
+
+  /**
+   * Job executed by the worker threads in batch mode
+   */
+  class batchJob;
+
+  /**
+   * Evaluate all combinations of the parameter grid in canny-sweep.lsp
+   * on all given images and print a table with the edge counts.
+   * \return true if successful, false otherwise
+   */
+  bool sweep();
+
+  /**
+   * Job evaluating the hysteresis variants of the sweep in parallel
+   */
+  class sweepJob;
+
+  /**
+   * Compute the edges of huge images in bands of rows, without loading
+   * them completely into memory.
+   * \return true if all images could be processed, false otherwise
+   */
+  bool tiled();
+
   /**
    * Attributes
    */
@@ -105,6 +144,47 @@ private:
    * Image file name
    */
   std::string imgFile_;
+
+  /**
+   * Batch mode: no viewer, process all given images and save the masks
+   */
+  bool batch_;
+
+  /**
+   * Sweep mode: evaluate a grid of parameters and report the edge counts
+   */
+  bool sweep_;
+
+  /**
+   * Tiled mode: stream huge images in bands of rows
+   */
+  bool tiled_;
+
+  /**
+   * Number of worker threads in batch, sweep and tiled mode (0: one per
+   * processor)
+   */
+  int threads_;
+
+  /**
+   * Rows per band in tiled mode
+   */
+  int bandHeight_;
+
+  /**
+   * Directory where the masks are saved in batch mode
+   */
+  std::string outputDir_;
+
+  /**
+   * File containing a list of images (one per line) for batch mode
+   */
+  std::string listFile_;
+
+  /**
+   * All images and directories given in the command line
+   */
+  std::vector<std::string> inputs_;
   //@}
 
 };
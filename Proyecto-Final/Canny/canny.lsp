@@ -1,4 +1,7 @@
-((variance 1)
+((smoothingType "Convolution")
+ (hysteresisThreads 1)
+ (fixedPoint true)
+ (variance 1)
  (kernelSize 7)
  (thresholdMin 0.5)
  (thresholdMax 0.0399999991)
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiRecursiveGaussian.cpp
+ *         Gaussian smoothing with a recursive (IIR) filter.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiRecursiveGaussian.h"
+#include "ltiMath.h"
+#include "ltiVector.h"
+
+namespace lti {
+  // --------------------------------------------------
+  // recursiveGaussian::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  recursiveGaussian::parameters::parameters()
+    : functor::parameters() {
+    variance = 1.0f;
+  }
+
+  // copy constructor
+  recursiveGaussian::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  recursiveGaussian::parameters::~parameters() {
+  }
+
+  // copy member
+  recursiveGaussian::parameters&
+  recursiveGaussian::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    variance = other.variance;
+
+    return *this;
+  }
+
+  // alias for copy method
+  recursiveGaussian::parameters&
+  recursiveGaussian::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& recursiveGaussian::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  recursiveGaussian::parameters*
+  recursiveGaussian::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  recursiveGaussian::parameters*
+  recursiveGaussian::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  bool recursiveGaussian::parameters::write(ioHandler& handler,
+                                            const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"variance",variance) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  bool recursiveGaussian::parameters::read(ioHandler& handler,
+                                           const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"variance",variance) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // recursiveGaussian
+  // --------------------------------------------------
+
+  // default constructor
+  recursiveGaussian::recursiveGaussian()
+    : functor() {
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  // constructor with parameters
+  recursiveGaussian::recursiveGaussian(const parameters& par)
+    : functor() {
+    // set the given parameters
+    setParameters(par);
+  }
+
+  // constructor with variance
+  recursiveGaussian::recursiveGaussian(const float variance)
+    : functor() {
+    parameters par;
+    par.variance = variance;
+    setParameters(par);
+  }
+
+  // copy constructor
+  recursiveGaussian::recursiveGaussian(const recursiveGaussian& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  recursiveGaussian::~recursiveGaussian() {
+  }
+
+  // copy member
+  recursiveGaussian&
+  recursiveGaussian::copy(const recursiveGaussian& other) {
+    functor::copy(other);
+
+    return *this;
+  }
+
+  // alias for copy member
+  recursiveGaussian&
+  recursiveGaussian::operator=(const recursiveGaussian& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& recursiveGaussian::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  recursiveGaussian* recursiveGaussian::clone() const {
+    return new recursiveGaussian(*this);
+  }
+
+  // create a new instance
+  recursiveGaussian* recursiveGaussian::newInstance() const {
+    return new recursiveGaussian();
+  }
+
+  // return parameters
+  const recursiveGaussian::parameters&
+  recursiveGaussian::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  bool recursiveGaussian::updateParameters() {
+    const parameters& par = getParameters();
+
+    // Young and van Vliet, eq. (11b), valid for sigma >= 0.5
+    const double sigma = sqrt(max(0.25,static_cast<double>(par.variance)));
+    const double q = (sigma >= 2.5) ?
+      0.98711*sigma - 0.96330 :
+      3.97156 - 4.14554*sqrt(1.0 - 0.26891*sigma);
+
+    const double q2 = q*q;
+    const double q3 = q2*q;
+
+    // eq. (8c)
+    const double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+    const double b1 = 2.44413*q + 2.85619*q2 + 1.26661*q3;
+    const double b2 = -(1.4281*q2 + 1.26661*q3);
+    const double b3 = 0.422205*q3;
+
+    b1_ = static_cast<float>(b1/b0);
+    b2_ = static_cast<float>(b2/b0);
+    b3_ = static_cast<float>(b3/b0);
+
+    // eq. (10): unit gain for constant signals
+    gain_ = static_cast<float>(1.0 - (b1 + b2 + b3)/b0);
+
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool recursiveGaussian::apply(channel& srcdest) const {
+    if (srcdest.empty()) {
+      return true;
+    }
+
+    filterRows(srcdest);
+    filterColumns(srcdest);
+
+    return true;
+  }
+
+  bool recursiveGaussian::apply(const channel& src,channel& dest) const {
+    dest.copy(src);
+    return apply(dest);
+  }
+
+  void recursiveGaussian::filterRows(channel& chnl) const {
+    const int cols = chnl.columns();
+
+    for (int y=0;y<chnl.rows();++y) {
+      float* d = &chnl.at(y,0);
+
+      // forwards, initialized with the steady state of the first value
+      float p1,p2,p3;
+      p1=p2=p3=d[0];
+      for (int x=0;x<cols;++x) {
+        const float w = gain_*d[x] + b1_*p1 + b2_*p2 + b3_*p3;
+        d[x] = w;
+        p3=p2;
+        p2=p1;
+        p1=w;
+      }
+
+      // backwards, initialized with the steady state of the last value
+      p1=p2=p3=d[cols-1];
+      for (int x=cols-1;x>=0;--x) {
+        const float w = gain_*d[x] + b1_*p1 + b2_*p2 + b3_*p3;
+        d[x] = w;
+        p3=p2;
+        p2=p1;
+        p1=w;
+      }
+    }
+  }
+
+  void recursiveGaussian::filterColumns(channel& chnl) const {
+    const int rows = chnl.rows();
+    const int cols = chnl.columns();
+
+    // copy of the border row, used as steady state before the first row
+    fvector border;
+    border.copy(chnl.getRow(0));
+
+    // forwards
+    for (int y=0;y<rows;++y) {
+      const float* p1 = (y>0) ? &chnl.at(y-1,0) : border.data();
+      const float* p2 = (y>1) ? &chnl.at(y-2,0) : border.data();
+      const float* p3 = (y>2) ? &chnl.at(y-3,0) : border.data();
+      float* d = &chnl.at(y,0);
+
+      for (int x=0;x<cols;++x) {
+        d[x] = gain_*d[x] + b1_*p1[x] + b2_*p2[x] + b3_*p3[x];
+      }
+    }
+
+    // backwards
+    border.copy(chnl.getRow(rows-1));
+    for (int y=rows-1;y>=0;--y) {
+      const float* p1 = (y<rows-1) ? &chnl.at(y+1,0) : border.data();
+      const float* p2 = (y<rows-2) ? &chnl.at(y+2,0) : border.data();
+      const float* p3 = (y<rows-3) ? &chnl.at(y+3,0) : border.data();
+      float* d = &chnl.at(y,0);
+
+      for (int x=0;x<cols;++x) {
+        d[x] = gain_*d[x] + b1_*p1[x] + b2_*p2[x] + b3_*p3[x];
+      }
+    }
+  }
+
+}
@@ -0,0 +1,1299 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiStagedCannyEdges.cpp
+ *         Canny edge detector that keeps the intermediate results of each
+ *         stage.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiStagedCannyEdges.h"
+#include "ltiMath.h"
+#include "ltiGaussKernels.h"
+#include "ltiConvolution.h"
+#include "ltiGradientFunctor.h"
+#include "ltiRecursiveGaussian.h"
+#include "ltiWorkerPool.h"
+
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+namespace lti {
+  // --------------------------------------------------
+  // stagedCannyEdges::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  stagedCannyEdges::parameters::parameters()
+    : cannyEdges::parameters() {
+    smoothingType = Convolution;
+    hysteresisThreads = 1;
+    fixedPoint = true;
+  }
+
+  // copy constructor
+  stagedCannyEdges::parameters::parameters(const parameters& other)
+    : cannyEdges::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  stagedCannyEdges::parameters::~parameters() {
+  }
+
+  // copy member
+  stagedCannyEdges::parameters&
+  stagedCannyEdges::parameters::copy(const parameters& other) {
+    cannyEdges::parameters::copy(other);
+
+    smoothingType = other.smoothingType;
+    hysteresisThreads = other.hysteresisThreads;
+    fixedPoint = other.fixedPoint;
+
+    return *this;
+  }
+
+  // alias for copy method
+  stagedCannyEdges::parameters&
+  stagedCannyEdges::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& stagedCannyEdges::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  stagedCannyEdges::parameters*
+  stagedCannyEdges::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  stagedCannyEdges::parameters*
+  stagedCannyEdges::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  bool stagedCannyEdges::parameters::write(ioHandler& handler,
+                                           const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"smoothingType",smoothingType) && b;
+      b = lti::write(handler,"hysteresisThreads",hysteresisThreads) && b;
+      b = lti::write(handler,"fixedPoint",fixedPoint) && b;
+    }
+
+    b = b && cannyEdges::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  bool stagedCannyEdges::parameters::read(ioHandler& handler,
+                                          const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"smoothingType",smoothingType) && b;
+      b = lti::read(handler,"hysteresisThreads",hysteresisThreads) && b;
+      b = lti::read(handler,"fixedPoint",fixedPoint) && b;
+    }
+
+    b = b && cannyEdges::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // stagedCannyEdges
+  // --------------------------------------------------
+
+  // default constructor
+  stagedCannyEdges::stagedCannyEdges()
+    : functor(),valid_(Smoothing),recomputed_(Smoothing),maxMagnitude_(0.0f),
+      fixed_(false) {
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  // constructor with parameters
+  stagedCannyEdges::stagedCannyEdges(const parameters& par)
+    : functor(),valid_(Smoothing),recomputed_(Smoothing),maxMagnitude_(0.0f),
+      fixed_(false) {
+    // set the given parameters
+    setParameters(par);
+  }
+
+  // copy constructor
+  stagedCannyEdges::stagedCannyEdges(const stagedCannyEdges& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  stagedCannyEdges::~stagedCannyEdges() {
+  }
+
+  // copy member
+  stagedCannyEdges& stagedCannyEdges::copy(const stagedCannyEdges& other) {
+    functor::copy(other);
+
+    valid_        = other.valid_;
+    cached_.copy(other.cached_);
+    recomputed_   = other.recomputed_;
+    src_.copy(other.src_);
+    src8_.copy(other.src8_);
+    smoothed_.copy(other.smoothed_);
+    magnitude_.copy(other.magnitude_);
+    orientation_.copy(other.orientation_);
+    suppressed_.copy(other.suppressed_);
+    maxMagnitude_ = other.maxMagnitude_;
+    edges_.copy(other.edges_);
+    fixed_        = other.fixed_;
+    smoothed16_   = other.smoothed16_;
+    gx16_         = other.gx16_;
+    gy16_         = other.gy16_;
+
+    return *this;
+  }
+
+  // alias for copy member
+  stagedCannyEdges&
+  stagedCannyEdges::operator=(const stagedCannyEdges& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& stagedCannyEdges::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  stagedCannyEdges* stagedCannyEdges::clone() const {
+    return new stagedCannyEdges(*this);
+  }
+
+  // create a new instance
+  stagedCannyEdges* stagedCannyEdges::newInstance() const {
+    return new stagedCannyEdges();
+  }
+
+  // return parameters
+  const stagedCannyEdges::parameters&
+  stagedCannyEdges::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  // -------------------------------------------------------------------
+  // Cache management
+  // -------------------------------------------------------------------
+
+  void stagedCannyEdges::invalidate() {
+    valid_ = Smoothing;
+  }
+
+  stagedCannyEdges::eStage stagedCannyEdges::getFirstRecomputedStage() const {
+    return recomputed_;
+  }
+
+  /*
+   * Fractional bits of the fixed point smoothed image, as many as possible
+   * so that the gradient components of the given kernel fit in int16
+   */
+  static int fractionalBits(const gradientFunctor::eKernelType kernel) {
+    // Sobel and Prewitt add up to 4 and 3 differences, Difference just one
+    return (kernel == gradientFunctor::Difference) ? 7 : 5;
+  }
+
+  int stagedCannyEdges::firstInvalidStage() const {
+    const parameters& par = getParameters();
+
+    if ((valid_ <= Smoothing) ||
+        (useFixedPoint() != fixed_) ||
+        (fixed_ &&
+         (fractionalBits(par.gradientParameters.kernelType) !=
+          fractionalBits(cached_.gradientParameters.kernelType))) ||
+        (par.smoothingType != cached_.smoothingType) ||
+        (par.variance != cached_.variance) ||
+        ((par.kernelSize != cached_.kernelSize) &&
+         (par.smoothingType == Convolution))) {
+      return Smoothing;
+    }
+
+    const gradientFunctor::parameters& gp = par.gradientParameters;
+    const gradientFunctor::parameters& gc = cached_.gradientParameters;
+    if ((valid_ <= Gradient) ||
+        (gp.kernelType != gc.kernelType) ||
+        (gp.gradientKernelSize != gc.gradientKernelSize) ||
+        (gp.ogdVariance != gc.ogdVariance)) {
+      return Gradient;
+    }
+
+    if (valid_ <= Suppression) {
+      return Suppression;
+    }
+
+    if ((valid_ <= Hysteresis) ||
+        (par.thresholdMin != cached_.thresholdMin) ||
+        (par.thresholdMax != cached_.thresholdMax) ||
+        (par.edgeValue != cached_.edgeValue) ||
+        (par.noEdgeValue != cached_.noEdgeValue)) {
+      return Hysteresis;
+    }
+
+    return Cached;
+  }
+
+  const channel& stagedCannyEdges::getSmoothed() const {
+    return smoothed_;
+  }
+
+  const channel& stagedCannyEdges::getMagnitude() const {
+    return magnitude_;
+  }
+
+  const channel& stagedCannyEdges::getOrientation() const {
+    return orientation_;
+  }
+
+  const channel& stagedCannyEdges::getSuppressed() const {
+    return suppressed_;
+  }
+
+  float stagedCannyEdges::getMaxMagnitude() const {
+    return maxMagnitude_;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool stagedCannyEdges::use(const channel& src) {
+    if (src.empty()) {
+      setStatusString("Input channel empty");
+      return false;
+    }
+    src_.copy(src);
+    src8_.clear();
+    invalidate();
+    return true;
+  }
+
+  bool stagedCannyEdges::use(const channel8& src) {
+    if (src.empty()) {
+      setStatusString("Input channel empty");
+      return false;
+    }
+    // the float channel is only created if the float stages need it
+    src8_.copy(src);
+    src_.clear();
+    invalidate();
+    return true;
+  }
+
+  bool stagedCannyEdges::update() {
+    if (src_.empty() && src8_.empty()) {
+      setStatusString("No input channel given with use()");
+      return false;
+    }
+
+    const int first = firstInvalidStage();
+    recomputed_ = static_cast<eStage>(first);
+    valid_ = min(valid_,first);
+    fixed_ = useFixedPoint();
+
+    if (valid_ <= Smoothing) {
+      if (!(fixed_ ? fixedSmooth() : smooth())) {
+        return false;
+      }
+      valid_ = Gradient;
+    }
+
+    if (valid_ <= Gradient) {
+      if (!(fixed_ ? fixedGradient() : gradient())) {
+        return false;
+      }
+      valid_ = Suppression;
+    }
+
+    if (valid_ <= Suppression) {
+      if (!(fixed_ ? fixedSuppress() : suppress())) {
+        return false;
+      }
+      valid_ = Hysteresis;
+    }
+
+    // the thresholds of the cache are only meaningful if valid_ == Cached
+    cached_.copy(getParameters());
+
+    return true;
+  }
+
+  bool stagedCannyEdges::apply(channel8& edges) {
+    if (!updateEdges()) {
+      return false;
+    }
+
+    edges.copy(edges_);
+    return true;
+  }
+
+  bool stagedCannyEdges::apply(bitMask& edges) {
+    if (!updateEdges()) {
+      return false;
+    }
+
+    edges.castFrom(edges_,getParameters().edgeValue);
+    return true;
+  }
+
+  bool stagedCannyEdges::updateEdges() {
+    if (!update()) {
+      return false;
+    }
+
+    if (valid_ <= Hysteresis) {
+      const parameters& par = getParameters();
+      const float high = par.thresholdMax*maxMagnitude_;
+      const float low  = par.thresholdMin*high;
+      if (!hysteresis(low,high,edges_)) {
+        return false;
+      }
+      valid_ = Cached;
+    }
+
+    return true;
+  }
+
+  bool stagedCannyEdges::apply(const channel& src,channel8& edges) {
+    return use(src) && apply(edges);
+  }
+
+  bool stagedCannyEdges::apply(const channel8& src,channel8& edges) {
+    return use(src) && apply(edges);
+  }
+
+  // -------------------------------------------------------------------
+  // Stages
+  // -------------------------------------------------------------------
+
+  bool stagedCannyEdges::smooth() {
+    const parameters& par = getParameters();
+
+    if (src_.empty()) {
+      src_.castFrom(src8_);
+    }
+
+    if (par.variance <= 0.0f) {
+      smoothed_.copy(src_);
+      return true;
+    }
+
+    if (par.smoothingType == Recursive) {
+      recursiveGaussian gauss(par.variance);
+      return gauss.apply(src_,smoothed_);
+    }
+
+    if (par.kernelSize <= 1) {
+      smoothed_.copy(src_);
+      return true;
+    }
+
+    gaussKernel2D<float> kern(par.kernelSize,par.variance);
+    convolution::parameters convPar;
+    convPar.boundaryType = Constant;
+    convPar.setKernel(kern);
+    convolution conv(convPar);
+
+    if (!conv.apply(src_,smoothed_)) {
+      setStatusString(conv.getStatusString());
+      return false;
+    }
+
+    return true;
+  }
+
+  bool stagedCannyEdges::gradient() {
+    gradientFunctor::parameters gradPar(getParameters().gradientParameters);
+    gradPar.format = gradientFunctor::Polar;
+    gradientFunctor grad(gradPar);
+
+    if (!grad.apply(smoothed_,magnitude_,orientation_)) {
+      setStatusString(grad.getStatusString());
+      return false;
+    }
+
+    maxMagnitude_ = 0.0f;
+    channel::const_iterator it,eit;
+    for (it=magnitude_.begin(),eit=magnitude_.end();it!=eit;++it) {
+      if (*it > maxMagnitude_) {
+        maxMagnitude_ = *it;
+      }
+    }
+
+    return true;
+  }
+
+  bool stagedCannyEdges::suppress() {
+    const int rows = magnitude_.rows();
+    const int cols = magnitude_.columns();
+
+    suppressed_.assign(rows,cols,0.0f);
+
+    // Neighbor offsets for each one of the four quantized gradient
+    // directions (0, 45, 90 and 135 degrees)
+    static const int dx[] = { 1, 1, 0, -1 };
+    static const int dy[] = { 0, 1, 1,  1 };
+    const float toSector = static_cast<float>(4.0/Pi);
+
+    for (int y=1;y<rows-1;++y) {
+      const float* mag = &magnitude_.at(y,0);
+      const float* ori = &orientation_.at(y,0);
+      float* sup = &suppressed_.at(y,0);
+
+      for (int x=1;x<cols-1;++x) {
+        const float m = mag[x];
+        if (m <= 0.0f) {
+          continue;
+        }
+
+        float a = ori[x];
+        if (a < 0.0f) {
+          a += static_cast<float>(Pi);
+        }
+        const int s = static_cast<int>(a*toSector + 0.5f) & 3;
+
+        // ties are kept only on one side to avoid double edges
+        if ((m >= magnitude_.at(y+dy[s],x+dx[s])) &&
+            (m >  magnitude_.at(y-dy[s],x-dx[s]))) {
+          sup[x] = m;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool stagedCannyEdges::hysteresis(const float low,
+                                    const float high,
+                                    channel8& edges) const {
+    if (suppressed_.empty()) {
+      setStatusString("Suppression stage not computed yet");
+      return false;
+    }
+
+    const int threads = getParameters().hysteresisThreads;
+    if (threads == 1) {
+      return serialHysteresis(low,high,edges);
+    }
+    return parallelHysteresis(low,high,threads,edges);
+  }
+
+  bool stagedCannyEdges::serialHysteresis(const float low,
+                                          const float high,
+                                          channel8& edges) const {
+    const parameters& par = getParameters();
+    const ubyte edgeValue = par.edgeValue;
+    const int rows = suppressed_.rows();
+    const int cols = suppressed_.columns();
+
+    edges.assign(rows,cols,par.noEdgeValue);
+    if (edgeValue == par.noEdgeValue) {
+      return true; // nothing to distinguish
+    }
+
+    std::vector<int> stack;
+
+    for (int y=0;y<rows;++y) {
+      for (int x=0;x<cols;++x) {
+        const float s = suppressed_.at(y,x);
+        if ((s <= 0.0f) || (s < high) || (edges.at(y,x) == edgeValue)) {
+          continue;
+        }
+
+        // new seed: follow all connected pixels above the low threshold
+        edges.at(y,x) = edgeValue;
+        stack.push_back(y*cols+x);
+
+        while (!stack.empty()) {
+          const int idx = stack.back();
+          stack.pop_back();
+          const int cy = idx/cols;
+          const int cx = idx%cols;
+
+          const int fy = max(0,cy-1);
+          const int ty = min(rows-1,cy+1);
+          const int fx = max(0,cx-1);
+          const int tx = min(cols-1,cx+1);
+
+          for (int ny=fy;ny<=ty;++ny) {
+            for (int nx=fx;nx<=tx;++nx) {
+              const float ns = suppressed_.at(ny,nx);
+              if ((ns > 0.0f) && (ns >= low) &&
+                  (edges.at(ny,nx) != edgeValue)) {
+                edges.at(ny,nx) = edgeValue;
+                stack.push_back(ny*cols+nx);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // Fixed point stages
+  // -------------------------------------------------------------------
+
+  bool stagedCannyEdges::useFixedPoint() const {
+    const parameters& par = getParameters();
+
+    if (!par.fixedPoint || src8_.empty() ||
+        ((par.smoothingType != Convolution) && (par.variance > 0.0f))) {
+      return false;
+    }
+
+    switch(par.gradientParameters.kernelType) {
+    case gradientFunctor::Difference:
+    case gradientFunctor::Sobel:
+    case gradientFunctor::Prewitt:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /*
+   * Linear filter with 32 bit accumulation:
+   * dst[x] = (sum of kern[i]*src[i][x] + 2^(shift-1)) >> shift
+   *
+   * For the columns src[i] are consecutive rows, for the rows src[i] is
+   * the padded row shifted by i.
+   */
+  static void filter(const std::vector<const int16*>& src,
+                           const std::vector<int16>& kern,
+                           const int shift,
+                           const int cols,
+                           int16* dst) {
+    const int taps = static_cast<int>(kern.size());
+    const int round = 1 << (shift-1);
+    int x=0;
+
+    // the taps are taken in pairs, interleaving the values of two rows to
+    // multiply and add both in one instruction
+#if defined(__AVX2__)
+    for (;x+16<=cols;x+=16) {
+      __m256i lo = _mm256_set1_epi32(round);
+      __m256i hi = lo;
+      for (int i=0;i<taps;i+=2) {
+        const __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src[i]+x));
+        __m256i b = _mm256_setzero_si256();
+        int pair = kern[i] & 0xffff;
+        if (i+1 < taps) {
+          b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src[i+1]+x));
+          pair |= static_cast<int>(kern[i+1]) << 16;
+        }
+        const __m256i k = _mm256_set1_epi32(pair);
+        lo = _mm256_add_epi32(lo,_mm256_madd_epi16(_mm256_unpacklo_epi16(a,b),k));
+        hi = _mm256_add_epi32(hi,_mm256_madd_epi16(_mm256_unpackhi_epi16(a,b),k));
+      }
+      lo = _mm256_srai_epi32(lo,shift);
+      hi = _mm256_srai_epi32(hi,shift);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+x),
+                          _mm256_packs_epi32(lo,hi));
+    }
+#endif
+#if defined(__SSE2__)
+    for (;x+8<=cols;x+=8) {
+      __m128i lo = _mm_set1_epi32(round);
+      __m128i hi = lo;
+      for (int i=0;i<taps;i+=2) {
+        const __m128i a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[i]+x));
+        __m128i b = _mm_setzero_si128();
+        int pair = kern[i] & 0xffff;
+        if (i+1 < taps) {
+          b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[i+1]+x));
+          pair |= static_cast<int>(kern[i+1]) << 16;
+        }
+        const __m128i k = _mm_set1_epi32(pair);
+        lo = _mm_add_epi32(lo,_mm_madd_epi16(_mm_unpacklo_epi16(a,b),k));
+        hi = _mm_add_epi32(hi,_mm_madd_epi16(_mm_unpackhi_epi16(a,b),k));
+      }
+      lo = _mm_srai_epi32(lo,shift);
+      hi = _mm_srai_epi32(hi,shift);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+x),
+                       _mm_packs_epi32(lo,hi));
+    }
+#endif
+    for (;x<cols;++x) {
+      int acc = round;
+      for (int i=0;i<taps;++i) {
+        acc += kern[i]*src[i][x];
+      }
+      dst[x] = static_cast<int16>(acc >> shift);
+    }
+  }
+
+  bool stagedCannyEdges::fixedSmooth() {
+    const parameters& par = getParameters();
+    const int rows = src8_.rows();
+    const int cols = src8_.columns();
+
+    smoothed16_.resize(rows*cols);
+
+    // the gray values get as many fractional bits as the gradient kernel
+    // allows (4*255*32 for Sobel still fits in int16)
+    const int bits = fractionalBits(par.gradientParameters.kernelType);
+    if ((par.variance <= 0.0f) || (par.kernelSize <= 1)) {
+      for (int y=0;y<rows;++y) {
+        const ubyte* src = &src8_.at(y,0);
+        int16* dst = &smoothed16_[y*cols];
+        for (int x=0;x<cols;++x) {
+          dst[x] = static_cast<int16>(src[x] << bits);
+        }
+      }
+      return true;
+    }
+
+    // Gaussian with 12 fractional bits, adding up to exactly 4096
+    gaussKernel1D<float> gauss(par.kernelSize,par.variance);
+    const int first = gauss.firstIdx();
+    const int taps = gauss.lastIdx()-first+1;
+    std::vector<int16> kern(taps);
+    int sum = 0;
+    for (int i=0;i<taps;++i) {
+      kern[i] = static_cast<int16>(iround(gauss.at(first+i)*4096.0f));
+      sum += kern[i];
+    }
+    kern[-first] = static_cast<int16>(kern[-first] + 4096 - sum);
+
+    // rows filtered into gx16_, which the gradient stage overwrites anyway,
+    // keeping 7 fractional bits (at most 255*128 fits in int16)
+    std::vector<int16>& tmp = gx16_;
+    tmp.resize(rows*cols);
+    std::vector<int16> pad(cols+taps-1);
+    std::vector<const int16*> window(taps);
+    for (int i=0;i<taps;++i) {
+      window[i] = &pad[i];
+    }
+    for (int y=0;y<rows;++y) {
+      const ubyte* src = &src8_.at(y,0);
+      for (int i=0;i<cols+taps-1;++i) {
+        pad[i] = src[within(i+first,0,cols-1)];
+      }
+      filter(window,kern,5,cols,&tmp[y*cols]);
+    }
+
+    // columns, from 7+12 to the final fractional bits
+    for (int y=0;y<rows;++y) {
+      for (int i=0;i<taps;++i) {
+        window[i] = &tmp[within(y+first+i,0,rows-1)*cols];
+      }
+      filter(window,kern,19-bits,cols,&smoothed16_[y*cols]);
+    }
+
+    return true;
+  }
+
+  bool stagedCannyEdges::fixedGradient() {
+    const parameters& par = getParameters();
+    const int rows = src8_.rows();
+    const int cols = src8_.columns();
+
+    // weights of the side and center rows of the derivative masks
+    int16 ws,wc;
+    switch(par.gradientParameters.kernelType) {
+    case gradientFunctor::Sobel:
+      ws = 1;
+      wc = 2;
+      break;
+    case gradientFunctor::Prewitt:
+      ws = 1;
+      wc = 1;
+      break;
+    default: // Difference
+      ws = 0;
+      wc = 1;
+      break;
+    }
+
+    gx16_.resize(rows*cols);
+    gy16_.resize(rows*cols);
+
+    for (int y=0;y<rows;++y) {
+      const int16* a = &smoothed16_[max(0,y-1)*cols];
+      const int16* b = &smoothed16_[y*cols];
+      const int16* c = &smoothed16_[min(rows-1,y+1)*cols];
+      int16* gx = &gx16_[y*cols];
+      int16* gy = &gy16_[y*cols];
+
+      // the first and last columns repeat the border pixels
+      const int border[] = { 0, cols-1 };
+      for (int j=0;j<2;++j) {
+        const int x = border[j];
+        const int xm = max(0,x-1);
+        const int xp = min(cols-1,x+1);
+        gx[x] = static_cast<int16>(ws*(a[xp]-a[xm]) + wc*(b[xp]-b[xm]) +
+                                   ws*(c[xp]-c[xm]));
+        gy[x] = static_cast<int16>(ws*(c[xm]-a[xm]) + wc*(c[x]-a[x]) +
+                                   ws*(c[xp]-a[xp]));
+      }
+
+      int x=1;
+#if defined(__AVX2__)
+      {
+        const __m256i vs = _mm256_set1_epi16(ws);
+        const __m256i vc = _mm256_set1_epi16(wc);
+        for (;x+16<=cols-1;x+=16) {
+#         define _LTI_LD(p) \
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+          const __m256i am = _LTI_LD(a+x-1), a0 = _LTI_LD(a+x);
+          const __m256i ap = _LTI_LD(a+x+1);
+          const __m256i bm = _LTI_LD(b+x-1), bp = _LTI_LD(b+x+1);
+          const __m256i cm = _LTI_LD(c+x-1), c0 = _LTI_LD(c+x);
+          const __m256i cp = _LTI_LD(c+x+1);
+#         undef _LTI_LD
+          const __m256i sx =
+            _mm256_add_epi16(_mm256_sub_epi16(ap,am),_mm256_sub_epi16(cp,cm));
+          const __m256i vx =
+            _mm256_add_epi16(_mm256_mullo_epi16(vs,sx),
+                             _mm256_mullo_epi16(vc,_mm256_sub_epi16(bp,bm)));
+          const __m256i sy =
+            _mm256_add_epi16(_mm256_sub_epi16(cm,am),_mm256_sub_epi16(cp,ap));
+          const __m256i vy =
+            _mm256_add_epi16(_mm256_mullo_epi16(vs,sy),
+                             _mm256_mullo_epi16(vc,_mm256_sub_epi16(c0,a0)));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(gx+x),vx);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(gy+x),vy);
+        }
+      }
+#endif
+#if defined(__SSE2__)
+      {
+        const __m128i vs = _mm_set1_epi16(ws);
+        const __m128i vc = _mm_set1_epi16(wc);
+        for (;x+8<=cols-1;x+=8) {
+#         define _LTI_LD(p) _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+          const __m128i am = _LTI_LD(a+x-1), a0 = _LTI_LD(a+x);
+          const __m128i ap = _LTI_LD(a+x+1);
+          const __m128i bm = _LTI_LD(b+x-1), bp = _LTI_LD(b+x+1);
+          const __m128i cm = _LTI_LD(c+x-1), c0 = _LTI_LD(c+x);
+          const __m128i cp = _LTI_LD(c+x+1);
+#         undef _LTI_LD
+          const __m128i sx = _mm_add_epi16(_mm_sub_epi16(ap,am),
+                                           _mm_sub_epi16(cp,cm));
+          const __m128i vx =
+            _mm_add_epi16(_mm_mullo_epi16(vs,sx),
+                          _mm_mullo_epi16(vc,_mm_sub_epi16(bp,bm)));
+          const __m128i sy = _mm_add_epi16(_mm_sub_epi16(cm,am),
+                                           _mm_sub_epi16(cp,ap));
+          const __m128i vy =
+            _mm_add_epi16(_mm_mullo_epi16(vs,sy),
+                          _mm_mullo_epi16(vc,_mm_sub_epi16(c0,a0)));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(gx+x),vx);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(gy+x),vy);
+        }
+      }
+#endif
+      for (;x<cols-1;++x) {
+        gx[x] = static_cast<int16>(ws*(a[x+1]-a[x-1]) + wc*(b[x+1]-b[x-1]) +
+                                   ws*(c[x+1]-c[x-1]));
+        gy[x] = static_cast<int16>(ws*(c[x-1]-a[x-1]) + wc*(c[x]-a[x]) +
+                                   ws*(c[x+1]-a[x+1]));
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * Squared gradient magnitude of a row.  Returns the largest value.
+   */
+  static int squaredMagnitude(const int16* gx,
+                              const int16* gy,
+                              const int cols,
+                              int* dst) {
+    int x=0;
+#if defined(__AVX2__)
+    for (;x+16<=cols;x+=16) {
+      const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gx+x));
+      const __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gy+x));
+      const __m256i lo = _mm256_unpacklo_epi16(vx,vy);
+      const __m256i hi = _mm256_unpackhi_epi16(vx,vy);
+      const __m256i mlo = _mm256_madd_epi16(lo,lo);
+      const __m256i mhi = _mm256_madd_epi16(hi,hi);
+      // the unpacking works on each 128 bit lane
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+x),
+                          _mm256_permute2x128_si256(mlo,mhi,0x20));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+x+8),
+                          _mm256_permute2x128_si256(mlo,mhi,0x31));
+    }
+#endif
+#if defined(__SSE2__)
+    for (;x+8<=cols;x+=8) {
+      const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gx+x));
+      const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gy+x));
+      const __m128i lo = _mm_unpacklo_epi16(vx,vy);
+      const __m128i hi = _mm_unpackhi_epi16(vx,vy);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+x),_mm_madd_epi16(lo,lo));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+x+4),
+                       _mm_madd_epi16(hi,hi));
+    }
+#endif
+    for (;x<cols;++x) {
+      dst[x] = gx[x]*gx[x] + gy[x]*gy[x];
+    }
+
+    int m = 0;
+    for (x=0;x<cols;++x) {
+      m = max(m,dst[x]);
+    }
+    return m;
+  }
+
+  bool stagedCannyEdges::fixedSuppress() {
+    const int rows = src8_.rows();
+    const int cols = src8_.columns();
+
+    suppressed_.assign(rows,cols,0.0f);
+
+    // squared magnitudes of the rows y-1, y and y+1
+    std::vector<int> ring(3*cols);
+    int maxSq = squaredMagnitude(&gx16_[0],&gy16_[0],cols,&ring[0]);
+    if (rows > 1) {
+      maxSq = max(maxSq,squaredMagnitude(&gx16_[cols],&gy16_[cols],cols,
+                                         &ring[cols]));
+    }
+
+    // tan(22.5 degrees) with 15 fractional bits
+    static const int tan22 = 13573;
+
+    for (int y=1;y<rows-1;++y) {
+      const int* prev = &ring[((y-1)%3)*cols];
+      const int* cur  = &ring[(y%3)*cols];
+      int* next = &ring[((y+1)%3)*cols];
+      maxSq = max(maxSq,squaredMagnitude(&gx16_[(y+1)*cols],
+                                         &gy16_[(y+1)*cols],cols,next));
+
+      const int16* gx = &gx16_[y*cols];
+      const int16* gy = &gy16_[y*cols];
+      float* sup = &suppressed_.at(y,0);
+
+      for (int x=1;x<cols-1;++x) {
+        const int m = cur[x];
+        if (m <= 0) {
+          continue;
+        }
+
+        // octant of the gradient direction, folded into four sectors
+        const int ax = abs(static_cast<int>(gx[x]));
+        const int ay = abs(static_cast<int>(gy[x]));
+        int fwd,back;
+        if ((ay << 15) <= ax*tan22) {        // horizontal
+          fwd  = cur[x+1];
+          back = cur[x-1];
+        } else if ((ax << 15) <= ay*tan22) { // vertical
+          fwd  = next[x];
+          back = prev[x];
+        } else if ((gx[x] ^ gy[x]) >= 0) {   // 45 degrees
+          fwd  = next[x+1];
+          back = prev[x-1];
+        } else {                             // 135 degrees
+          fwd  = next[x-1];
+          back = prev[x+1];
+        }
+
+        // ties are kept only on one side to avoid double edges
+        if ((m >= fwd) && (m > back)) {
+          sup[x] = sqrt(static_cast<float>(m));
+        }
+      }
+    }
+
+    maxMagnitude_ = sqrt(static_cast<float>(maxSq));
+
+    // the float stages are not computed
+    smoothed_.clear();
+    magnitude_.clear();
+    orientation_.clear();
+
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // Parallel hysteresis
+  // -------------------------------------------------------------------
+
+  /**
+   * The image is split into horizontal strips.  The candidate pixels (above
+   * the low threshold) of each strip are labeled independently, with a
+   * union-find forest over the pixel indices where the root of each set is
+   * its smallest index.  The forests of neighbor strips are then merged
+   * along the strip borders, all borders at the same time, linking the
+   * roots with compare-and-swap.  Finally each root is marked if any pixel
+   * of its set is strong, and the edges are the pixels with a marked root.
+   *
+   * Each phase is one call to workerPool::apply(), which acts as the
+   * barrier between them.
+   */
+  class stagedCannyEdges::hysteresisJob : public workerPool::job {
+  public:
+    /**
+     * Phases of the parallel hysteresis
+     */
+    enum ePhase {
+      Label,  /**< Label each strip (items are strips) */
+      Merge,  /**< Link the strips (items are the borders between them) */
+      Strong, /**< Flatten the forest and mark the strong roots */
+      Output  /**< Write the edges mask (items are strips) */
+    };
+
+    hysteresisJob(const channel& sup,
+                  const float low,
+                  const float high,
+                  const int strips,
+                  const ubyte edgeValue,
+                  const ubyte noEdgeValue,
+                  channel8& edges)
+      : phase(Label),sup_(sup),low_(low),high_(high),rows_(sup.rows()),
+        cols_(sup.columns()),strips_(strips),edgeValue_(edgeValue),
+        noEdgeValue_(noEdgeValue),edges_(edges),
+        parent_(sup.rows()*sup.columns(),-1),
+        strong_(sup.rows()*sup.columns(),0) {
+    }
+
+    virtual void process(const int from,const int to,const int) {
+      for (int i=from;i<to;++i) {
+        switch(phase) {
+        case Label:
+          label(i);
+          break;
+        case Merge:
+          merge(i);
+          break;
+        case Strong:
+          mark(i);
+          break;
+        case Output:
+          output(i);
+          break;
+        }
+      }
+    }
+
+    /**
+     * Current phase
+     */
+    ePhase phase;
+
+  private:
+    /**
+     * First row of the given strip
+     */
+    inline int firstRow(const int strip) const {
+      return static_cast<int>((static_cast<double>(strip)*rows_)/strips_);
+    }
+
+    /**
+     * Candidate pixels are those above the low threshold
+     */
+    inline bool candidate(const float s) const {
+      return ((s > 0.0f) && (s >= low_));
+    }
+
+    /**
+     * Root of the set of pixel p
+     */
+    inline int find(int p) const {
+      while (parent_[p] != p) {
+        p = parent_[p];
+      }
+      return p;
+    }
+
+    /**
+     * Merge the sets of a and b within one strip, where no other thread
+     * can touch the forest.
+     */
+    inline void localUnite(const int a,const int b) {
+      const int ra = find(a);
+      const int rb = find(b);
+      if (ra < rb) {
+        parent_[rb] = ra;
+      } else if (rb < ra) {
+        parent_[ra] = rb;
+      }
+    }
+
+    /**
+     * Merge the sets of a and b while other threads may be merging too.
+     * The larger root is linked to the smaller one only if it is still a
+     * root, otherwise the roots are searched again.
+     */
+    inline void concurrentUnite(int a,int b) {
+      for (;;) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+          return;
+        }
+        if (a < b) {
+          swap(a,b);
+        }
+        if (__sync_bool_compare_and_swap(&parent_[a],a,b)) {
+          return;
+        }
+      }
+    }
+
+    void label(const int strip) {
+      const int first = firstRow(strip);
+      const int last = firstRow(strip+1);
+
+      for (int y=first;y<last;++y) {
+        const float* s = &sup_.at(y,0);
+        const int row = y*cols_;
+        for (int x=0;x<cols_;++x) {
+          if (!candidate(s[x])) {
+            continue;
+          }
+          const int p = row+x;
+          parent_[p] = p;
+
+          // west, and in the previous row of the same strip north-west,
+          // north and north-east
+          if ((x > 0) && (parent_[p-1] >= 0)) {
+            localUnite(p,p-1);
+          }
+          if (y > first) {
+            const int n = p-cols_;
+            if (parent_[n] >= 0) {
+              localUnite(p,n);
+            } else {
+              // north-west and north-east are connected through north
+              // whenever it is a candidate
+              if ((x > 0) && (parent_[n-1] >= 0)) {
+                localUnite(p,n-1);
+              }
+              if ((x < cols_-1) && (parent_[n+1] >= 0)) {
+                localUnite(p,n+1);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    void merge(const int border) {
+      const int y = firstRow(border+1);
+      if ((y <= 0) || (y >= rows_)) {
+        return;
+      }
+      const int row = y*cols_;
+      for (int x=0;x<cols_;++x) {
+        const int p = row+x;
+        if (parent_[p] < 0) {
+          continue;
+        }
+        const int n = p-cols_;
+        if (parent_[n] >= 0) {
+          concurrentUnite(p,n);
+        } else {
+          if ((x > 0) && (parent_[n-1] >= 0)) {
+            concurrentUnite(p,n-1);
+          }
+          if ((x < cols_-1) && (parent_[n+1] >= 0)) {
+            concurrentUnite(p,n+1);
+          }
+        }
+      }
+    }
+
+    void mark(const int strip) {
+      const int first = firstRow(strip)*cols_;
+      const int last = firstRow(strip+1)*cols_;
+      const float* s = &sup_.at(0,0);
+
+      for (int p=first;p<last;++p) {
+        if (parent_[p] < 0) {
+          continue;
+        }
+        // writing an ancestor is harmless for concurrent searches
+        const int r = find(p);
+        parent_[p] = r;
+        if (s[p] >= high_) {
+          strong_[r] = 1;
+        }
+      }
+    }
+
+    void output(const int strip) {
+      const int first = firstRow(strip);
+      const int last = firstRow(strip+1);
+
+      for (int y=first;y<last;++y) {
+        ubyte* e = &edges_.at(y,0);
+        const int row = y*cols_;
+        for (int x=0;x<cols_;++x) {
+          const int r = parent_[row+x];
+          e[x] = ((r >= 0) && (strong_[r] != 0)) ? edgeValue_ : noEdgeValue_;
+        }
+      }
+    }
+
+    const channel& sup_;
+    const float low_,high_;
+    const int rows_,cols_,strips_;
+    const ubyte edgeValue_,noEdgeValue_;
+    channel8& edges_;
+
+    /**
+     * Parent of each candidate pixel in the union-find forest, -1 for the
+     * rest
+     */
+    std::vector<int> parent_;
+
+    /**
+     * Roots of the sets containing a strong pixel
+     */
+    std::vector<ubyte> strong_;
+  };
+
+  bool stagedCannyEdges::parallelHysteresis(const float low,
+                                            const float high,
+                                            const int threads,
+                                            channel8& edges) const {
+    const parameters& par = getParameters();
+    const int rows = suppressed_.rows();
+
+    edges.allocate(rows,suppressed_.columns());
+    if (par.edgeValue == par.noEdgeValue) {
+      edges.fill(par.noEdgeValue);
+      return true; // nothing to distinguish
+    }
+
+    workerPool pool(threads);
+    // a few strips per thread balance the load, but each border costs a
+    // merge of one row
+    const int strips = max(1,min(rows/8,4*pool.size()));
+
+    // with low above high the flood fill keeps just the strong pixels
+    hysteresisJob job(suppressed_,min(low,high),high,strips,
+                      par.edgeValue,par.noEdgeValue,edges);
+
+    job.phase = hysteresisJob::Label;
+    pool.apply(job,strips);
+    job.phase = hysteresisJob::Merge;
+    pool.apply(job,strips-1);
+    job.phase = hysteresisJob::Strong;
+    pool.apply(job,strips);
+    job.phase = hysteresisJob::Output;
+    pool.apply(job,strips);
+
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // Storable interface
+  // -------------------------------------------------------------------
+
+  bool read(ioHandler& handler,stagedCannyEdges::eSmoothingType& data) {
+    std::string str;
+    if (handler.read(str)) {
+      if (str.find("ecur") != std::string::npos) {
+        data = stagedCannyEdges::Recursive;
+      } else {
+        data = stagedCannyEdges::Convolution;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool write(ioHandler& handler,
+             const stagedCannyEdges::eSmoothingType& data) {
+    switch(data) {
+    case stagedCannyEdges::Recursive:
+      return handler.write("Recursive");
+    default:
+      return handler.write("Convolution");
+    }
+    return false;
+  }
+
+}
@@ -0,0 +1,552 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiStagedCannyEdges.h
+ *         Canny edge detector that keeps the intermediate results of each
+ *         stage, so that parameter changes only recompute what depends on
+ *         them.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_STAGED_CANNY_EDGES_H_
+#define _LTI_STAGED_CANNY_EDGES_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+#include "ltiCannyEdges.h"
+#include "ltiBitMask.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Staged Canny edge detector.
+   *
+   * This functor computes the Canny edges in four stages:
+   *
+   * -# Gaussian smoothing of the input channel (\c variance, \c kernelSize)
+   * -# Gradient magnitude and orientation (\c gradientParameters)
+   * -# Non-maxima suppression along the gradient direction
+   * -# Hysteresis between \c thresholdMin and \c thresholdMax
+   *
+   * The result of each stage is kept in the functor.  With use() the input
+   * channel is given once and each later apply() recomputes only the stages
+   * downstream of the parameters that changed since the last call.  For
+   * instance, if only the thresholds change, just the hysteresis is
+   * executed again, which is what the interactive parameter selection of
+   * the canny example needs.
+   *
+   * The thresholds are interpreted as in the canny.lsp files:
+   * \c thresholdMax is the fraction of the largest gradient magnitude in the
+   * image above which a pixel is an edge, and \c thresholdMin is the
+   * fraction of that high threshold above which a pixel is an edge if it
+   * is connected to another edge pixel.
+   *
+   * If the input is a channel8, the smoothing is a convolution and the
+   * gradient kernel is Difference, Sobel or Prewitt, the first three stages
+   * are computed in fixed point (see parameters::fixedPoint): the smoothed
+   * image and the gradient components are int16, the non-maxima
+   * suppression compares squared magnitudes and chooses the direction by
+   * octant comparisons instead of atan2.  The inner loops use SSE2 or AVX2
+   * when the compiler targets them.  In this mode only getSuppressed() and
+   * getMaxMagnitude() are available, in fixed point units.
+   *
+   * Example:
+   * \code
+   * lti::stagedCannyEdges canny(par);
+   * canny.use(chnl);
+   * canny.apply(edges);          // all four stages
+   * par.thresholdMax = 0.1f;
+   * canny.setParameters(par);
+   * canny.apply(edges);          // only the hysteresis
+   * \endcode
+   */
+  class stagedCannyEdges : public functor {
+  public:
+    /**
+     * Methods for the Gaussian smoothing
+     */
+    enum eSmoothingType {
+      Convolution, /**< Separable convolution with lti::gaussKernel2D of
+                    *   \c kernelSize taps.  The cost grows linearly with the
+                    *   kernel size. */
+      Recursive    /**< Recursive filter (lti::recursiveGaussian).  The cost
+                    *   per pixel does not depend on the variance and
+                    *   \c kernelSize is ignored. */
+    };
+
+    /**
+     * The parameters for the class stagedCannyEdges
+     */
+    class parameters : public cannyEdges::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Method used for the Gaussian smoothing.
+       *
+       * Default value: Convolution
+       */
+      eSmoothingType smoothingType;
+
+      /**
+       * Number of threads used for the hysteresis.
+       *
+       * With 1 the hysteresis is the serial flood fill from the strong
+       * pixels.  Otherwise the image is split into horizontal strips that
+       * are labeled in parallel, and the components are merged across the
+       * strip borders with a concurrent union-find.  Both produce exactly
+       * the same mask.  Zero means one thread per processor.
+       *
+       * Default value: 1
+       */
+      int hysteresisThreads;
+
+      /**
+       * Compute the smoothing, gradient and suppression of channel8 inputs
+       * in fixed point, where possible.
+       *
+       * The masks are identical to the float path except for pixels whose
+       * gradient lies almost exactly on the border between two directions
+       * or where the rounding of the integer Gaussian matters.
+       *
+       * Default value: true
+       */
+      bool fixedPoint;
+    };
+
+    /**
+     * The stages of the detector, in the order they are computed.
+     */
+    enum eStage {
+      Smoothing=0, /**< Gaussian smoothing */
+      Gradient,    /**< Gradient magnitude and orientation */
+      Suppression, /**< Non-maxima suppression */
+      Hysteresis,  /**< Hysteresis thresholding */
+      Cached       /**< Nothing had to be recomputed */
+    };
+
+    /**
+     * Default constructor
+     */
+    stagedCannyEdges();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    stagedCannyEdges(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    stagedCannyEdges(const stagedCannyEdges& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~stagedCannyEdges();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    stagedCannyEdges& copy(const stagedCannyEdges& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    stagedCannyEdges& operator=(const stagedCannyEdges& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual stagedCannyEdges* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual stagedCannyEdges* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Set the input channel.  All cached stages are invalidated.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool use(const channel& src);
+
+    /**
+     * Set the input channel.  All cached stages are invalidated.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool use(const channel8& src);
+
+    /**
+     * Compute the edges of the channel given with use(), recomputing only
+     * the stages affected by the parameter changes since the last call.
+     *
+     * @param edges the edges mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(channel8& edges);
+
+    /**
+     * Compute the edges of the channel given with use() as in
+     * apply(channel8&), setting the edge pixels of a binary mask.
+     *
+     * @param edges the edges mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(bitMask& edges);
+
+    /**
+     * Compute the edges of the given channel.  This is equivalent to
+     * calling use() and then apply(), so all stages are computed.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& src,channel8& edges);
+
+    /**
+     * Compute the edges of the given channel.  This is equivalent to
+     * calling use() and then apply(), so all stages are computed.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel8& src,channel8& edges);
+
+    /**
+     * Hysteresis of the cached non-maxima suppression result with the
+     * given absolute thresholds.
+     *
+     * This method does not modify the functor, so that several threads
+     * may evaluate different thresholds on the same cached stages at the
+     * same time (in that case \c hysteresisThreads should be 1).  The
+     * suppression stage must be up to date, i.e. apply() or update() must
+     * have been called before.
+     *
+     * @param low pixels above this value are edges if connected to an edge
+     * @param high pixels above this value are edges
+     * @param edges the resulting edges mask
+     * @return true if successful, false otherwise
+     */
+    bool hysteresis(const float low,const float high,channel8& edges) const;
+
+    /**
+     * Recompute the stages invalidated by parameter changes up to (but not
+     * including) the hysteresis.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool update();
+
+    /**
+     * Invalidate all cached stages, so that the next apply() recomputes
+     * everything.
+     */
+    void invalidate();
+
+    /**
+     * First stage recomputed in the last call to apply() or update().
+     */
+    eStage getFirstRecomputedStage() const;
+
+    /**
+     * @name Cached stages
+     */
+    //@{
+    /**
+     * Smoothed input channel
+     */
+    const channel& getSmoothed() const;
+
+    /**
+     * Gradient magnitude
+     */
+    const channel& getMagnitude() const;
+
+    /**
+     * Gradient orientation in radians
+     */
+    const channel& getOrientation() const;
+
+    /**
+     * Gradient magnitude after the non-maxima suppression (zero where
+     * suppressed)
+     */
+    const channel& getSuppressed() const;
+
+    /**
+     * Largest gradient magnitude, used as reference for the thresholds
+     */
+    float getMaxMagnitude() const;
+
+    /**
+     * Whether the current input and parameters use the fixed point stages
+     */
+    bool useFixedPoint() const;
+    //@}
+
+  protected:
+    /**
+     * Number of stages currently valid, i.e. the index of the first stage
+     * that must be recomputed.
+     */
+    int valid_;
+
+    /**
+     * Parameters used to compute the cached stages
+     */
+    parameters cached_;
+
+    /**
+     * First stage recomputed in the last call
+     */
+    eStage recomputed_;
+
+    /**
+     * Compute the first invalid stage considering the current parameters.
+     */
+    int firstInvalidStage() const;
+
+    /**
+     * Bring all stages up to date, including the hysteresis into edges_
+     */
+    bool updateEdges();
+
+    /**
+     * @name Stages
+     */
+    //@{
+    /**
+     * Gaussian smoothing of src_ into smoothed_
+     */
+    bool smooth();
+
+    /**
+     * Gradient of smoothed_ into magnitude_ and orientation_
+     */
+    bool gradient();
+
+    /**
+     * Non-maxima suppression of magnitude_ into suppressed_
+     */
+    bool suppress();
+    //@}
+
+    /**
+     * @name Fixed point stages
+     */
+    //@{
+    /**
+     * Integer Gaussian smoothing of src8_ into smoothed16_
+     */
+    bool fixedSmooth();
+
+    /**
+     * int16 gradient components of smoothed16_ into gx16_ and gy16_
+     */
+    bool fixedGradient();
+
+    /**
+     * Non-maxima suppression of the squared magnitude into suppressed_
+     */
+    bool fixedSuppress();
+    //@}
+
+    /**
+     * @name Hysteresis variants
+     */
+    //@{
+    /**
+     * Flood fill from each strong pixel
+     */
+    bool serialHysteresis(const float low,
+                          const float high,
+                          channel8& edges) const;
+
+    /**
+     * Parallel labeling of strips merged with a concurrent union-find
+     */
+    bool parallelHysteresis(const float low,
+                            const float high,
+                            const int threads,
+                            channel8& edges) const;
+
+    /**
+     * Work done by each thread of the parallel hysteresis
+     */
+    class hysteresisJob;
+    //@}
+
+    /**
+     * @name Data of the stages
+     */
+    //@{
+    channel src_;
+    channel8 src8_;
+    channel smoothed_;
+    channel magnitude_;
+    channel orientation_;
+    channel suppressed_;
+    float maxMagnitude_;
+    channel8 edges_;
+    //@}
+
+    /**
+     * @name Data of the fixed point stages
+     */
+    //@{
+    /**
+     * The cached stages were computed in fixed point
+     */
+    bool fixed_;
+
+    /**
+     * Smoothed input, with 5 (Sobel, Prewitt) or 7 (Difference) fractional bits
+     */
+    std::vector<int16> smoothed16_;
+
+    /**
+     * Gradient components
+     */
+    std::vector<int16> gx16_;
+    std::vector<int16> gy16_;
+    //@}
+  };
+
+  /**
+   * Read a stagedCannyEdges::eSmoothingType
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler,stagedCannyEdges::eSmoothingType& data);
+
+  /**
+   * Write a stagedCannyEdges::eSmoothingType
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,const stagedCannyEdges::eSmoothingType& data);
+}
+
+#endif
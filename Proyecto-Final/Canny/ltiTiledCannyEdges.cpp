@@ -0,0 +1,853 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiTiledCannyEdges.cpp
+ *         Canny edge detector for images larger than the available memory,
+ *         processed in bands of rows streamed from and to disk.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiTiledCannyEdges.h"
+#include "ltiMath.h"
+#include "ltiMatrix.h"
+#include "ltiRowStream.h"
+#include "ltiWorkerPool.h"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+namespace lti {
+  // --------------------------------------------------
+  // tiledCannyEdges::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  tiledCannyEdges::parameters::parameters()
+    : stagedCannyEdges::parameters() {
+    bandHeight = 256;
+    threads = 0;
+  }
+
+  // copy constructor
+  tiledCannyEdges::parameters::parameters(const parameters& other)
+    : stagedCannyEdges::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  tiledCannyEdges::parameters::~parameters() {
+  }
+
+  // copy member
+  tiledCannyEdges::parameters&
+  tiledCannyEdges::parameters::copy(const parameters& other) {
+    stagedCannyEdges::parameters::copy(other);
+
+    bandHeight = other.bandHeight;
+    threads    = other.threads;
+
+    return *this;
+  }
+
+  // alias for copy method
+  tiledCannyEdges::parameters&
+  tiledCannyEdges::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& tiledCannyEdges::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  tiledCannyEdges::parameters*
+  tiledCannyEdges::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  tiledCannyEdges::parameters*
+  tiledCannyEdges::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  bool tiledCannyEdges::parameters::write(ioHandler& handler,
+                                          const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"bandHeight",bandHeight) && b;
+      b = lti::write(handler,"threads",threads) && b;
+    }
+
+    b = b && stagedCannyEdges::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  bool tiledCannyEdges::parameters::read(ioHandler& handler,
+                                         const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"bandHeight",bandHeight) && b;
+      b = lti::read(handler,"threads",threads) && b;
+    }
+
+    b = b && stagedCannyEdges::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // tiledCannyEdges::bandJob
+  // --------------------------------------------------
+
+  /**
+   * Computation of the bands.  The rows of a group of consecutive bands
+   * (one per worker), including their halos, are kept in a window that
+   * slides down the image.  Each item of the job is one band of the
+   * current group.
+   */
+  class tiledCannyEdges::bandJob : public workerPool::job {
+  public:
+    /**
+     * What is computed for each band
+     */
+    enum ePass {
+      MaxMagnitude, /**< Largest gradient magnitude of the band */
+      Link,         /**< Components touching the band borders */
+      Output        /**< Edges mask of the band */
+    };
+
+    /**
+     * Labeling results of a band needed in later passes
+     */
+    struct band {
+      band() : offset(0) {}
+
+      /**
+       * Sorted local labels of the components touching the first or the
+       * last core row.  The position in this vector plus offset is the
+       * global node of the component.
+       */
+      std::vector<int> boundary;
+
+      /**
+       * Whether each boundary component contains a strong pixel
+       */
+      std::vector<char> strong;
+
+      /**
+       * Column and boundary index of the candidate pixels in the first and
+       * in the last core row, sorted by column.
+       */
+      std::vector< std::pair<int,int> > top,bottom;
+
+      /**
+       * Global node of the first boundary component
+       */
+      int offset;
+    };
+
+    bandJob(const parameters& par,
+            const int rows,
+            const int columns,
+            const int halo,
+            const int workers)
+      : pass(MaxMagnitude),low(0.0f),high(0.0f),
+        rows_(rows),columns_(columns),bandHeight_(max(1,par.bandHeight)),
+        halo_(halo),group_(workers),groupFirst_(0),windowFirst_(0),
+        windowRows_(0),failed_(false),
+        data_(workers,static_cast<workerData*>(0)) {
+      const int n = (rows_+bandHeight_-1)/bandHeight_;
+      bands.resize(n);
+      maxima.resize(n,0.0f);
+      masks.resize(group_);
+      window_.allocate(min(rows_,group_*bandHeight_+2*halo_),columns_);
+
+      for (int i=0;i<workers;++i) {
+        data_[i]=new workerData(par);
+      }
+    }
+
+    ~bandJob() {
+      for (unsigned int i=0;i<data_.size();++i) {
+        delete data_[i];
+        data_[i]=0;
+      }
+    }
+
+    /**
+     * Stream all rows of the reader through the window, processing the
+     * bands of each group in parallel.  In the Output pass the mask rows
+     * are written in order after each group.
+     */
+    bool stream(rowReader& reader,
+                workerPool& pool,
+                rowWriter* writer,
+                std::string& error) {
+      windowFirst_ = windowRows_ = 0;
+      const int n = static_cast<int>(bands.size());
+
+      for (groupFirst_=0;groupFirst_<n;groupFirst_+=group_) {
+        const int last = min(n,groupFirst_+group_);
+        const int from = max(0,groupFirst_*bandHeight_-halo_);
+        const int to = min(rows_,last*bandHeight_+halo_);
+
+        // keep the rows shared with the previous group and read the rest
+        const int keep = windowFirst_+windowRows_-from;
+        for (int r=0;r<keep;++r) {
+          memmove(&window_.at(r,0),&window_.at(from-windowFirst_+r,0),
+                  columns_*sizeof(float));
+        }
+        windowFirst_ = from;
+        windowRows_ = max(0,keep);
+        while (windowFirst_+windowRows_ < to) {
+          if (!reader.read(window_,windowRows_)) {
+            error = reader.getStatusString();
+            return false;
+          }
+          ++windowRows_;
+        }
+
+        pool.apply(*this,last-groupFirst_);
+        if (failed_) {
+          error = "A band could not be computed";
+          return false;
+        }
+
+        if (writer != 0) {
+          for (int i=0;i<last-groupFirst_;++i) {
+            for (int r=0;r<masks[i].rows();++r) {
+              if (!writer->write(masks[i],r)) {
+                error = writer->getStatusString();
+                return false;
+              }
+            }
+          }
+        }
+      }
+      return true;
+    }
+
+    virtual void process(const int from,const int to,const int worker) {
+      workerData& d = *data_[worker];
+
+      for (int i=from;i<to;++i) {
+        const int b = groupFirst_+i;
+        const int first = b*bandHeight_;
+        const int last = min(rows_,first+bandHeight_)-1;
+        const int hfirst = max(0,first-halo_);
+        const int hlast = min(rows_-1,last+halo_);
+
+        d.input.allocate(hlast-hfirst+1,columns_);
+        for (int y=hfirst;y<=hlast;++y) {
+          memcpy(&d.input.at(y-hfirst,0),&window_.at(y-windowFirst_,0),
+                 columns_*sizeof(float));
+        }
+        if (!d.detector.use(d.input) || !d.detector.update()) {
+          failed_ = true;
+          continue;
+        }
+
+        switch(pass) {
+        case MaxMagnitude:
+          maxima[b] = maxMagnitude(d,first-hfirst,last-hfirst);
+          break;
+        case Link:
+          link(d,first-hfirst,last-hfirst,bands[b]);
+          break;
+        case Output:
+          output(d,first-hfirst,last-hfirst,bands[b],masks[i]);
+          break;
+        }
+      }
+    }
+
+    /**
+     * Current pass
+     */
+    ePass pass;
+
+    /**
+     * Absolute hysteresis thresholds
+     */
+    float low,high;
+
+    /**
+     * Labeling results of all bands
+     */
+    std::vector<band> bands;
+
+    /**
+     * Largest gradient magnitude of each band
+     */
+    std::vector<float> maxima;
+
+    /**
+     * Whether each global node belongs to a component with an edge
+     */
+    std::vector<char> nodeEdge;
+
+    /**
+     * Masks of the bands of the current group
+     */
+    std::vector<channel8> masks;
+
+  private:
+    /**
+     * Everything a worker needs for itself
+     */
+    struct workerData {
+      workerData(const parameters& par)
+        : detector(par) {
+      }
+
+      stagedCannyEdges detector;
+      channel input;
+      imatrix labels;
+      std::vector<int> parent;
+      std::vector<char> strong;
+      std::vector<int> index;
+    };
+
+    /**
+     * Root of the provisional label i, halving the path on the way
+     */
+    static int find(std::vector<int>& parent,int i) {
+      while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    }
+
+    /**
+     * Merge the sets of the labels a and b, keeping the smaller root
+     */
+    static int unite(std::vector<int>& parent,const int a,const int b) {
+      const int ra = find(parent,a);
+      const int rb = find(parent,b);
+      if (ra < rb) {
+        parent[rb] = ra;
+        return ra;
+      }
+      parent[ra] = rb;
+      return rb;
+    }
+
+    /**
+     * Largest gradient magnitude in the given rows of the band
+     */
+    float maxMagnitude(workerData& d,const int first,const int last) const {
+      const channel& mag = d.detector.getMagnitude();
+      float m = 0.0f;
+      for (int y=first;y<=last;++y) {
+        const float* p = &mag.at(y,0);
+        for (int x=0;x<columns_;++x) {
+          if (p[x] > m) {
+            m = p[x];
+          }
+        }
+      }
+      return m;
+    }
+
+    /**
+     * Label the 8-connected components of the candidate pixels (above the
+     * low threshold) in the given rows of the suppressed gradient.
+     *
+     * The labels are left in d.labels (-1 for background) and whether
+     * each component has a pixel above the high threshold in d.strong.
+     *
+     * @return the number of components
+     */
+    int label(workerData& d,const int first,const int last) const {
+      const channel& sup = d.detector.getSuppressed();
+      const int rows = last-first+1;
+
+      d.labels.assign(rows,columns_,-1);
+      d.parent.clear();
+
+      for (int y=0;y<rows;++y) {
+        const float* s = &sup.at(first+y,0);
+        int* lbl = &d.labels.at(y,0);
+        const int* prev = (y>0) ? &d.labels.at(y-1,0) : 0;
+
+        for (int x=0;x<columns_;++x) {
+          if ((s[x] <= 0.0f) || (s[x] < low)) {
+            continue;
+          }
+
+          // neighbors already visited: west, north-west, north, north-east
+          int l = (x>0) ? lbl[x-1] : -1;
+          if (prev != 0) {
+            const int fx = max(0,x-1);
+            const int tx = min(columns_-1,x+1);
+            for (int nx=fx;nx<=tx;++nx) {
+              if (prev[nx] >= 0) {
+                l = (l<0) ? prev[nx] : unite(d.parent,l,prev[nx]);
+              }
+            }
+          }
+
+          if (l < 0) {
+            l = static_cast<int>(d.parent.size());
+            d.parent.push_back(l);
+          }
+          lbl[x] = l;
+        }
+      }
+
+      // consecutive labels, in the order the components first appear.  The
+      // root of a set is its smallest label, thus already numbered.
+      const int provisional = static_cast<int>(d.parent.size());
+      d.index.resize(provisional);
+      int n = 0;
+      for (int i=0;i<provisional;++i) {
+        const int r = find(d.parent,i);
+        d.index[i] = (r == i) ? n++ : d.index[r];
+      }
+
+      d.strong.assign(n,0);
+      for (int y=0;y<rows;++y) {
+        const float* s = &sup.at(first+y,0);
+        int* lbl = &d.labels.at(y,0);
+        for (int x=0;x<columns_;++x) {
+          if (lbl[x] >= 0) {
+            lbl[x] = d.index[lbl[x]];
+            if (s[x] >= high) {
+              d.strong[lbl[x]] = 1;
+            }
+          }
+        }
+      }
+
+      return n;
+    }
+
+    /**
+     * Map the local labels of the boundary components of the band into
+     * their position in b.boundary (-1 for inner components)
+     */
+    void boundaryIndex(workerData& d,const int n,const band& b) const {
+      d.index.assign(n,-1);
+      for (unsigned int i=0;i<b.boundary.size();++i) {
+        d.index[b.boundary[i]] = i;
+      }
+    }
+
+    /**
+     * Label the band and keep the components touching its borders
+     */
+    void link(workerData& d,const int first,const int last,band& b) const {
+      const int n = label(d,first,last);
+      const int lastRow = last-first;
+
+      b.boundary.clear();
+      for (int x=0;x<columns_;++x) {
+        if (d.labels.at(0,x) >= 0) {
+          b.boundary.push_back(d.labels.at(0,x));
+        }
+        if (d.labels.at(lastRow,x) >= 0) {
+          b.boundary.push_back(d.labels.at(lastRow,x));
+        }
+      }
+      std::sort(b.boundary.begin(),b.boundary.end());
+      b.boundary.erase(std::unique(b.boundary.begin(),b.boundary.end()),
+                       b.boundary.end());
+
+      boundaryIndex(d,n,b);
+      b.strong.resize(b.boundary.size());
+      for (unsigned int i=0;i<b.boundary.size();++i) {
+        b.strong[i] = d.strong[b.boundary[i]];
+      }
+
+      b.top.clear();
+      b.bottom.clear();
+      for (int x=0;x<columns_;++x) {
+        const int t = d.labels.at(0,x);
+        if (t >= 0) {
+          b.top.push_back(std::make_pair(x,d.index[t]));
+        }
+        const int m = d.labels.at(lastRow,x);
+        if (m >= 0) {
+          b.bottom.push_back(std::make_pair(x,d.index[m]));
+        }
+      }
+    }
+
+    /**
+     * Label the band again and write the mask of its core rows
+     */
+    void output(workerData& d,
+                const int first,
+                const int last,
+                const band& b,
+                channel8& mask) const {
+      const stagedCannyEdges::parameters& par = d.detector.getParameters();
+      const int n = label(d,first,last);
+      boundaryIndex(d,n,b);
+
+      // the final decision for each component
+      std::vector<char>& edge = d.strong;
+      for (int l=0;l<n;++l) {
+        if (!edge[l] && (d.index[l] >= 0)) {
+          edge[l] = nodeEdge[b.offset+d.index[l]];
+        }
+      }
+
+      mask.allocate(last-first+1,columns_);
+      for (int y=0;y<mask.rows();++y) {
+        const int* lbl = &d.labels.at(y,0);
+        ubyte* m = &mask.at(y,0);
+        for (int x=0;x<columns_;++x) {
+          m[x] = ((lbl[x] >= 0) && edge[lbl[x]]) ?
+            par.edgeValue : par.noEdgeValue;
+        }
+      }
+    }
+
+    const int rows_,columns_,bandHeight_,halo_,group_;
+
+    /**
+     * First band of the current group
+     */
+    int groupFirst_;
+
+    /**
+     * Rows of the image currently in memory: the window row 0 is the image
+     * row windowFirst_, and windowRows_ rows are valid.
+     */
+    channel window_;
+    int windowFirst_,windowRows_;
+
+    /**
+     * Set by the workers if the detector fails on some band
+     */
+    bool failed_;
+
+    std::vector<workerData*> data_;
+  };
+
+  // --------------------------------------------------
+  // tiledCannyEdges
+  // --------------------------------------------------
+
+  // default constructor
+  tiledCannyEdges::tiledCannyEdges()
+    : functor(),rows_(0),columns_(0),bands_(0),borderComponents_(0),
+      maxMagnitude_(0.0f),bufferSize_(0.0) {
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  // constructor with parameters
+  tiledCannyEdges::tiledCannyEdges(const parameters& par)
+    : functor(),rows_(0),columns_(0),bands_(0),borderComponents_(0),
+      maxMagnitude_(0.0f),bufferSize_(0.0) {
+    // set the given parameters
+    setParameters(par);
+  }
+
+  // copy constructor
+  tiledCannyEdges::tiledCannyEdges(const tiledCannyEdges& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  tiledCannyEdges::~tiledCannyEdges() {
+  }
+
+  // copy member
+  tiledCannyEdges& tiledCannyEdges::copy(const tiledCannyEdges& other) {
+    functor::copy(other);
+
+    rows_             = other.rows_;
+    columns_          = other.columns_;
+    bands_            = other.bands_;
+    borderComponents_ = other.borderComponents_;
+    maxMagnitude_     = other.maxMagnitude_;
+    bufferSize_       = other.bufferSize_;
+
+    return *this;
+  }
+
+  // alias for copy member
+  tiledCannyEdges& tiledCannyEdges::operator=(const tiledCannyEdges& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& tiledCannyEdges::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  tiledCannyEdges* tiledCannyEdges::clone() const {
+    return new tiledCannyEdges(*this);
+  }
+
+  // create a new instance
+  tiledCannyEdges* tiledCannyEdges::newInstance() const {
+    return new tiledCannyEdges();
+  }
+
+  // return parameters
+  const tiledCannyEdges::parameters& tiledCannyEdges::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  int tiledCannyEdges::getRows() const {
+    return rows_;
+  }
+
+  int tiledCannyEdges::getColumns() const {
+    return columns_;
+  }
+
+  int tiledCannyEdges::getBands() const {
+    return bands_;
+  }
+
+  int tiledCannyEdges::getBorderComponents() const {
+    return borderComponents_;
+  }
+
+  float tiledCannyEdges::getMaxMagnitude() const {
+    return maxMagnitude_;
+  }
+
+  double tiledCannyEdges::getBufferSize() const {
+    return bufferSize_;
+  }
+
+  int tiledCannyEdges::getHalo() const {
+    const parameters& par = getParameters();
+
+    // rows that influence the smoothed value of a pixel
+    int smoothing = 0;
+    if (par.variance > 0.0f) {
+      if (par.smoothingType == stagedCannyEdges::Recursive) {
+        smoothing = static_cast<int>(ceil(6.0*sqrt(par.variance)));
+      } else if (par.kernelSize > 1) {
+        smoothing = par.kernelSize/2;
+      }
+    }
+
+    // the gradient kernels span at least one row on each side
+    const int grad = max(1,par.gradientParameters.gradientKernelSize/2);
+
+    // and the non-maxima suppression compares with the neighbor rows
+    return smoothing + grad + 1;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool tiledCannyEdges::apply(const std::string& src,const std::string& dest) {
+    const parameters& par = getParameters();
+
+    rowReader reader;
+    if (!reader.open(src)) {
+      setStatusString(reader.getStatusString());
+      return false;
+    }
+
+    rows_ = reader.rows();
+    columns_ = reader.columns();
+    const int halo = getHalo();
+
+    workerPool pool(par.threads);
+    bandJob job(par,rows_,columns_,halo,pool.size());
+    bands_ = static_cast<int>(job.bands.size());
+
+    // window, and for each worker the band with its halo in five float
+    // stages plus the input copy and the labels, and the masks
+    const double bandPixels =
+      static_cast<double>(min(rows_,max(1,par.bandHeight)+2*halo))*columns_;
+    bufferSize_ =
+      static_cast<double>(min(rows_,pool.size()*max(1,par.bandHeight)+
+                              2*halo))*columns_*sizeof(float) +
+      pool.size()*bandPixels*(6*sizeof(float)+sizeof(int)+sizeof(ubyte));
+
+    std::string error;
+
+    // pass 1: the largest gradient magnitude fixes the thresholds
+    job.pass = bandJob::MaxMagnitude;
+    if (!job.stream(reader,pool,0,error)) {
+      setStatusString(error);
+      return false;
+    }
+    maxMagnitude_ = 0.0f;
+    for (unsigned int i=0;i<job.maxima.size();++i) {
+      maxMagnitude_ = max(maxMagnitude_,job.maxima[i]);
+    }
+    job.high = par.thresholdMax*maxMagnitude_;
+    // with low above high the hysteresis keeps just the strong pixels
+    job.low = min(job.high,par.thresholdMin*job.high);
+
+    // pass 2: the components touching the band borders
+    if (!reader.open(src)) {
+      setStatusString(reader.getStatusString());
+      return false;
+    }
+    job.pass = bandJob::Link;
+    if (!job.stream(reader,pool,0,error)) {
+      setStatusString(error);
+      return false;
+    }
+
+    // link the components across the borders of consecutive bands
+    int nodes = 0;
+    for (int b=0;b<bands_;++b) {
+      job.bands[b].offset = nodes;
+      nodes += static_cast<int>(job.bands[b].boundary.size());
+    }
+    borderComponents_ = nodes;
+
+    std::vector<int> parent(nodes);
+    for (int i=0;i<nodes;++i) {
+      parent[i]=i;
+    }
+
+    for (int b=1;b<bands_;++b) {
+      const bandJob::band& upper = job.bands[b-1];
+      const bandJob::band& lower = job.bands[b];
+      unsigned int j=0;
+      for (unsigned int i=0;i<upper.bottom.size();++i) {
+        const int x = upper.bottom[i].first;
+        while ((j < lower.top.size()) && (lower.top[j].first < x-1)) {
+          ++j;
+        }
+        for (unsigned int k=j;
+             (k < lower.top.size()) && (lower.top[k].first <= x+1);++k) {
+          int ra = upper.offset + upper.bottom[i].second;
+          int rb = lower.offset + lower.top[k].second;
+          while (parent[ra] != ra) {
+            ra = parent[ra] = parent[parent[ra]];
+          }
+          while (parent[rb] != rb) {
+            rb = parent[rb] = parent[parent[rb]];
+          }
+          if (ra != rb) {
+            parent[max(ra,rb)] = min(ra,rb);
+          }
+        }
+      }
+      // the columns are not needed anymore
+      std::vector< std::pair<int,int> >().swap(job.bands[b-1].bottom);
+      std::vector< std::pair<int,int> >().swap(job.bands[b-1].top);
+    }
+
+    // a node is an edge if any node of its set is strong
+    std::vector<char> rootStrong(nodes,0);
+    for (int b=0;b<bands_;++b) {
+      const bandJob::band& bd = job.bands[b];
+      for (unsigned int i=0;i<bd.strong.size();++i) {
+        int r = bd.offset+i;
+        while (parent[r] != r) {
+          r = parent[r];
+        }
+        parent[bd.offset+i] = r;
+        if (bd.strong[i]) {
+          rootStrong[r] = 1;
+        }
+      }
+    }
+    job.nodeEdge.resize(nodes);
+    for (int i=0;i<nodes;++i) {
+      job.nodeEdge[i] = rootStrong[parent[i]];
+    }
+
+    // pass 3: the final masks, written band by band
+    rowWriter writer;
+    if (!reader.open(src) || !writer.open(dest,rows_,columns_)) {
+      setStatusString(reader.getStatusString());
+      appendStatusString(writer.getStatusString());
+      return false;
+    }
+    job.pass = bandJob::Output;
+    if (!job.stream(reader,pool,&writer,error)) {
+      setStatusString(error);
+      return false;
+    }
+
+    if (!writer.close()) {
+      setStatusString(writer.getStatusString());
+      return false;
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiTiledCannyEdges.h
+ *         Canny edge detector for images larger than the available memory,
+ *         processed in bands of rows streamed from and to disk.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_TILED_CANNY_EDGES_H_
+#define _LTI_TILED_CANNY_EDGES_H_
+
+#include "ltiFunctor.h"
+#include "ltiStagedCannyEdges.h"
+
+#include <string>
+
+namespace lti {
+
+  /**
+   * Tiled Canny edge detector.
+   *
+   * Micrograph mosaics easily exceed the memory available to hold a
+   * channel of floats and all intermediate stages of the detector.  This
+   * functor reads the input file with lti::rowReader in horizontal bands
+   * of \c bandHeight rows and writes the edges mask with lti::rowWriter as
+   * soon as each band is finished, so that the memory required depends on
+   * the width of the image and on the number of threads, but not on its
+   * height.
+   *
+   * Each band is extended above and below by a halo (see getHalo()) wide
+   * enough to cover the Gaussian kernel, the gradient kernel and the
+   * non-maxima suppression, so that the suppressed gradient of the core
+   * rows of a band is exactly the one obtained for the whole image.  The
+   * bands are computed in parallel by a lti::workerPool with \c threads
+   * workers.
+   *
+   * Hysteresis cannot be decided within a band, since a weak edge may be
+   * connected to a strong one many bands away.  The input is therefore
+   * streamed three times:
+   *
+   * -# The largest gradient magnitude is computed, which fixes the
+   *    absolute thresholds.
+   * -# The candidate pixels (above the low threshold) of each band are
+   *    labeled in 8-connected components.  The components touching the
+   *    first or last row of a band become nodes of a global union-find
+   *    structure, linked across the band borders.  A node is strong if any
+   *    pixel of its merged component exceeds the high threshold.
+   * -# The bands are labeled again and each component is an edge if it is
+   *    strong itself or if its global node is.  The mask rows are written
+   *    in order.
+   *
+   * The result is identical to the one of stagedCannyEdges on the
+   * complete image when the Gaussian is computed by convolution.  The
+   * recursive Gaussian depends on the initial conditions at the band
+   * borders, so that its halo of six standard deviations yields only a
+   * close approximation.
+   *
+   * Example:
+   * \code
+   * lti::tiledCannyEdges::parameters par;
+   * par.bandHeight = 512;
+   * lti::tiledCannyEdges canny(par);
+   * if (!canny.apply("mosaic.png","mosaic-canny.png")) {
+   *   std::cerr << canny.getStatusString() << std::endl;
+   * }
+   * \endcode
+   */
+  class tiledCannyEdges : public functor {
+  public:
+    /**
+     * The parameters for the class tiledCannyEdges
+     */
+    class parameters : public stagedCannyEdges::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Number of rows of each band, without the halo.
+       *
+       * Default value: 256
+       */
+      int bandHeight;
+
+      /**
+       * Number of threads computing bands in parallel.  If zero, one per
+       * processor.  Each thread keeps about 30 bytes per pixel of a band
+       * with its halo.
+       *
+       * Default value: 0
+       */
+      int threads;
+    };
+
+    /**
+     * Default constructor
+     */
+    tiledCannyEdges();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    tiledCannyEdges(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    tiledCannyEdges(const tiledCannyEdges& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~tiledCannyEdges();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    tiledCannyEdges& copy(const tiledCannyEdges& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    tiledCannyEdges& operator=(const tiledCannyEdges& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual tiledCannyEdges* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual tiledCannyEdges* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Compute the edges of the image in the file \a src and write the
+     * mask into the file \a dest.
+     *
+     * The formats supported are those of lti::rowReader and
+     * lti::rowWriter.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool apply(const std::string& src,const std::string& dest);
+
+    /**
+     * Number of rows each band must be extended above and below for the
+     * current parameters.
+     */
+    int getHalo() const;
+
+    /**
+     * @name Statistics of the last apply()
+     */
+    //@{
+    /**
+     * Number of rows of the last image
+     */
+    int getRows() const;
+
+    /**
+     * Number of columns of the last image
+     */
+    int getColumns() const;
+
+    /**
+     * Number of bands of the last image
+     */
+    int getBands() const;
+
+    /**
+     * Number of components linked across band borders
+     */
+    int getBorderComponents() const;
+
+    /**
+     * Largest gradient magnitude of the last image
+     */
+    float getMaxMagnitude() const;
+
+    /**
+     * Approximate number of bytes of image data kept in memory at once
+     */
+    double getBufferSize() const;
+    //@}
+
+  protected:
+    /**
+     * Work done by each thread on one band
+     */
+    class bandJob;
+
+    /**
+     * Statistics
+     */
+    int rows_,columns_,bands_,borderComponents_;
+    float maxMagnitude_;
+    double bufferSize_;
+  };
+
+}
+
+#endif
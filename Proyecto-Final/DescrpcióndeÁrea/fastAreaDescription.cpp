@@ -12,6 +12,8 @@
 #include <ltiKMColorQuantization.h>
 #include <ltiDraw.h>
 
+#include "ltiFusedAreaDescription.h"
+
 /**
  * Just a container for the example
  */
@@ -58,6 +60,17 @@ protected:
    */
   lti::fastAreaDescription labeler_;
 
+  /**
+   * If true, the gray values are thresholded and described in one pass
+   * instead of quantizing the colors and labeling the mask
+   */
+  bool threshold_;
+
+  /**
+   * Fused thresholding, labeling and description functor
+   */
+  lti::fusedAreaDescription fused_;
+
   /**
    * Print the usage of this example.
    */
@@ -67,6 +80,11 @@ protected:
    * Parse the commands
    */
   bool parse(int argc,char *argv[],std::list<std::string>& files);
+
+  /**
+   * Threshold the gray values of the image and show the described objects
+   */
+  int describeThresholded(const lti::image& img);
 };
 
 const char *const example::defaultConfigFile_ = "fastAreaDescription.cfg";
@@ -82,6 +100,7 @@ example::example() {
   // initialization of the attributes
   configurationFile_  = defaultConfigFile_;
   numColors_ = 4;
+  threshold_ = false;
 }
 
 bool example::read(lti::ioHandler& handler) {
@@ -89,8 +108,11 @@ bool example::read(lti::ioHandler& handler) {
 
   b = lti::read(handler,"numColors",numColors_) && b;
   lti::fastAreaDescription::parameters fad;
-  b = lti::read(handler,"fastAreaDescription",fad);
+  b = lti::read(handler,"fastAreaDescription",fad) && b;
   labeler_.setParameters(fad);
+  lti::fusedAreaDescription::parameters fused;
+  b = lti::read(handler,"fusedAreaDescription",fused) && b;
+  fused_.setParameters(fused);
   return b;
 }
 
@@ -98,7 +120,8 @@ bool example::write(lti::ioHandler& handler) const {
   bool b = true;
 
   b = lti::write(handler,"numColors",numColors_) && b;
-  b = lti::write(handler,"fastAreaDescription",labeler_.getParameters());
+  b = lti::write(handler,"fastAreaDescription",labeler_.getParameters()) && b;
+  b = lti::write(handler,"fusedAreaDescription",fused_.getParameters()) && b;
 
   return b;
 }
@@ -106,6 +129,8 @@ bool example::write(lti::ioHandler& handler) const {
 void example::usage(int argc,char *argv[]) {
   std::cout << "\nUsage: " << argv[0] << " [image] \n\n"; 
   std::cout << "  -c num colors\n";
+  std::cout << "  -t threshold the gray values and describe the objects in one\n"
+            << "     pass (see fusedAreaDescription in the configuration file)\n";
   std::cout << "  -h Show this help\n" << std::endl;
 }
 
@@ -124,6 +149,8 @@ bool example::parse(int argc,char *argv[],std::list<std::string>& files) {
       if (i<argc) {
         numColors_ = atoi(argv[i]);
       }
+    } else if ( (std::string(argv[i]) == "-t") ) {
+      threshold_ = true;
     } else {
       files.push_back(argv[i]);
     }
@@ -191,6 +218,10 @@ int example::operator()(int argc,char *argv[]) {
     } while (it!=argFiles.end() && !ok);
   }
 
+  if (threshold_) {
+    return describeThresholded(img);
+  }
+
   lti::kMColorQuantization::parameters qPar;
   qPar.numberOfColors = numColors_;
 
@@ -258,6 +289,75 @@ int example::operator()(int argc,char *argv[]) {
   return EXIT_SUCCESS;
 }
 
+int example::describeThresholded(const lti::image& img) {
+  lti::channel8 chnl8;
+  chnl8.castFrom(img);
+
+  // threshold, label and describe without any intermediate mask
+  std::vector< lti::areaDescriptor > desc;
+  fused_.apply(chnl8,desc);
+
+  int total = 0;
+  for (unsigned int i=0;i<desc.size();++i) {
+    total += static_cast<int>(desc[i].area);
+  }
+
+  std::cout << "  Objects     : " << desc.size() << std::endl;
+  std::cout << "  Total area  : " << total << std::endl;
+  if (!desc.empty()) {
+    std::cout << "  Mean area   : " 
+              << static_cast<float>(total)/desc.size() << std::endl;
+  }
+
+  // prepare the viewer
+  lti::viewer2D::parameters vpar;
+  vpar.title = "Objects";
+
+  lti::viewer2D view(vpar);
+  lti::ipoint pos;
+  lti::viewer2D::interaction action;
+  bool bye=false;
+
+  // mark all objects on a copy of the image
+  lti::channel8 marked(chnl8);
+  lti::draw<lti::ubyte> painter;
+  painter.use(marked);
+  painter.setColor(255);
+  for (unsigned int i=0;i<desc.size();++i) {
+    const lti::areaDescriptor& d = desc[i];
+    painter.rectangle(d.computeBoundingBox());
+    painter.marker(lti::iround(d.cog.x),lti::iround(d.cog.y),"+");
+  }
+
+  lti::channel8 canvas(marked);
+  painter.use(canvas);
+
+  std::cout << "Click on an object in the viewer to get its data" << std::endl;
+
+  do {
+    view.show(canvas);
+    if (view.waitButtonPressed(action,pos)) {
+      canvas.copy(marked);
+
+      // the objects whose bounding box contains the selected point
+      for (unsigned int i=0;i<desc.size();++i) {
+        const lti::areaDescriptor& d = desc[i];
+        if ((pos.x >= d.minX.x) && (pos.x <= d.maxX.x) &&
+            (pos.y >= d.minY.y) && (pos.y <= d.maxY.y)) {
+          std::cout << "Object " << i << ":\n" << d << std::endl;
+          painter.marker(d.minX,"o");
+          painter.marker(d.maxX,"o");
+          painter.marker(d.minY,"o");
+          painter.marker(d.maxY,"o");
+        }
+      }
+    } else {
+      bye = true;
+    }
+  } while( !bye);
+
+  return EXIT_SUCCESS;
+}
 
 int main(int argc,char *argv[]) {
   try {
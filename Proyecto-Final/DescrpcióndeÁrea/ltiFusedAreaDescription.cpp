@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiFusedAreaDescription.cpp
+ *         Thresholding, labeling and area description of a channel in a
+ *         single scan, without any intermediate mask.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiFusedAreaDescription.h"
+
+namespace lti {
+
+  // --------------------------------------------------
+  // fusedAreaDescription::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  fusedAreaDescription::parameters::parameters()
+    : functor::parameters() {
+    minThreshold = 0.5f;
+    maxThreshold = 1.0f;
+    fourNeighborhood = true;
+    minimumObjectSize = 1;
+  }
+
+  // copy constructor
+  fusedAreaDescription::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  fusedAreaDescription::parameters::~parameters() {
+  }
+
+  // copy member
+  fusedAreaDescription::parameters&
+  fusedAreaDescription::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    minThreshold = other.minThreshold;
+    maxThreshold = other.maxThreshold;
+    fourNeighborhood = other.fourNeighborhood;
+    minimumObjectSize = other.minimumObjectSize;
+
+    return *this;
+  }
+
+  // alias for copy method
+  fusedAreaDescription::parameters&
+  fusedAreaDescription::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& fusedAreaDescription::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  fusedAreaDescription::parameters*
+  fusedAreaDescription::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  fusedAreaDescription::parameters*
+  fusedAreaDescription::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  /*
+   * Write the parameters in the given ioHandler
+   */
+  bool fusedAreaDescription::parameters::write(ioHandler& handler,
+                                               const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"minThreshold",minThreshold) && b;
+      b = lti::write(handler,"maxThreshold",maxThreshold) && b;
+      b = lti::write(handler,"fourNeighborhood",fourNeighborhood) && b;
+      b = lti::write(handler,"minimumObjectSize",minimumObjectSize) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  /*
+   * Read the parameters from the given ioHandler
+   */
+  bool fusedAreaDescription::parameters::read(ioHandler& handler,
+                                              const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"minThreshold",minThreshold) && b;
+      b = lti::read(handler,"maxThreshold",maxThreshold) && b;
+      b = lti::read(handler,"fourNeighborhood",fourNeighborhood) && b;
+      b = lti::read(handler,"minimumObjectSize",minimumObjectSize) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // fusedAreaDescription::scanner
+  // --------------------------------------------------
+
+  /*
+   * The scanner receives the object flags of one row at a time.  It
+   * keeps the runs of the previous row with their provisional labels, a
+   * union-find forest of all provisional labels and the accumulated
+   * descriptor of each of them.  Roots are always the smallest label of
+   * their tree, i.e. the one first found in the raster scan.
+   */
+  class fusedAreaDescription::scanner {
+  public:
+    /**
+     * Construct a scanner for rows with the given number of columns
+     */
+    scanner(const int columns,const bool fourNeighborhood)
+      : columns_(columns), reach_(fourNeighborhood ? 0 : 1) {
+      prev_.reserve(columns/2+1);
+      curr_.reserve(columns/2+1);
+    }
+
+    /**
+     * Add the row y, where flags[x] != 0 marks object pixels
+     */
+    void addRow(const ubyte* flags,const int y) {
+      curr_.clear();
+
+      std::vector<run>::const_iterator pit = prev_.begin();
+      const std::vector<run>::const_iterator pend = prev_.end();
+
+      int x=0;
+      while (x<columns_) {
+        // skip the background
+        while ((x<columns_) && (flags[x]==0)) {
+          ++x;
+        }
+        if (x>=columns_) {
+          break;
+        }
+        run r;
+        r.from = x;
+        while ((x<columns_) && (flags[x]!=0)) {
+          ++x;
+        }
+        r.to = x-1;
+
+        // runs of the previous row touching this one
+        const int first = r.from - reach_;
+        const int last  = r.to + reach_;
+        while ((pit!=pend) && (pit->to < first)) {
+          ++pit;
+        }
+
+        r.label = -1;
+        for (std::vector<run>::const_iterator it=pit;
+             (it!=pend) && (it->from <= last);
+             ++it) {
+          r.label = (r.label<0) ? find(it->label) : merge(r.label,it->label);
+        }
+
+        if (r.label<0) {
+          r.label = static_cast<int>(parent_.size());
+          parent_.push_back(r.label);
+          acc_.push_back(accumulator());
+        }
+
+        acc_[r.label].add(r.from,r.to,y);
+        curr_.push_back(r);
+      }
+
+      prev_.swap(curr_);
+    }
+
+    /**
+     * Produce the descriptors of all objects with at least minSize pixels
+     */
+    void getDescriptors(const int minSize,
+                        std::vector<areaDescriptor>& desc) const {
+      desc.clear();
+      for (unsigned int i=0;i<parent_.size();++i) {
+        if (parent_[i] != static_cast<int>(i)) {
+          continue;
+        }
+        const accumulator& a = acc_[i];
+        if (a.area < minSize) {
+          continue;
+        }
+        areaDescriptor d;
+        d.area = a.area;
+        d.cog.x = static_cast<float>(a.sumX/a.area);
+        d.cog.y = static_cast<float>(a.sumY/a.area);
+        d.minX = a.minX;
+        d.maxX = a.maxX;
+        d.minY = a.minY;
+        d.maxY = a.maxY;
+        desc.push_back(d);
+      }
+    }
+
+  protected:
+    /**
+     * Horizontal run of object pixels in one row
+     */
+    struct run {
+      int from;
+      int to;
+      int label;
+    };
+
+    /**
+     * Accumulated area descriptor of one provisional label
+     */
+    struct accumulator {
+      int area;
+      double sumX;
+      double sumY;
+      ipoint minX;
+      ipoint maxX;
+      ipoint minY;
+      ipoint maxY;
+
+      accumulator() : area(0),sumX(0.0),sumY(0.0) {
+      }
+
+      /**
+       * Add the run [from,to] of row y
+       */
+      void add(const int from,const int to,const int y) {
+        const int n = to-from+1;
+        if (area==0) {
+          minX.set(from,y);
+          maxX.set(to,y);
+          minY.set(from,y);
+          maxY.set(from,y);
+        } else {
+          // rows arrive in order and runs from left to right, so minY
+          // never changes and the ties keep the upper or leftmost point
+          if (from < minX.x) {
+            minX.set(from,y);
+          }
+          if (to > maxX.x) {
+            maxX.set(to,y);
+          }
+          if (y > maxY.y) {
+            maxY.set(from,y);
+          }
+        }
+        area += n;
+        sumX += 0.5*static_cast<double>(n)*(from+to);
+        sumY += static_cast<double>(n)*y;
+      }
+
+      /**
+       * Add the other accumulator, keeping the points with smaller y (or
+       * smaller x for minY and maxY) on ties
+       */
+      void add(const accumulator& other) {
+        if ((other.minX.x < minX.x) ||
+            ((other.minX.x == minX.x) && (other.minX.y < minX.y))) {
+          minX = other.minX;
+        }
+        if ((other.maxX.x > maxX.x) ||
+            ((other.maxX.x == maxX.x) && (other.maxX.y < maxX.y))) {
+          maxX = other.maxX;
+        }
+        if ((other.minY.y < minY.y) ||
+            ((other.minY.y == minY.y) && (other.minY.x < minY.x))) {
+          minY = other.minY;
+        }
+        if ((other.maxY.y > maxY.y) ||
+            ((other.maxY.y == maxY.y) && (other.maxY.x < maxY.x))) {
+          maxY = other.maxY;
+        }
+        area += other.area;
+        sumX += other.sumX;
+        sumY += other.sumY;
+      }
+    };
+
+    /**
+     * Root of the given label, halving the path on the way
+     */
+    int find(int label) {
+      while (parent_[label] != label) {
+        parent_[label] = parent_[parent_[label]];
+        label = parent_[label];
+      }
+      return label;
+    }
+
+    /**
+     * Join the trees of both labels and return the new root
+     */
+    int merge(const int a,const int b) {
+      int ra = find(a);
+      int rb = find(b);
+      if (ra == rb) {
+        return ra;
+      }
+      if (rb < ra) {
+        const int tmp = ra;
+        ra = rb;
+        rb = tmp;
+      }
+      parent_[rb] = ra;
+      acc_[ra].add(acc_[rb]);
+      return ra;
+    }
+
+    /**
+     * Number of columns of each row
+     */
+    const int columns_;
+
+    /**
+     * Horizontal reach of the connectivity: 0 for 4 and 1 for 8 neighbors
+     */
+    const int reach_;
+
+    /**
+     * Runs of the previous and the current row
+     */
+    std::vector<run> prev_,curr_;
+
+    /**
+     * Union-find forest of the provisional labels
+     */
+    std::vector<int> parent_;
+
+    /**
+     * Accumulated descriptors, valid for the roots only
+     */
+    std::vector<accumulator> acc_;
+  };
+
+  // --------------------------------------------------
+  // fusedAreaDescription
+  // --------------------------------------------------
+
+  // default constructor
+  fusedAreaDescription::fusedAreaDescription()
+    : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
+  }
+
+  // default constructor
+  fusedAreaDescription::fusedAreaDescription(const parameters& par)
+    : functor() {
+    setParameters(par);
+  }
+
+  // copy constructor
+  fusedAreaDescription::fusedAreaDescription(const fusedAreaDescription& o)
+    : functor() {
+    copy(o);
+  }
+
+  // destructor
+  fusedAreaDescription::~fusedAreaDescription() {
+  }
+
+  // copy member
+  fusedAreaDescription&
+  fusedAreaDescription::copy(const fusedAreaDescription& other) {
+    functor::copy(other);
+    return (*this);
+  }
+
+  // alias for copy member
+  fusedAreaDescription&
+  fusedAreaDescription::operator=(const fusedAreaDescription& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& fusedAreaDescription::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  fusedAreaDescription* fusedAreaDescription::clone() const {
+    return new fusedAreaDescription(*this);
+  }
+
+  // create a new instance
+  fusedAreaDescription* fusedAreaDescription::newInstance() const {
+    return new fusedAreaDescription();
+  }
+
+  // return parameters
+  const fusedAreaDescription::parameters&
+  fusedAreaDescription::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool fusedAreaDescription::apply(const channel8& src,
+                                   std::vector<areaDescriptor>& desc) const {
+    const parameters& par = getParameters();
+
+    // which of the 256 values belong to the objects
+    ubyte lut[256];
+    for (int i=0;i<256;++i) {
+      const float v = static_cast<float>(i)/255.0f;
+      lut[i] = ((v >= par.minThreshold) && (v <= par.maxThreshold)) ? 1 : 0;
+    }
+
+    scanner scan(src.columns(),par.fourNeighborhood);
+    std::vector<ubyte> flags(src.columns()+1);
+
+    for (int y=0;y<src.rows();++y) {
+      const vector<ubyte>& row = src.getRow(y);
+      for (int x=0;x<src.columns();++x) {
+        flags[x] = lut[row.at(x)];
+      }
+      scan.addRow(&flags[0],y);
+    }
+
+    scan.getDescriptors(par.minimumObjectSize,desc);
+    return true;
+  }
+
+  bool fusedAreaDescription::apply(const channel& src,
+                                   std::vector<areaDescriptor>& desc) const {
+    const parameters& par = getParameters();
+    const float lo = par.minThreshold;
+    const float hi = par.maxThreshold;
+
+    scanner scan(src.columns(),par.fourNeighborhood);
+    std::vector<ubyte> flags(src.columns()+1);
+
+    for (int y=0;y<src.rows();++y) {
+      const vector<float>& row = src.getRow(y);
+      for (int x=0;x<src.columns();++x) {
+        const float v = row.at(x);
+        flags[x] = ((v >= lo) && (v <= hi)) ? 1 : 0;
+      }
+      scan.addRow(&flags[0],y);
+    }
+
+    scan.getDescriptors(par.minimumObjectSize,desc);
+    return true;
+  }
+
+}
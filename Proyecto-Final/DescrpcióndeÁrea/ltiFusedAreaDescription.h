@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiFusedAreaDescription.h
+ *         Thresholding, labeling and area description of a channel in a
+ *         single scan, without any intermediate mask.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_FUSED_AREA_DESCRIPTION_H_
+#define _LTI_FUSED_AREA_DESCRIPTION_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+#include "ltiAreaDescriptor.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Fused area description.
+   *
+   * Counting particles usually means thresholding the image into a mask,
+   * writing the mask, and reading it again with lti::fastAreaDescription
+   * to label it and compute the lti::areaDescriptor of each region.  This
+   * functor does all three in one scan of the input: each row is
+   * thresholded into a buffer of one row, its runs of object pixels are
+   * connected to the runs of the previous row with a union-find structure
+   * of provisional labels, and each run is immediately added to the
+   * descriptor of its label.  When two labels meet, their descriptors are
+   * merged.  Only the labels of the previous row are kept, so that no
+   * full-size mask or label image is ever written.
+   *
+   * A pixel belongs to an object if its value (divided by 255 for a
+   * channel8) lies in [parameters::minThreshold, parameters::maxThreshold].
+   * The descriptors are returned in the order in which the objects are
+   * first found in a raster scan, as the labels of lti::fastAreaDescription.
+   *
+   * Example:
+   * \code
+   * lti::fusedAreaDescription::parameters par;
+   * par.minThreshold = 0.6f;
+   * lti::fusedAreaDescription particles(par);
+   * std::vector<lti::areaDescriptor> desc;
+   * particles.apply(chnl8,desc);
+   * std::cout << desc.size() << " particles" << std::endl;
+   * \endcode
+   */
+  class fusedAreaDescription : public functor {
+  public:
+    /**
+     * The parameters for the class fusedAreaDescription
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Lowest value of the object pixels, in [0,1].
+       *
+       * Default value: 0.5
+       */
+      float minThreshold;
+
+      /**
+       * Highest value of the object pixels, in [0,1].
+       *
+       * Default value: 1
+       */
+      float maxThreshold;
+
+      /**
+       * If true, only the horizontal and vertical neighbors are connected,
+       * otherwise also the diagonal ones.
+       *
+       * Default value: true
+       */
+      bool fourNeighborhood;
+
+      /**
+       * Objects with fewer pixels are not reported.
+       *
+       * Default value: 1
+       */
+      int minimumObjectSize;
+    };
+
+    /**
+     * Default constructor
+     */
+    fusedAreaDescription();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    fusedAreaDescription(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    fusedAreaDescription(const fusedAreaDescription& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~fusedAreaDescription();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    fusedAreaDescription& copy(const fusedAreaDescription& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    fusedAreaDescription& operator=(const fusedAreaDescription& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual fusedAreaDescription* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual fusedAreaDescription* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Threshold and describe the objects of the given channel8.
+     *
+     * @param src the channel
+     * @param desc the descriptor of each object
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel8& src,std::vector<areaDescriptor>& desc) const;
+
+    /**
+     * Threshold and describe the objects of the given channel.
+     *
+     * @param src the channel
+     * @param desc the descriptor of each object
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& src,std::vector<areaDescriptor>& desc) const;
+
+  protected:
+    /**
+     * Labels and descriptors being accumulated during the scan
+     */
+    class scanner;
+  };
+
+}
+
+#endif
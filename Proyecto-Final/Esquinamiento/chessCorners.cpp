@@ -19,10 +19,15 @@ typedef lti::viewer2D viewer_type;
 typedef lti::externViewer2D viewer_type;
 #endif
 
-#include "ltiV4l2.h"
+#include "chessCorners.h"
+#include "ltiThread.h"
+#include "ltiTimer.h"
+#include "ltiPassiveWait.h"
+#include "ltiTripleBuffer.h"
 
 // Standard Headers
 #include <cstdlib>
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <fstream>
@@ -32,11 +37,250 @@ using std::cerr;
 using std::endl;
 
 
+// ---------------------------------------------------------------------------
+// source
+// ---------------------------------------------------------------------------
+
+/*
+ * Decodes the files of the Replay input ahead, into the buffers returned
+ * through the empty queue.  Pushes a null pointer after the last file, or
+ * when asked to finish.
+ */
+class source::prefetcher : public lti::thread {
+public:
+  prefetcher(const std::list<std::string>& files,
+             const int loops,
+             lti::boundedQueue<lti::image*>& empty,
+             lti::boundedQueue<lti::image*>& decoded)
+    : files_(files),loops_(loops),empty_(empty),decoded_(decoded),
+      stop_(false) {
+  }
+
+  /**
+   * Ask the thread to finish after the current file
+   */
+  void finish() {
+    stop_ = true;
+  }
+
+  /**
+   * Status of the loader if a file could not be decoded
+   */
+  const std::string& error() const {
+    return error_;
+  }
+
+protected:
+  virtual void run() {
+    lti::ioImage loader;
+    lti::image* buffer;
+    for (int l=0;(loops_ <= 0 || l<loops_) && !stop_;++l) {
+      std::list<std::string>::const_iterator it;
+      for (it=files_.begin();it!=files_.end() && !stop_;++it) {
+        empty_.pop(buffer);
+        if (stop_) {
+          empty_.push(buffer);
+          break;
+        }
+        if (!loader.load(*it,*buffer)) {
+          error_ = *it + ": " + loader.getStatusString();
+          empty_.push(buffer);
+          stop_ = true;
+          break;
+        }
+        decoded_.push(buffer);
+      }
+    }
+    decoded_.push(0);
+  }
+
+private:
+  const std::list<std::string>& files_;
+  const int loops_;
+  lti::boundedQueue<lti::image*>& empty_;
+  lti::boundedQueue<lti::image*>& decoded_;
+  volatile bool stop_;
+  std::string error_;
+};
+
+source::source(const eInput src,
+               const std::list<std::string>& files,
+               const float frameRate,
+               const int prefetch,
+               const int loops)
+  : lti::status(),
+#ifdef _USE_V4L2
+    v4l2_(0),
+#endif
+    files_(files),input_(src),prefetcher_(0),empty_(0),decoded_(0),
+    period_(frameRate > 0.0f ? 1000000.0/frameRate : 0.0),due_(0.0) {
+
+  fileIterator_ = files_.begin();
+
+  switch (input_) {
+  case V4L2:
+#ifdef _USE_V4L2
+    v4l2_ = new lti::v4l2(lti::v4l2::parameters());
+#else
+    setStatusString("No camera support found");
+#endif
+    break;
+  case Replay: {
+    const int n = (prefetch > 0) ? prefetch : 1;
+    frames_.resize(n);
+    empty_ = new lti::boundedQueue<lti::image*>(n);
+    // one more slot for the final null pointer
+    decoded_ = new lti::boundedQueue<lti::image*>(n+1);
+    for (int i=0;i<n;++i) {
+      empty_->push(&frames_[i]);
+    }
+    prefetcher_ = new prefetcher(files_,loops,*empty_,*decoded_);
+    prefetcher_->start();
+    clock_.start();
+  } break;
+  default:
+    break;
+  }
+}
+
+#ifdef _USE_V4L2
+source::source(const lti::v4l2::parameters& par)
+  : lti::status(),v4l2_(new lti::v4l2(par)),input_(V4L2),
+    prefetcher_(0),empty_(0),decoded_(0),period_(0.0),due_(0.0) {
+  fileIterator_ = files_.begin();
+}
+#endif
+
+source::~source() {
+  if (prefetcher_ != 0) {
+    // return the decoded frames until the prefetcher gives up, unless it
+    // already did
+    prefetcher_->finish();
+    lti::image* buffer;
+    do {
+      decoded_->pop(buffer);
+      if (buffer != 0) {
+        empty_->push(buffer);
+      }
+    } while (buffer != 0);
+    prefetcher_->join();
+    delete prefetcher_;
+  }
+  delete decoded_;
+  delete empty_;
+#ifdef _USE_V4L2
+  delete v4l2_;
+#endif
+}
+
+void source::dump() {
+#ifdef _USE_V4L2
+  if (v4l2_ != 0) {
+    lti::lispStreamHandler lsh;
+    lsh.use(cout);
+    v4l2_->getParameters().write(lsh);
+    cout << endl;
+  }
+#endif
+}
+
+bool source::next(lti::image& img) {
+  switch (input_) {
+  case Files:
+    return nextImage(img);
+  case V4L2:
+    return nextV4l2(img);
+  case Replay:
+    return nextReplay(img);
+  default:
+    break;
+  }
+  return false;
+}
+
+bool source::next(lti::channel8& chnl) {
+  if (next(buffer_)) {
+    chnl.castFrom(buffer_);
+    return true;
+  }
+  return false;
+}
+
+bool source::nextImage(lti::image& img) {
+  if (fileIterator_ == files_.end()) {
+    setStatusString("End of the image sequence");
+    return false;
+  }
+  lti::ioImage loader;
+  if (!loader.load(*fileIterator_,img)) {
+    setStatusString(*fileIterator_ + ": " + loader.getStatusString());
+    return false;
+  }
+  ++fileIterator_;
+  return true;
+}
+
+bool source::nextV4l2(lti::image& img) {
+#ifdef _USE_V4L2
+  if (v4l2_ != 0) {
+    if (v4l2_->apply(img)) {
+      return true;
+    }
+    setStatusString(v4l2_->getStatusString());
+  }
+#endif
+  return false;
+}
+
+bool source::nextReplay(lti::image& img) {
+  if (decoded_ == 0) {
+    return false;
+  }
+
+  lti::image* buffer;
+  decoded_->pop(buffer);
+  if (buffer == 0) {
+    // the prefetcher ended: release it, so that the destructor does not
+    // wait for another null pointer
+    prefetcher_->join();
+    if (prefetcher_->error().empty()) {
+      setStatusString("End of the image sequence");
+    } else {
+      setStatusString(prefetcher_->error());
+    }
+    delete prefetcher_;
+    prefetcher_ = 0;
+    delete decoded_;
+    decoded_ = 0;
+    return false;
+  }
+
+  if (period_ > 0.0) {
+    // deliver at due_, which advances by whole periods so that a late
+    // frame does not delay all the following ones
+    const double now = clock_.getTime();
+    if (due_ > now) {
+      lti::passiveWait(static_cast<int>(due_ - now));
+      due_ += period_;
+    } else {
+      due_ = now + period_;
+    }
+  }
+
+  img.swap(*buffer);
+  empty_->push(buffer);
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// tool
+// ---------------------------------------------------------------------------
+
 /*
  * Help 
  */
 void usage() {
-  cout << "Usage: chessCorners [options]  image [-h]" << endl;
+  cout << "Usage: chessCorners [options] image... [-h]" << endl;
   cout << "Find chess features in the given image or in from the given ";
   cout << "camera device.\n";
   cout << "The file \"chess.dat\" allows to configure the ";
@@ -44,17 +288,28 @@ void usage() {
   cout << "  -h show this help." << endl;
   cout << "  -c use camera input instead of file (give the device file if \n"
        << "     needed, such as /dev/video1" << endl;
+  cout << "  -r <fps> replay the given images as if they were camera frames,\n"
+       << "     at the given frame rate (0: as fast as they are processed)"
+       << endl;
+  cout << "  -l <n> play the images n times in replay mode (0: forever)"
+       << endl;
 }
 
 /*
  * Parse the line command arguments
  */
 void parseArgs(int argc, char*argv[], 
-               std::string& filename,
-	       bool& camera) {
+               std::list<std::string>& files,
+	       bool& camera,
+               bool& replay,
+               float& frameRate,
+               int& loops) {
   
   camera=false;
-  filename.clear();
+  replay=false;
+  frameRate=0.0f;
+  loops=1;
+  files.clear();
   // check each argument of the command line
   for (int i=1; i<argc; i++) {
     if (*argv[i] == '-') {
@@ -66,6 +321,17 @@ void parseArgs(int argc, char*argv[],
       case 'c':
 	camera=true;
 	break;
+      case 'r':
+        replay=true;
+        if (i+1<argc) {
+          frameRate=static_cast<float>(atof(argv[++i]));
+        }
+        break;
+      case 'l':
+        if (i+1<argc) {
+          loops=atoi(argv[++i]);
+        }
+        break;
       case '-':
 	if (std::string(argv[i]) == "--help") {
 	  usage();
@@ -76,20 +342,75 @@ void parseArgs(int argc, char*argv[],
 	break;
       }
     } else {
-      filename = argv[i]; // guess that this is the filename
+      files.push_back(argv[i]); // guess that this is a filename
     }
   }
 
 }
 
+/**
+ * Captures the frames of the source in its own thread, so that the capture
+ * never waits for the detection.  Each frame is published in a triple
+ * buffer, from which the main loop always takes the newest one; the frames
+ * that arrive while the previous one is still untaken are dropped.
+ */
+class captureThread : public lti::thread {
+public:
+  captureThread(source& src,lti::tripleBuffer<lti::channel8>& frames)
+    : src_(src),frames_(frames),stop_(false),failed_(false) {
+  }
+
+  /**
+   * Ask the thread to finish after the current frame
+   */
+  void finish() {
+    stop_ = true;
+  }
+
+  /**
+   * True if the source failed or ended, and the thread ended
+   */
+  bool failed() const {
+    return failed_;
+  }
+
+  /**
+   * Status of the source after it failed or ended
+   */
+  const std::string& error() const {
+    return error_;
+  }
+
+protected:
+  virtual void run() {
+    while (!stop_) {
+      if (!src_.next(frames_.back())) {
+        error_ = src_.getStatusString();
+        failed_ = true;
+        return;
+      }
+      frames_.publish();
+    }
+  }
+
+private:
+  source& src_;
+  lti::tripleBuffer<lti::channel8>& frames_;
+  volatile bool stop_;
+  volatile bool failed_;
+  std::string error_;
+};
+
 /*
  * Main method
  */
 int main(int argc, char* argv[]) {
 
-  std::string file;
-  bool camera;
-  parseArgs(argc,argv,file,camera);
+  std::list<std::string> files;
+  bool camera,replay;
+  float frameRate;
+  int loops;
+  parseArgs(argc,argv,files,camera,replay,frameRate,loops);
 
   static const char* confFile = "chess.dat";
 
@@ -121,7 +442,7 @@ int main(int argc, char* argv[]) {
   lti::localExtremes ext(lePar);
   lePar.relativeThreshold = 0.5;
 
-  if (!camera && file.empty()) {
+  if (!camera && files.empty()) {
     usage();
     return EXIT_SUCCESS;
   }
@@ -140,68 +461,140 @@ int main(int argc, char* argv[]) {
   
 
 
-  if (camera) {
+  if (camera || replay) {
+    source* src = 0;
+    if (camera) {
 #ifndef _USE_V4L2
-    std::cout << "No camera support found" << std::endl;
-    return EXIT_FAILURE;
+      std::cout << "No camera support found" << std::endl;
+      return EXIT_FAILURE;
 #else
-    static const char* camFile = "v4l2.dat";
-    std::ifstream in(camFile);
-    lti::v4l2::parameters vparam;
-
-    bool write=true;
-    if (in) {
-      lti::lispStreamHandler lsh;
-      lsh.use(in);
-      write=!vparam.read(lsh);
-      in.close();
+      static const char* camFile = "v4l2.dat";
+      std::ifstream in(camFile);
+      lti::v4l2::parameters vparam;
+
+      bool write=true;
+      if (in) {
+        lti::lispStreamHandler lsh;
+        lsh.use(in);
+        write=!vparam.read(lsh);
+        in.close();
+      }
+
+      // check if user specified a device
+      if (!files.empty()) {
+        vparam.deviceFile=files.front();
+      }
+
+      if (write) {
+        // something went wrong reading, write a new configuration file
+        std::ofstream out(camFile);
+        lti::lispStreamHandler lsh;
+        lsh.use(out);
+        vparam.write(lsh);
+        out.close();
+      }    
+
+      src = new source(vparam);
+#endif
+    } else {
+      src = new source(source::Replay,files,frameRate,4,loops);
     }
 
-    // check if user specified a device
-    if (!file.empty()) {
-      vparam.deviceFile=file;
+    // A camera, or a replay at a given frame rate, is captured in its own
+    // thread and the frames not taken in time are dropped.  An unthrottled
+    // replay is read directly, so that every frame is processed.
+    const bool live = camera || (frameRate > 0.0f);
+    lti::tripleBuffer<lti::channel8> frames;
+    captureThread capture(*src,frames);
+    if (live) {
+      capture.start();
     }
 
-    if (write) {
-      // something went wrong reading, write a new configuration file
-      std::ofstream out(camFile);
-      lti::lispStreamHandler lsh;
-      lsh.use(out);
-      vparam.write(lsh);
-      out.close();
-    }    
-
-    // camera
-    lti::v4l2 cam(vparam);
-    
+    lti::timer chrono;
+    chrono.start();
+    double lastReport = 0.0;
+    int lastPublished = 0;
+    int lastDropped = 0;
+    int processed = 0;
+    int lastProcessed = 0;
+    bool running = true;
+
     do {
-      if (cam.apply(chnl)) {
-        
-	detector.apply(chnl,cornerness);
+      const lti::channel8* frame = 0;
+      if (live) {
+        if (frames.take()) {
+          frame = &frames.front();
+        } else if (capture.failed()) {
+          // the last frame may have been published after the take() above
+          if (frames.take()) {
+            frame = &frames.front();
+          }
+          std::cerr << "Capture stopped: " << capture.error() << std::endl;
+          running = false;
+        } else {
+          // the next frame is still being captured
+          lti::passiveWait(1000);
+        }
+      } else if (src->next(chnl)) {
+        frame = &chnl;
+      } else {
+        std::cerr << "Capture stopped: " << src->getStatusString()
+                  << std::endl;
+        running = false;
+      }
+
+      if (frame != 0) {
+	detector.apply(*frame,cornerness);
         ext.apply(cornerness,corners);
 
 	// paint the corners
-	canvas.castFrom(chnl);
+	canvas.castFrom(*frame);
     
 	for (it=corners.begin();it!=corners.end();++it) {
 	  painter.setColor(lti::rgbaPixel(255,192,100));
 	  painter.marker(*it,"x");
 	}
 	
-	viewo.show(chnl);
+	viewo.show(*frame);
         viewc.show(cornerness);
 	viewm.show(canvas);
-      } else {
-	std::cerr << "Camera error: " << cam.getStatusString() << std::endl;
-	camera=false;
+        ++processed;
       }
-    } while(camera);
-#endif  
+
+      // rates of the last second
+      const double now = chrono.getTime();
+      if (now - lastReport >= 1000000.0) {
+        const double secs = (now - lastReport)/1000000.0;
+        const int published = live ? frames.published() : processed;
+        const int dropped = frames.dropped();
+        std::cout << "Capture " << (published-lastPublished)/secs
+                  << " fps, processing " << (processed-lastProcessed)/secs
+                  << " fps, dropped " << dropped-lastDropped
+                  << " (total " << dropped << ")" << std::endl;
+        lastReport = now;
+        lastPublished = published;
+        lastDropped = dropped;
+        lastProcessed = processed;
+      }
+    } while(running);
+
+    if (live) {
+      capture.finish();
+      capture.join();
+    }
+
+    const double secs = chrono.getTime()/1000000.0;
+    if (secs > 0.0) {
+      std::cout << processed << " frames processed in " << secs << " s ("
+                << processed/secs << " fps), "
+                << frames.dropped() << " dropped" << std::endl;
+    }
+    delete src;
   } else {
     lti::ioImage loader;
     lti::image img;
 
-    if (!loader.load(file,img)) {
+    if (!loader.load(files.front(),img)) {
       std::cout << loader.getStatusString() << std::endl;
       return EXIT_FAILURE;
     }
@@ -49,43 +49,69 @@
 #ifndef COLOR_PROBABILITY
 #define COLOR_PROBABILITY
 
-#define _WITH_V4L2
-
 
 #include <string>
 #include <list>
+#include <vector>
 #include <ltiLispStreamHandler.h>
 #include <ltiColorModelEstimation.h>
 #include <ltiColorProbabilityMap.h>
 #include <ltiHistogram.h>
+#include <ltiImage.h>
+#include <ltiChannel8.h>
+#include <ltiIOImage.h>
+#include <ltiStatus.h>
+#include <ltiTimer.h>
 
-#ifdef _WITH_V4L2
+#include "ltiConfig.h"
 #include "ltiV4l2.h"
-#endif
+#include "ltiBoundedQueue.h"
 
 /**
  * Abstraction class to wrap whether a camera data source, or a list of files.
+ *
+ * The Replay input plays the list of files as if it came from a camera: a
+ * thread decodes the next images ahead into a few recycled buffers, while
+ * next() delivers them at a given frame rate, or as fast as they are
+ * consumed.  This allows to benchmark the camera path of a tool on a
+ * machine without camera, always with the same frames.
  */
-class source {
+class source : public lti::status {
 public:
   /**
    * Which input should be used
    */
   enum eInput {
-    Files,
-    V4L2
+    Files, /**< Each file read when requested */
+    V4L2,  /**< Video for Linux camera */
+    Replay /**< Files prefetched and delivered at a frame rate */
   };
 
   /**
    * Constructor
+   *
+   * @param src input type.  V4L2 uses the default camera parameters.
+   * @param files image files of the Files and Replay inputs
+   * @param frameRate frames per second of the Replay input, or zero to
+   *                  deliver each frame as soon as it is requested
+   * @param prefetch number of frames decoded ahead by the Replay input
+   * @param loops number of times the Replay input plays the files
    */
   source(const eInput src,
-         const std::list<std::string>& files = std::list<std::string>() );
+         const std::list<std::string>& files = std::list<std::string>(),
+         const float frameRate = 0.0f,
+         const int prefetch = 4,
+         const int loops = 1);
+
+#ifdef _USE_V4L2
+  /**
+   * Constructor for a V4L2 camera with the given parameters
+   */
+  source(const lti::v4l2::parameters& par);
+#endif
 
   /**
-   * Destructor
-   * Saves camera parameters in case an external application like guvcview 
-   * changed them
+   * Destructor.  Stops the prefetching of the Replay input.
    */
   ~source();
 
@@ -98,9 +124,18 @@ public:
    * Capture the next image
    *
    * @return \c true if a next image could be read or \c false if an error or
+   *         the end of the files occurred (see getStatusString())
    */
   bool next(lti::image& img);
 
+  /**
+   * Capture the next image as gray values
+   *
+   * @return \c true if a next image could be read or \c false if an error or
+   *         the end of the files occurred (see getStatusString())
+   */
+  bool next(lti::channel8& chnl);
+
 private:
   /**
    * Get next image from file
@@ -111,8 +146,13 @@ private:
    * Get next image from camera
    */
   bool nextV4l2(lti::image& img);
+
+  /**
+   * Get next prefetched image, waiting for its time
+   */
+  bool nextReplay(lti::image& img);
   
-#ifdef _WITH_V4L2
+#ifdef _USE_V4L2
   /**
    * Camera reading class
    */
@@ -133,6 +173,52 @@ private:
    * Type of image input
    */
   eInput input_;
+
+  /**
+   * Image read by next(lti::channel8&)
+   */
+  lti::image buffer_;
+
+  /**
+   * Thread of the Replay input decoding the files ahead
+   */
+  class prefetcher;
+
+  /**
+   * The prefetching thread, or null
+   */
+  prefetcher* prefetcher_;
+
+  /**
+   * Frames of the Replay input, recycled through the empty and decoded
+   * queues.  A null pointer in the decoded queue ends the replay.
+   */
+  //@{
+  std::vector<lti::image> frames_;
+  lti::boundedQueue<lti::image*>* empty_;
+  lti::boundedQueue<lti::image*>* decoded_;
+  //@}
+
+  /**
+   * Microseconds between frames of the Replay input, or zero
+   */
+  double period_;
+
+  /**
+   * Time of the next frame of the Replay input
+   */
+  double due_;
+
+  /**
+   * Clock of the Replay input
+   */
+  lti::timer clock_;
+
+  /**
+   * Disable copy
+   */
+  source(const source&);
+  source& operator=(const source&);
 };
 
 /**
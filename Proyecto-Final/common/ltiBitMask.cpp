@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiBitMask.cpp
+ *         Binary mask with one bit per pixel.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiBitMask.h"
+
+namespace lti {
+
+  /*
+   * Number of bits set in a word
+   */
+  static inline int popcount(const bitMask::word w) {
+#if defined(__GNUC__)
+    return __builtin_popcountl(w);
+#else
+    int n = 0;
+    for (bitMask::word v = w;v != 0;v &= v-1) {
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  bitMask::bitMask()
+    : object(),rows_(0),columns_(0),words_(0) {
+  }
+
+  bitMask::bitMask(const int rows,const int columns,const bool value)
+    : object(),rows_(0),columns_(0),words_(0) {
+    assign(rows,columns,value);
+  }
+
+  bitMask::bitMask(const bitMask& other)
+    : object() {
+    copy(other);
+  }
+
+  bitMask::~bitMask() {
+  }
+
+  bitMask& bitMask::copy(const bitMask& other) {
+    rows_ = other.rows_;
+    columns_ = other.columns_;
+    words_ = other.words_;
+    data_ = other.data_;
+    return *this;
+  }
+
+  bitMask& bitMask::operator=(const bitMask& other) {
+    return copy(other);
+  }
+
+  const std::string& bitMask::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  bitMask* bitMask::clone() const {
+    return new bitMask(*this);
+  }
+
+  bitMask* bitMask::newInstance() const {
+    return new bitMask();
+  }
+
+  void bitMask::allocate(const int rows,const int columns) {
+    if ((rows <= 0) || (columns <= 0)) {
+      clear();
+      return;
+    }
+    rows_ = rows;
+    columns_ = columns;
+    words_ = (columns+BitsPerWord-1)/BitsPerWord;
+    data_.assign(rows_*words_,static_cast<word>(0));
+  }
+
+  void bitMask::assign(const int rows,const int columns,const bool value) {
+    allocate(rows,columns);
+    fill(value);
+  }
+
+  void bitMask::fill(const bool value) {
+    data_.assign(data_.size(),value ? ~static_cast<word>(0) :
+                                      static_cast<word>(0));
+    if (value) {
+      clearPadding();
+    }
+  }
+
+  void bitMask::clear() {
+    rows_ = columns_ = words_ = 0;
+    data_.clear();
+  }
+
+  void bitMask::clearPadding() {
+    const int used = columns_%BitsPerWord;
+    if (used == 0) {
+      return;
+    }
+    const word keep = (static_cast<word>(1) << used) - 1;
+    for (int y=0;y<rows_;++y) {
+      data_[(y+1)*words_-1] &= keep;
+    }
+  }
+
+  bitMask& bitMask::bitwiseAnd(const bitMask& other) {
+    if (!sameSize(other)) {
+      return *this;
+    }
+    const int n = static_cast<int>(data_.size());
+    for (int i=0;i<n;++i) {
+      data_[i] &= other.data_[i];
+    }
+    return *this;
+  }
+
+  bitMask& bitMask::bitwiseAnd(const bitMask& a,const bitMask& b) {
+    if (!a.sameSize(b)) {
+      return *this;
+    }
+    if (&b == this) {
+      return bitwiseAnd(a);
+    }
+    copy(a);
+    return bitwiseAnd(b);
+  }
+
+  bitMask& bitMask::bitwiseOr(const bitMask& other) {
+    if (!sameSize(other)) {
+      return *this;
+    }
+    const int n = static_cast<int>(data_.size());
+    for (int i=0;i<n;++i) {
+      data_[i] |= other.data_[i];
+    }
+    return *this;
+  }
+
+  bitMask& bitMask::bitwiseOr(const bitMask& a,const bitMask& b) {
+    if (!a.sameSize(b)) {
+      return *this;
+    }
+    if (&b == this) {
+      return bitwiseOr(a);
+    }
+    copy(a);
+    return bitwiseOr(b);
+  }
+
+  bitMask& bitMask::bitwiseXor(const bitMask& other) {
+    if (!sameSize(other)) {
+      return *this;
+    }
+    const int n = static_cast<int>(data_.size());
+    for (int i=0;i<n;++i) {
+      data_[i] ^= other.data_[i];
+    }
+    return *this;
+  }
+
+  bitMask& bitMask::invert() {
+    const int n = static_cast<int>(data_.size());
+    for (int i=0;i<n;++i) {
+      data_[i] = ~data_[i];
+    }
+    clearPadding();
+    return *this;
+  }
+
+  int bitMask::count() const {
+    const int n = static_cast<int>(data_.size());
+    int c = 0;
+    for (int i=0;i<n;++i) {
+      c += popcount(data_[i]);
+    }
+    return c;
+  }
+
+  int bitMask::count(const bitMask& other) const {
+    if (!sameSize(other)) {
+      return -1;
+    }
+    const int n = static_cast<int>(data_.size());
+    int c = 0;
+    for (int i=0;i<n;++i) {
+      c += popcount(data_[i] & other.data_[i]);
+    }
+    return c;
+  }
+
+  double bitMask::fraction() const {
+    if (empty()) {
+      return 0.0;
+    }
+    return count()/(static_cast<double>(rows_)*columns_);
+  }
+
+  bitMask& bitMask::castFrom(const channel8& src) {
+    allocate(src.rows(),src.columns());
+    for (int y=0;y<rows_;++y) {
+      const ubyte* p = &src.at(y,0);
+      word* w = row(y);
+      for (int x=0;x<columns_;x+=BitsPerWord,++w) {
+        const int n = (columns_-x < BitsPerWord) ? columns_-x : BitsPerWord;
+        word bits = 0;
+        for (int b=0;b<n;++b) {
+          bits |= static_cast<word>(p[x+b] != 0) << b;
+        }
+        *w = bits;
+      }
+    }
+    return *this;
+  }
+
+  bitMask& bitMask::castFrom(const channel8& src,const ubyte value) {
+    allocate(src.rows(),src.columns());
+    for (int y=0;y<rows_;++y) {
+      const ubyte* p = &src.at(y,0);
+      word* w = row(y);
+      for (int x=0;x<columns_;x+=BitsPerWord,++w) {
+        const int n = (columns_-x < BitsPerWord) ? columns_-x : BitsPerWord;
+        word bits = 0;
+        for (int b=0;b<n;++b) {
+          bits |= static_cast<word>(p[x+b] == value) << b;
+        }
+        *w = bits;
+      }
+    }
+    return *this;
+  }
+
+  void bitMask::castTo(channel8& dest,const ubyte off,const ubyte on) const {
+    dest.allocate(rows_,columns_);
+    for (int y=0;y<rows_;++y) {
+      ubyte* p = &dest.at(y,0);
+      const word* w = row(y);
+      for (int x=0;x<columns_;x+=BitsPerWord,++w) {
+        const int n = (columns_-x < BitsPerWord) ? columns_-x : BitsPerWord;
+        const word bits = *w;
+        for (int b=0;b<n;++b) {
+          p[x+b] = ((bits >> b) & static_cast<word>(1)) ? on : off;
+        }
+      }
+    }
+  }
+
+}
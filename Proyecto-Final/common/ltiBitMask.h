@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiBitMask.h
+ *         Binary mask with one bit per pixel.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_BIT_MASK_H_
+#define _LTI_BIT_MASK_H_
+
+#include "ltiObject.h"
+#include "ltiChannel8.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Binary mask packed with one bit per pixel.
+   *
+   * The masks of the thresholding and of the edge detectors are strictly
+   * binary, but a channel8 spends a byte per pixel on them (and an imatrix
+   * four).  This container keeps each row in machine words of 64 (or 32)
+   * pixels, so that a mask takes 8 to 32 times less memory, and the
+   * logical operations and the counting of set pixels work on whole words
+   * (the counting with the population count instruction where the
+   * compiler offers it).
+   *
+   * Each row starts at a new word, and the bits after the last column of a
+   * row are always zero, so that they never contribute to count().
+   *
+   * Example:
+   * \code
+   * lti::bitMask particles,edges;
+   * thresh.apply(particles);
+   * canny.apply(edges);
+   * particles.bitwiseAnd(edges);  // edge pixels of the particles
+   * std::cout << particles.fraction() << std::endl;
+   *
+   * lti::channel8 view;
+   * particles.castTo(view);       // 0 and 255 for the viewer
+   * \endcode
+   */
+  class bitMask : public object {
+  public:
+    /**
+     * Type of the words holding the bits
+     */
+    typedef unsigned long word;
+
+    /**
+     * Number of bits per word
+     */
+    static const int BitsPerWord = 8*sizeof(word);
+
+    /**
+     * Default constructor, creates an empty mask
+     */
+    bitMask();
+
+    /**
+     * Create a mask of the given size with all pixels set to \a value
+     */
+    bitMask(const int rows,const int columns,const bool value=false);
+
+    /**
+     * Copy constructor
+     */
+    bitMask(const bitMask& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~bitMask();
+
+    /**
+     * Copy the other mask
+     */
+    bitMask& copy(const bitMask& other);
+
+    /**
+     * Alias for copy()
+     */
+    bitMask& operator=(const bitMask& other);
+
+    /**
+     * Returns the name of this class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this mask
+     */
+    virtual bitMask* clone() const;
+
+    /**
+     * Returns a pointer to a new empty mask
+     */
+    virtual bitMask* newInstance() const;
+
+    /**
+     * Change the size of the mask.  The contents are undefined afterwards
+     * (but the bits after the last column are zero).
+     */
+    void allocate(const int rows,const int columns);
+
+    /**
+     * Change the size of the mask and set all pixels to \a value
+     */
+    void assign(const int rows,const int columns,const bool value);
+
+    /**
+     * Set all pixels to \a value
+     */
+    void fill(const bool value);
+
+    /**
+     * Remove all pixels
+     */
+    void clear();
+
+    /**
+     * Number of rows
+     */
+    inline int rows() const;
+
+    /**
+     * Number of columns
+     */
+    inline int columns() const;
+
+    /**
+     * Whether the mask has no pixels
+     */
+    inline bool empty() const;
+
+    /**
+     * Number of words of each row
+     */
+    inline int wordsPerRow() const;
+
+    /**
+     * Pixel at row \a y and column \a x
+     */
+    inline bool at(const int y,const int x) const;
+
+    /**
+     * Set the pixel at row \a y and column \a x
+     */
+    inline void set(const int y,const int x,const bool value);
+
+    /**
+     * First word of the row \a y.  The pixel of column \a x is the bit
+     * (x % BitsPerWord) of the word (x / BitsPerWord).
+     */
+    inline word* row(const int y);
+
+    /**
+     * First word of the row \a y
+     */
+    inline const word* row(const int y) const;
+
+    /**
+     * @name Word-parallel operations
+     *
+     * The masks must have the same size.  On a size mismatch the
+     * operations leave this mask unchanged and count() returns -1.
+     */
+    //@{
+    /**
+     * Keep only the pixels also set in \a other, which must have the
+     * size of this mask
+     */
+    bitMask& bitwiseAnd(const bitMask& other);
+
+    /**
+     * This mask becomes the intersection of \a a and \a b, which must
+     * have the same size
+     */
+    bitMask& bitwiseAnd(const bitMask& a,const bitMask& b);
+
+    /**
+     * Add the pixels set in \a other, which must have the size of this
+     * mask
+     */
+    bitMask& bitwiseOr(const bitMask& other);
+
+    /**
+     * This mask becomes the union of \a a and \a b, which must have the
+     * same size
+     */
+    bitMask& bitwiseOr(const bitMask& a,const bitMask& b);
+
+    /**
+     * Toggle the pixels set in \a other, which must have the size of
+     * this mask
+     */
+    bitMask& bitwiseXor(const bitMask& other);
+
+    /**
+     * Toggle all pixels
+     */
+    bitMask& invert();
+
+    /**
+     * Number of pixels set
+     */
+    int count() const;
+
+    /**
+     * Number of pixels set in this mask and in \a other, without
+     * computing the intersection.  \a other must have the size of this
+     * mask, otherwise -1 is returned.
+     */
+    int count(const bitMask& other) const;
+
+    /**
+     * Fraction of the pixels set, in [0,1]
+     */
+    double fraction() const;
+    //@}
+
+    /**
+     * @name Conversion to and from channel8
+     */
+    //@{
+    /**
+     * Set the pixels that are not zero in \a src
+     */
+    bitMask& castFrom(const channel8& src);
+
+    /**
+     * Set the pixels that are equal to \a value in \a src
+     */
+    bitMask& castFrom(const channel8& src,const ubyte value);
+
+    /**
+     * Write the mask into a channel8 with \a off for the cleared pixels
+     * and \a on for the set ones
+     */
+    void castTo(channel8& dest,
+                const ubyte off=0,
+                const ubyte on=255) const;
+    //@}
+
+  protected:
+    /**
+     * Clear the bits after the last column of each row
+     */
+    void clearPadding();
+
+    /**
+     * True if \a other has the size of this mask
+     */
+    inline bool sameSize(const bitMask& other) const;
+
+    /**
+     * Size
+     */
+    int rows_,columns_,words_;
+
+    /**
+     * All words, row after row
+     */
+    std::vector<word> data_;
+  };
+
+  // --------------------------------------------------
+  // inline implementation
+  // --------------------------------------------------
+
+  inline int bitMask::rows() const {
+    return rows_;
+  }
+
+  inline int bitMask::columns() const {
+    return columns_;
+  }
+
+  inline bool bitMask::sameSize(const bitMask& other) const {
+    return (rows_ == other.rows_) && (columns_ == other.columns_);
+  }
+
+  inline bool bitMask::empty() const {
+    return data_.empty();
+  }
+
+  inline int bitMask::wordsPerRow() const {
+    return words_;
+  }
+
+  inline bool bitMask::at(const int y,const int x) const {
+    return ((data_[y*words_+x/BitsPerWord] >> (x%BitsPerWord)) &
+            static_cast<word>(1)) != 0;
+  }
+
+  inline void bitMask::set(const int y,const int x,const bool value) {
+    const word bit = static_cast<word>(1) << (x%BitsPerWord);
+    word& w = data_[y*words_+x/BitsPerWord];
+    if (value) {
+      w |= bit;
+    } else {
+      w &= ~bit;
+    }
+  }
+
+  inline bitMask::word* bitMask::row(const int y) {
+    return &data_[y*words_];
+  }
+
+  inline const bitMask::word* bitMask::row(const int y) const {
+    return &data_[y*words_];
+  }
+
+}
+
+#endif
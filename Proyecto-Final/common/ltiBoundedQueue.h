@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiBoundedQueue.h
+ *         Contains a blocking first-in first-out queue of fixed capacity,
+ *         used to pass data between the threads of a pipeline.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_BOUNDED_QUEUE_H_
+#define _LTI_BOUNDED_QUEUE_H_
+
+#include "ltiObject.h"
+#include "ltiMutex.h"
+#include "ltiSemaphore.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Bounded blocking queue.
+   *
+   * First-in first-out queue of at most capacity() elements, shared by
+   * any number of producer and consumer threads.  push() blocks while
+   * the queue is full and pop() while it is empty, so that a fast stage of
+   * a pipeline cannot run arbitrarily far ahead of a slow one, and the
+   * memory in flight stays bounded.
+   *
+   * The elements are copied, so that large data is usually passed as
+   * pointers to buffers owned elsewhere.  A second queue returning the
+   * empty buffers to the producer recycles them, without allocating
+   * anything while the pipeline runs.
+   *
+   * Example:
+   * \code
+   * lti::boundedQueue<lti::channel*> full(4),empty(4);
+   * // producer thread
+   * lti::channel* buffer;
+   * empty.pop(buffer);
+   * // ... fill *buffer ...
+   * full.push(buffer);
+   * // consumer thread
+   * full.pop(buffer);
+   * // ... use *buffer ...
+   * empty.push(buffer);
+   * \endcode
+   */
+  template<class T>
+  class boundedQueue : public object {
+  public:
+    /**
+     * Constructor
+     *
+     * @param capacity maximal number of elements in the queue (at least 1)
+     */
+    boundedQueue(const int capacity);
+
+    /**
+     * Destructor
+     */
+    virtual ~boundedQueue();
+
+    /**
+     * Append an element at the end of the queue, waiting while the queue
+     * is full.
+     */
+    void push(const T& item);
+
+    /**
+     * Take the first element of the queue, waiting while the queue is
+     * empty.
+     */
+    void pop(T& item);
+
+    /**
+     * Maximal number of elements
+     */
+    int capacity() const;
+
+  private:
+    /**
+     * Ring buffer with the elements
+     */
+    std::vector<T> ring_;
+
+    /**
+     * Position of the first element and of the next free slot
+     */
+    int head_,tail_;
+
+    /**
+     * Number of free slots
+     */
+    semaphore free_;
+
+    /**
+     * Number of elements
+     */
+    semaphore used_;
+
+    /**
+     * Protects head_ and tail_
+     */
+    mutex lock_;
+
+    /**
+     * Disable copy
+     */
+    boundedQueue(const boundedQueue& other);
+
+    /**
+     * Disable copy
+     */
+    boundedQueue& operator=(const boundedQueue& other);
+  };
+
+  // --------------------------------------------------
+  // implementation
+  // --------------------------------------------------
+
+  template<class T>
+  boundedQueue<T>::boundedQueue(const int capacity)
+    : object(),ring_(capacity > 0 ? capacity : 1),head_(0),tail_(0),
+      free_(capacity > 0 ? capacity : 1),used_(0) {
+  }
+
+  template<class T>
+  boundedQueue<T>::~boundedQueue() {
+  }
+
+  template<class T>
+  void boundedQueue<T>::push(const T& item) {
+    free_.wait();
+    lock_.lock();
+    ring_[tail_] = item;
+    tail_ = (tail_+1) % static_cast<int>(ring_.size());
+    lock_.unlock();
+    used_.post();
+  }
+
+  template<class T>
+  void boundedQueue<T>::pop(T& item) {
+    used_.wait();
+    lock_.lock();
+    item = ring_[head_];
+    head_ = (head_+1) % static_cast<int>(ring_.size());
+    lock_.unlock();
+    free_.post();
+  }
+
+  template<class T>
+  int boundedQueue<T>::capacity() const {
+    return static_cast<int>(ring_.size());
+  }
+
+}
+
+#endif
@@ -0,0 +1,506 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiHistogramEngine.cpp
+ *         Parallel computation of the histogram of a channel, with private
+ *         bins per thread.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiHistogramEngine.h"
+#include "ltiMath.h"
+#include "ltiWorkerPool.h"
+
+#include <vector>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+namespace lti {
+  // --------------------------------------------------
+  // histogramEngine::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  histogramEngine::parameters::parameters()
+    : functor::parameters() {
+    bins = 256;
+    minValue = 0.0f;
+    maxValue = 1.0f;
+    copies = 4;
+    threads = 0;
+  }
+
+  // copy constructor
+  histogramEngine::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  histogramEngine::parameters::~parameters() {
+  }
+
+  // copy member
+  histogramEngine::parameters&
+  histogramEngine::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    bins     = other.bins;
+    minValue = other.minValue;
+    maxValue = other.maxValue;
+    copies   = other.copies;
+    threads  = other.threads;
+
+    return *this;
+  }
+
+  // alias for copy method
+  histogramEngine::parameters&
+  histogramEngine::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& histogramEngine::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  histogramEngine::parameters*
+  histogramEngine::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  histogramEngine::parameters*
+  histogramEngine::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  bool histogramEngine::parameters::write(ioHandler& handler,
+                                          const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"bins",bins) && b;
+      b = lti::write(handler,"minValue",minValue) && b;
+      b = lti::write(handler,"maxValue",maxValue) && b;
+      b = lti::write(handler,"copies",copies) && b;
+      b = lti::write(handler,"threads",threads) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  bool histogramEngine::parameters::read(ioHandler& handler,
+                                         const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"bins",bins) && b;
+      b = lti::read(handler,"minValue",minValue) && b;
+      b = lti::read(handler,"maxValue",maxValue) && b;
+      b = lti::read(handler,"copies",copies) && b;
+      b = lti::read(handler,"threads",threads) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // histogramEngine::countJob
+  // --------------------------------------------------
+
+  /*
+   * Count the n bin indices of idx into the interleaved sub-histograms
+   * h, h+bins, ..., h+(copies-1)*bins.  Consecutive pixels go to
+   * different sub-histograms, so that their increments never depend on
+   * each other.
+   */
+  template<class T>
+  static void countRow(const T* idx,
+                       const int n,
+                       const int bins,
+                       const int copies,
+                       int* h) {
+    int i=0;
+    switch(copies) {
+    case 1:
+      break;
+    case 2:
+      for (;i+2<=n;i+=2) {
+        h[idx[i]]++;
+        h[bins+idx[i+1]]++;
+      }
+      break;
+    case 4:
+      for (;i+4<=n;i+=4) {
+        h[idx[i]]++;
+        h[bins+idx[i+1]]++;
+        h[2*bins+idx[i+2]]++;
+        h[3*bins+idx[i+3]]++;
+      }
+      break;
+    default:
+      for (;i+copies<=n;i+=copies) {
+        for (int k=0;k<copies;++k) {
+          h[k*bins+idx[i+k]]++;
+        }
+      }
+      break;
+    }
+    for (;i<n;++i) {
+      h[idx[i]]++;
+    }
+  }
+
+  /**
+   * Each worker counts whole rows into its own sub-histograms.  For float
+   * channels the bins of a row are computed first into a buffer of the
+   * worker, together with the extreme values.
+   */
+  class histogramEngine::countJob : public workerPool::job {
+  public:
+    /**
+     * Data private to each worker
+     */
+    struct workerData {
+      workerData()
+        : minimum(std::numeric_limits<float>::max()),
+          maximum(-std::numeric_limits<float>::max()) {}
+
+      std::vector<int> counts;
+      std::vector<int> idx;
+      float minimum,maximum;
+    };
+
+    countJob(const int workers,
+             const int bins,
+             const int copies,
+             const float offset,
+             const float scale)
+      : src_(0),src8_(0),bins_(bins),copies_(copies),
+        offset_(offset),scale_(scale),data_(workers) {
+      for (int i=0;i<workers;++i) {
+        data_[i].counts.assign(bins_*copies_,0);
+      }
+    }
+
+    /**
+     * Use the given channel8, counted into 256 bins
+     */
+    void use(const channel8& src) {
+      src8_ = &src;
+      src_ = 0;
+    }
+
+    /**
+     * Use the given channel
+     */
+    void use(const channel& src) {
+      src_ = &src;
+      src8_ = 0;
+    }
+
+    virtual void process(const int from,const int to,const int worker) {
+      workerData& d = data_[worker];
+      int* h = &d.counts[0];
+
+      if (src8_ != 0) {
+        for (int y=from;y<to;++y) {
+          countRow(&src8_->at(y,0),src8_->columns(),bins_,copies_,h);
+        }
+        return;
+      }
+
+      const int cols = src_->columns();
+      d.idx.resize(cols);
+      for (int y=from;y<to;++y) {
+        binRow(&src_->at(y,0),cols,d);
+        countRow(&d.idx[0],cols,bins_,copies_,h);
+      }
+    }
+
+    /**
+     * Add all sub-histograms of all workers
+     */
+    void reduce(std::vector<int>& hist,float& minimum,float& maximum) const {
+      hist.assign(bins_,0);
+      minimum = std::numeric_limits<float>::max();
+      maximum = -std::numeric_limits<float>::max();
+      for (unsigned int w=0;w<data_.size();++w) {
+        const int* h = &data_[w].counts[0];
+        for (int k=0;k<copies_;++k,h+=bins_) {
+          for (int i=0;i<bins_;++i) {
+            hist[i] += h[i];
+          }
+        }
+        minimum = min(minimum,data_[w].minimum);
+        maximum = max(maximum,data_[w].maximum);
+      }
+    }
+
+  private:
+    /**
+     * Bins of a row of floats.  The clamping is done on the floats, which
+     * also maps NaN to the first bin.
+     */
+    void binRow(const float* src,const int n,workerData& d) const {
+      int* idx = &d.idx[0];
+      const float last = static_cast<float>(bins_-1);
+      int i=0;
+
+#if defined(__SSE2__)
+      const __m128 offset = _mm_set1_ps(offset_);
+      const __m128 scale = _mm_set1_ps(scale_);
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 top = _mm_set1_ps(last);
+      __m128 lo = _mm_set1_ps(d.minimum);
+      __m128 hi = _mm_set1_ps(d.maximum);
+      for (;i+4<=n;i+=4) {
+        const __m128 v = _mm_loadu_ps(src+i);
+        lo = _mm_min_ps(lo,v);
+        hi = _mm_max_ps(hi,v);
+        __m128 f = _mm_mul_ps(_mm_sub_ps(v,offset),scale);
+        f = _mm_min_ps(_mm_max_ps(f,zero),top);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(idx+i),
+                         _mm_cvttps_epi32(f));
+      }
+      float l[4],u[4];
+      _mm_storeu_ps(l,lo);
+      _mm_storeu_ps(u,hi);
+      d.minimum = min(min(l[0],l[1]),min(l[2],l[3]));
+      d.maximum = max(max(u[0],u[1]),max(u[2],u[3]));
+#endif
+
+      for (;i<n;++i) {
+        const float v = src[i];
+        d.minimum = min(d.minimum,v);
+        d.maximum = max(d.maximum,v);
+        float f = (v-offset_)*scale_;
+        if (!(f >= 0.0f)) {
+          f = 0.0f;
+        } else if (f > last) {
+          f = last;
+        }
+        idx[i] = static_cast<int>(f);
+      }
+    }
+
+    const channel* src_;
+    const channel8* src8_;
+    const int bins_,copies_;
+    const float offset_,scale_;
+    std::vector<workerData> data_;
+  };
+
+  // --------------------------------------------------
+  // histogramEngine
+  // --------------------------------------------------
+
+  // default constructor
+  histogramEngine::histogramEngine()
+    : functor(),min_(0.0f),max_(0.0f) {
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  // constructor with parameters
+  histogramEngine::histogramEngine(const parameters& par)
+    : functor(),min_(0.0f),max_(0.0f) {
+    // set the given parameters
+    setParameters(par);
+  }
+
+  // copy constructor
+  histogramEngine::histogramEngine(const histogramEngine& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  histogramEngine::~histogramEngine() {
+  }
+
+  // copy member
+  histogramEngine& histogramEngine::copy(const histogramEngine& other) {
+    functor::copy(other);
+
+    min_ = other.min_;
+    max_ = other.max_;
+
+    return *this;
+  }
+
+  // alias for copy member
+  histogramEngine& histogramEngine::operator=(const histogramEngine& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& histogramEngine::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  histogramEngine* histogramEngine::clone() const {
+    return new histogramEngine(*this);
+  }
+
+  // create a new instance
+  histogramEngine* histogramEngine::newInstance() const {
+    return new histogramEngine();
+  }
+
+  // return parameters
+  const histogramEngine::parameters& histogramEngine::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  float histogramEngine::getMinimum() const {
+    return min_;
+  }
+
+  float histogramEngine::getMaximum() const {
+    return max_;
+  }
+
+  bool histogramEngine::apply(const channel8& src,ivector& hist) {
+    const parameters& par = getParameters();
+    if ((par.bins <= 0) || (par.maxValue <= par.minValue)) {
+      setStatusString("Invalid bins or interval");
+      return false;
+    }
+
+    workerPool pool(par.threads);
+    countJob job(pool.size(),256,max(1,par.copies),0.0f,1.0f);
+    job.use(src);
+    pool.apply(job,src.rows(),16);
+
+    std::vector<int> raw;
+    float dummy;
+    job.reduce(raw,dummy,dummy);
+
+    // extreme values and folding of the 256 values into the bins
+    int lo = 255,hi = 0;
+    const float scale = par.bins/(par.maxValue-par.minValue);
+    const float last = static_cast<float>(par.bins-1);
+    hist.assign(par.bins,0);
+    for (int v=0;v<256;++v) {
+      if (raw[v] == 0) {
+        continue;
+      }
+      lo = min(lo,v);
+      hi = max(hi,v);
+      float f = (v/255.0f - par.minValue)*scale;
+      if (!(f >= 0.0f)) {
+        f = 0.0f;
+      } else if (f > last) {
+        f = last;
+      }
+      hist.at(static_cast<int>(f)) += raw[v];
+    }
+    min_ = (lo <= hi) ? lo/255.0f : 0.0f;
+    max_ = (lo <= hi) ? hi/255.0f : 0.0f;
+
+    return true;
+  }
+
+  bool histogramEngine::apply(const channel& src,ivector& hist) {
+    const parameters& par = getParameters();
+    if ((par.bins <= 0) || (par.maxValue <= par.minValue)) {
+      setStatusString("Invalid bins or interval");
+      return false;
+    }
+
+    workerPool pool(par.threads);
+    countJob job(pool.size(),par.bins,max(1,par.copies),par.minValue,
+                 par.bins/(par.maxValue-par.minValue));
+    job.use(src);
+    pool.apply(job,src.rows(),16);
+
+    std::vector<int> counts;
+    job.reduce(counts,min_,max_);
+    if (src.empty()) {
+      min_ = max_ = 0.0f;
+    }
+
+    hist.allocate(par.bins);
+    for (int i=0;i<par.bins;++i) {
+      hist.at(i) = counts[i];
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiHistogramEngine.h
+ *         Parallel computation of the histogram of a channel, with private
+ *         bins per thread.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_HISTOGRAM_ENGINE_H_
+#define _LTI_HISTOGRAM_ENGINE_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+#include "ltiVector.h"
+
+namespace lti {
+
+  /**
+   * Histogram engine.
+   *
+   * Computes the histogram of a channel or channel8 with
+   * parameters::bins bins equally distributed in the interval
+   * [parameters::minValue, parameters::maxValue] (the values of a channel8
+   * are divided by 255).  Values outside of the interval are counted in
+   * the first or last bin.
+   *
+   * The straightforward loop over the pixels stalls whenever two
+   * consecutive pixels fall into the same bin, since each increment has to
+   * wait for the store of the previous one.  Micrographs have large
+   * homogeneous regions, so that this is the common case.  Here each
+   * thread counts into parameters::copies interleaved sub-histograms,
+   * consecutive pixels going to different ones, and the rows are
+   * distributed among the threads of a lti::workerPool, each one with its
+   * private bins.  All sub-histograms are added at the end.
+   *
+   * A channel8 is always counted into 256 bins, which are then folded into
+   * the requested ones.  For a channel the bin is computed by a
+   * multiplication with the precomputed scale of the interval, without
+   * divisions, four pixels at a time with SSE2 when the compiler targets
+   * it.
+   *
+   * Example:
+   * \code
+   * lti::histogramEngine::parameters par;
+   * par.bins = 1024;
+   * lti::histogramEngine engine(par);
+   * lti::ivector hist;
+   * engine.apply(chnl,hist);
+   * \endcode
+   */
+  class histogramEngine : public functor {
+  public:
+    /**
+     * The parameters for the class histogramEngine
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Number of bins.
+       *
+       * Default value: 256
+       */
+      int bins;
+
+      /**
+       * Lower limit of the first bin.
+       *
+       * Default value: 0
+       */
+      float minValue;
+
+      /**
+       * Upper limit of the last bin.
+       *
+       * Default value: 1
+       */
+      float maxValue;
+
+      /**
+       * Number of interleaved sub-histograms per thread.  Four are enough
+       * to hide the latency of the increments; more only cost memory.
+       *
+       * Default value: 4
+       */
+      int copies;
+
+      /**
+       * Number of threads.  If zero, one per processor.
+       *
+       * Default value: 0
+       */
+      int threads;
+    };
+
+    /**
+     * Default constructor
+     */
+    histogramEngine();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    histogramEngine(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    histogramEngine(const histogramEngine& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~histogramEngine();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    histogramEngine& copy(const histogramEngine& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    histogramEngine& operator=(const histogramEngine& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual histogramEngine* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual histogramEngine* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Compute the histogram of the given channel8.
+     *
+     * @param src the channel
+     * @param hist the histogram, with parameters::bins elements
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel8& src,ivector& hist);
+
+    /**
+     * Compute the histogram of the given channel.
+     *
+     * @param src the channel
+     * @param hist the histogram, with parameters::bins elements
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& src,ivector& hist);
+
+    /**
+     * Smallest value of the channel of the last apply()
+     */
+    float getMinimum() const;
+
+    /**
+     * Largest value of the channel of the last apply()
+     */
+    float getMaximum() const;
+
+  protected:
+    /**
+     * Counting of blocks of rows by each worker
+     */
+    class countJob;
+
+    /**
+     * Extreme values of the last channel
+     */
+    float min_,max_;
+  };
+
+}
+
+#endif
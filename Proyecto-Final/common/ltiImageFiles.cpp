@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** 
+ * \file   ltiImageFiles.cpp
+ *         Lists of image files given on the command line of the batch
+ *         tools, and the names of the masks written for them.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiImageFiles.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace lti {
+
+  bool isImageFile(const std::string& name) {
+    std::string::size_type pos = name.rfind('.');
+    if (pos == std::string::npos) {
+      return false;
+    }
+    std::string ext = name.substr(pos+1);
+    for (std::string::size_type i=0;i<ext.size();++i) {
+      ext[i] = static_cast<char>(tolower(ext[i]));
+    }
+    return ((ext == "png") || (ext == "jpg") || (ext == "jpeg") ||
+            (ext == "bmp"));
+  }
+
+  bool collectImageFiles(const std::vector<std::string>& inputs,
+                         const std::string& listFile,
+                         std::vector<std::string>& files) {
+    files.clear();
+
+    bool ok = true;
+    if (!listFile.empty()) {
+      std::ifstream in(listFile.c_str());
+      ok = in.good();
+      std::string line;
+      while (std::getline(in,line)) {
+        if (!line.empty() && (line[0] != '#')) {
+          files.push_back(line);
+        }
+      }
+    }
+
+    for (unsigned int i=0;i<inputs.size();++i) {
+      struct stat st;
+      if ((stat(inputs[i].c_str(),&st) == 0) && S_ISDIR(st.st_mode)) {
+        // all images in the directory, in alphabetical order
+        std::vector<std::string> dirFiles;
+        DIR* dir = opendir(inputs[i].c_str());
+        if (dir != 0) {
+          struct dirent* entry;
+          while ((entry = readdir(dir)) != 0) {
+            const std::string name(entry->d_name);
+            if (isImageFile(name)) {
+              dirFiles.push_back(inputs[i] + "/" + name);
+            }
+          }
+          closedir(dir);
+        }
+        std::sort(dirFiles.begin(),dirFiles.end());
+        files.insert(files.end(),dirFiles.begin(),dirFiles.end());
+      } else {
+        files.push_back(inputs[i]);
+      }
+    }
+
+    return ok;
+  }
+
+  std::string maskName(const std::string& file,
+                       const std::string& outputDir,
+                       const std::string& suffix,
+                       const std::string& ext) {
+    std::string::size_type pos = file.rfind('/');
+    std::string base = (pos == std::string::npos) ? file : file.substr(pos+1);
+    pos = base.rfind('.');
+    if (pos != std::string::npos) {
+      base.erase(pos);
+    }
+    return outputDir + "/" + base + suffix + "." + ext;
+  }
+
+  bool uniqueMaskNames(const std::vector<std::string>& files,
+                       const std::string& outputDir,
+                       const std::string& suffix,
+                       const std::string& ext,
+                       std::vector<std::string>& conflicts) {
+    conflicts.clear();
+    std::map<std::string,std::string> names;
+    for (unsigned int i=0;i<files.size();++i) {
+      const std::string out = maskName(files[i],outputDir,suffix,ext);
+      std::map<std::string,std::string>::const_iterator it = names.find(out);
+      if (it != names.end()) {
+        conflicts.push_back("Images '" + it->second + "' and '" + files[i] +
+                            "' would both be written to '" + out + "'.");
+      } else {
+        names[out] = files[i];
+      }
+    }
+    return conflicts.empty();
+  }
+
+}
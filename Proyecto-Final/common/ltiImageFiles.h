@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** 
+ * \file   ltiImageFiles.h
+ *         Lists of image files given on the command line of the batch
+ *         tools, and the names of the masks written for them.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_IMAGE_FILES_H_
+#define _LTI_IMAGE_FILES_H_
+
+#include <string>
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Check if the given file name has the extension of a supported image
+   * format (png, jpg, jpeg or bmp, in any case)
+   */
+  bool isImageFile(const std::string& name);
+
+  /**
+   * Collect the names of the images to be processed.
+   *
+   * The files listed in \a listFile (one per line, ignoring empty lines and
+   * lines starting with '#') come first, followed by the \a inputs.  An
+   * input naming a directory is replaced by all images in it, in
+   * alphabetical order.
+   *
+   * @param inputs files or directories
+   * @param listFile name of a file with a list of images, or empty
+   * @param files the collected image names
+   * @return false if \a listFile could not be read, true otherwise.  The
+   *         images of the inputs are collected in any case.
+   */
+  bool collectImageFiles(const std::vector<std::string>& inputs,
+                         const std::string& listFile,
+                         std::vector<std::string>& files);
+
+  /**
+   * Name of the mask written for an image: the base name of \a file,
+   * without directory and extension, followed by \a suffix and the
+   * extension \a ext, in the directory \a outputDir.
+   *
+   * For example, maskName("img/a.png","out","-canny","pgm") is
+   * "out/a-canny.pgm".
+   */
+  std::string maskName(const std::string& file,
+                       const std::string& outputDir,
+                       const std::string& suffix,
+                       const std::string& ext);
+
+  /**
+   * Check that no two of the given images get the same maskName(), as
+   * happens with images of the same name in different directories or with
+   * different extensions.  Their masks would overwrite each other, or be
+   * written at the same time by different threads.
+   *
+   * @param files names of the images
+   * @param outputDir directory of the masks
+   * @param suffix appended to the base names
+   * @param ext extension of the masks
+   * @param conflicts one message for each image whose mask name was
+   *                  already taken
+   * @return true if all mask names are different
+   */
+  bool uniqueMaskNames(const std::vector<std::string>& files,
+                       const std::string& outputDir,
+                       const std::string& suffix,
+                       const std::string& ext,
+                       std::vector<std::string>& conflicts);
+
+}
+
+#endif
@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiRowStream.cpp
+ *         Sequential, row by row access to image files that are too large
+ *         to be kept in memory.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiRowStream.h"
+
+#include <cctype>
+#include <csetjmp>
+
+#if defined(HAVE_LIBPNG)
+#include <png.h>
+#endif
+
+namespace lti {
+
+  /*
+   * Extension of the file name in lower case
+   */
+  static std::string extension(const std::string& filename) {
+    const std::string::size_type pos = filename.rfind('.');
+    if (pos == std::string::npos) {
+      return std::string();
+    }
+    std::string ext = filename.substr(pos+1);
+    for (std::string::size_type i=0;i<ext.size();++i) {
+      ext[i] = static_cast<char>(tolower(ext[i]));
+    }
+    return ext;
+  }
+
+  // --------------------------------------------------
+  // rowReader
+  // --------------------------------------------------
+
+  rowReader::rowReader()
+    : object(),status(),format_(Unknown),file_(0),rows_(0),columns_(0),
+      row_(0),components_(0),bytes_(0),norm_(0.0f),png_(0),pngInfo_(0) {
+  }
+
+  rowReader::~rowReader() {
+    close();
+  }
+
+  int rowReader::rows() const {
+    return rows_;
+  }
+
+  int rowReader::columns() const {
+    return columns_;
+  }
+
+  int rowReader::getCurrentRow() const {
+    return row_;
+  }
+
+  bool rowReader::open(const std::string& filename) {
+    close();
+
+    file_ = fopen(filename.c_str(),"rb");
+    if (file_ == 0) {
+      setStatusString("Could not open file " + filename);
+      return false;
+    }
+
+    // the format is given by the magic number, not by the extension
+    const int c0 = fgetc(file_);
+    const int c1 = fgetc(file_);
+    rewind(file_);
+
+    bool ok = false;
+    if ((c0 == 'P') && ((c1 == '5') || (c1 == '6'))) {
+      format_ = PNM;
+      ok = openPNM();
+    } else if (c0 == 0x89) {
+#if defined(HAVE_LIBPNG)
+      format_ = PNG;
+      ok = openPNG();
+#else
+      setStatusString("PNG support not available");
+#endif
+    } else {
+      setStatusString("Format of " + filename + " not supported for " \
+                      "streaming.  Use binary PGM or PPM files.");
+    }
+
+    if (!ok) {
+      close();
+      return false;
+    }
+
+    row_ = 0;
+    buffer_.resize(static_cast<unsigned int>(columns_*components_*bytes_));
+    // sum of the components of a pixel divided by the number of components
+    // and the largest value
+    norm_ /= static_cast<float>(components_);
+
+    return true;
+  }
+
+  void rowReader::close() {
+#if defined(HAVE_LIBPNG)
+    if (png_ != 0) {
+      png_structp png = static_cast<png_structp>(png_);
+      png_infop info = static_cast<png_infop>(pngInfo_);
+      png_destroy_read_struct(&png,&info,0);
+    }
+#endif
+    png_ = 0;
+    pngInfo_ = 0;
+
+    if (file_ != 0) {
+      fclose(file_);
+      file_ = 0;
+    }
+    format_ = Unknown;
+    rows_ = columns_ = row_ = 0;
+  }
+
+  bool rowReader::read(channel& dest,const int row) {
+    if (file_ == 0) {
+      setStatusString("No file open");
+      return false;
+    }
+    if (row_ >= rows_) {
+      setStatusString("All rows have already been read");
+      return false;
+    }
+    if ((dest.columns() != columns_) || (row < 0) || (row >= dest.rows())) {
+      setStatusString("Destination row does not fit the image");
+      return false;
+    }
+
+    bool ok = false;
+    switch(format_) {
+    case PNM:
+      ok = readPNM(&dest.at(row,0));
+      break;
+#if defined(HAVE_LIBPNG)
+    case PNG:
+      ok = readPNG(&dest.at(row,0));
+      break;
+#endif
+    default:
+      break;
+    }
+
+    if (ok) {
+      ++row_;
+    }
+    return ok;
+  }
+
+  /*
+   * Convert the raw components in buffer into gray values.  Components with
+   * two bytes are big endian, as in PNM and PNG files.
+   */
+  static void toGray(const std::vector<ubyte>& buffer,
+                     const int columns,
+                     const int components,
+                     const int bytes,
+                     const float norm,
+                     float* dest) {
+    const ubyte* src = &buffer[0];
+    if (bytes == 1) {
+      if (components == 1) {
+        for (int x=0;x<columns;++x) {
+          dest[x] = src[x]*norm;
+        }
+      } else {
+        for (int x=0;x<columns;++x,src+=3) {
+          dest[x] = (static_cast<int>(src[0])+src[1]+src[2])*norm;
+        }
+      }
+    } else {
+      for (int x=0;x<columns;++x) {
+        int sum = 0;
+        for (int c=0;c<components;++c,src+=2) {
+          sum += (static_cast<int>(src[0]) << 8) | src[1];
+        }
+        dest[x] = sum*norm;
+      }
+    }
+  }
+
+  // --------------------------------------------------
+  // PGM/PPM
+  // --------------------------------------------------
+
+  /*
+   * Read the next integer of a PNM header, skipping white spaces and
+   * comments.  Returns -1 if there is none.
+   */
+  static int readHeaderValue(FILE* file) {
+    int c = fgetc(file);
+    while (c != EOF) {
+      if (c == '#') {
+        while ((c != EOF) && (c != '\n')) {
+          c = fgetc(file);
+        }
+      } else if (isspace(c)) {
+        c = fgetc(file);
+      } else {
+        break;
+      }
+    }
+
+    if ((c == EOF) || !isdigit(c)) {
+      return -1;
+    }
+
+    int value = 0;
+    while ((c != EOF) && isdigit(c)) {
+      value = value*10 + (c-'0');
+      c = fgetc(file);
+    }
+    // c is the single white space separating the header from the data
+    return value;
+  }
+
+  bool rowReader::openPNM() {
+    fgetc(file_);
+    components_ = (fgetc(file_) == '5') ? 1 : 3;
+
+    columns_ = readHeaderValue(file_);
+    rows_ = readHeaderValue(file_);
+    const int maxVal = readHeaderValue(file_);
+
+    if ((columns_ <= 0) || (rows_ <= 0) || (maxVal <= 0) ||
+        (maxVal > 65535)) {
+      setStatusString("Invalid PNM header");
+      return false;
+    }
+
+    bytes_ = (maxVal < 256) ? 1 : 2;
+    norm_ = 1.0f/static_cast<float>(maxVal);
+    return true;
+  }
+
+  bool rowReader::readPNM(float* dest) {
+    if (fread(&buffer_[0],1,buffer_.size(),file_) != buffer_.size()) {
+      setStatusString("Unexpected end of PNM file");
+      return false;
+    }
+    toGray(buffer_,columns_,components_,bytes_,norm_,dest);
+    return true;
+  }
+
+#if defined(HAVE_LIBPNG)
+  // --------------------------------------------------
+  // PNG
+  // --------------------------------------------------
+
+  bool rowReader::openPNG() {
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING,0,0,0);
+    if (png == 0) {
+      setStatusString("Could not initialize libpng");
+      return false;
+    }
+    png_infop info = png_create_info_struct(png);
+    png_ = png;
+    pngInfo_ = info;
+    if (info == 0) {
+      setStatusString("Could not initialize libpng");
+      return false;
+    }
+
+    if (setjmp(png_jmpbuf(png))) {
+      setStatusString("Invalid PNG header");
+      return false;
+    }
+
+    png_init_io(png,file_);
+    png_read_info(png,info);
+
+    if (png_get_interlace_type(png,info) != PNG_INTERLACE_NONE) {
+      setStatusString("Interlaced PNG images cannot be read row by row");
+      return false;
+    }
+
+    const int colorType = png_get_color_type(png,info);
+    if (colorType == PNG_COLOR_TYPE_PALETTE) {
+      png_set_palette_to_rgb(png);
+    }
+    if ((colorType == PNG_COLOR_TYPE_GRAY) &&
+        (png_get_bit_depth(png,info) < 8)) {
+      png_set_expand_gray_1_2_4_to_8(png);
+    }
+    if ((colorType & PNG_COLOR_MASK_ALPHA) != 0) {
+      png_set_strip_alpha(png);
+    }
+    png_read_update_info(png,info);
+
+    columns_ = static_cast<int>(png_get_image_width(png,info));
+    rows_ = static_cast<int>(png_get_image_height(png,info));
+    components_ = png_get_channels(png,info);
+    bytes_ = (png_get_bit_depth(png,info) > 8) ? 2 : 1;
+    norm_ = 1.0f/((bytes_ == 1) ? 255.0f : 65535.0f);
+
+    return ((components_ == 1) || (components_ == 3));
+  }
+
+  bool rowReader::readPNG(float* dest) {
+    png_structp png = static_cast<png_structp>(png_);
+    if (setjmp(png_jmpbuf(png))) {
+      setStatusString("Corrupt PNG data");
+      return false;
+    }
+    png_read_row(png,&buffer_[0],0);
+    toGray(buffer_,columns_,components_,bytes_,norm_,dest);
+    return true;
+  }
+#endif
+
+  // --------------------------------------------------
+  // rowWriter
+  // --------------------------------------------------
+
+  rowWriter::rowWriter()
+    : object(),status(),file_(0),png_(false),rows_(0),columns_(0),row_(0),
+      pngWrite_(0),pngInfo_(0) {
+  }
+
+  rowWriter::~rowWriter() {
+    close();
+  }
+
+  int rowWriter::getCurrentRow() const {
+    return row_;
+  }
+
+  bool rowWriter::supported(const std::string& filename) {
+    const std::string ext = extension(filename);
+#if defined(HAVE_LIBPNG)
+    if (ext == "png") {
+      return true;
+    }
+#endif
+    return ((ext == "pgm") || (ext == "pnm"));
+  }
+
+  bool rowWriter::open(const std::string& filename,
+                       const int rows,
+                       const int columns) {
+    close();
+
+    if (!supported(filename)) {
+      setStatusString("Format of " + filename + " not supported for " \
+                      "streaming");
+      return false;
+    }
+
+    file_ = fopen(filename.c_str(),"wb");
+    if (file_ == 0) {
+      setStatusString("Could not create file " + filename);
+      return false;
+    }
+
+    rows_ = rows;
+    columns_ = columns;
+    row_ = 0;
+    png_ = (extension(filename) == "png");
+
+    if (!png_) {
+      fprintf(file_,"P5\n%d %d\n255\n",columns_,rows_);
+      return (ferror(file_) == 0);
+    }
+
+#if defined(HAVE_LIBPNG)
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING,0,0,0);
+    png_infop info = (png != 0) ? png_create_info_struct(png) : 0;
+    pngWrite_ = png;
+    pngInfo_ = info;
+    if ((png == 0) || (info == 0) || setjmp(png_jmpbuf(png))) {
+      setStatusString("Could not initialize libpng");
+      return false;
+    }
+
+    png_init_io(png,file_);
+    png_set_IHDR(png,info,columns_,rows_,8,PNG_COLOR_TYPE_GRAY,
+                 PNG_INTERLACE_NONE,PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png,info);
+#endif
+
+    return true;
+  }
+
+  bool rowWriter::write(const channel8& src,const int row) {
+    if (file_ == 0) {
+      setStatusString("No file open");
+      return false;
+    }
+    if (row_ >= rows_) {
+      setStatusString("All rows have already been written");
+      return false;
+    }
+    if ((src.columns() != columns_) || (row < 0) || (row >= src.rows())) {
+      setStatusString("Source row does not fit the image");
+      return false;
+    }
+
+    const ubyte* data = &src.at(row,0);
+
+#if defined(HAVE_LIBPNG)
+    if (png_) {
+      png_structp png = static_cast<png_structp>(pngWrite_);
+      if (setjmp(png_jmpbuf(png))) {
+        setStatusString("Error writing PNG data");
+        return false;
+      }
+      png_write_row(png,const_cast<png_bytep>(data));
+      ++row_;
+      return true;
+    }
+#endif
+
+    if (fwrite(data,1,columns_,file_) != static_cast<size_t>(columns_)) {
+      setStatusString("Error writing PGM data");
+      return false;
+    }
+    ++row_;
+    return true;
+  }
+
+  bool rowWriter::close() {
+    if (file_ == 0) {
+      return true;
+    }
+
+    bool ok = (row_ == rows_);
+
+#if defined(HAVE_LIBPNG)
+    if (pngWrite_ != 0) {
+      png_structp png = static_cast<png_structp>(pngWrite_);
+      png_infop info = static_cast<png_infop>(pngInfo_);
+      if (ok && !setjmp(png_jmpbuf(png))) {
+        png_write_end(png,info);
+      }
+      png_destroy_write_struct(&png,&info);
+    }
+#endif
+    pngWrite_ = 0;
+    pngInfo_ = 0;
+
+    ok = (fclose(file_) == 0) && ok;
+    file_ = 0;
+    if (!ok) {
+      setStatusString("Image file incomplete");
+    }
+    return ok;
+  }
+
+}
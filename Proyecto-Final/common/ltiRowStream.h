@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiRowStream.h
+ *         Sequential, row by row access to image files that are too large
+ *         to be kept in memory.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_ROW_STREAM_H_
+#define _LTI_ROW_STREAM_H_
+
+#include "ltiConfig.h"
+#include "ltiObject.h"
+#include "ltiStatus.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Sequential reader of the rows of an image file.
+   *
+   * lti::ioImage always loads the complete image.  This class instead
+   * reads the file one row at a time, so that the memory required does not
+   * depend on the size of the image.  The rows are delivered as gray
+   * values between 0 and 1, where color images are converted as in
+   * lti::channel::castFrom(const image&), i.e. averaging the three
+   * components.
+   *
+   * Supported formats are the binary portable any maps (PGM "P5" and
+   * PPM "P6", with 8 or 16 bits per component) and, if the LTI-Lib was
+   * configured with libpng, non-interlaced PNG images.
+   *
+   * Example:
+   * \code
+   * lti::rowReader reader;
+   * if (reader.open("mosaic.pgm")) {
+   *   lti::channel band(64,reader.columns());
+   *   for (int y=0;y<64;++y) {
+   *     reader.read(band,y);
+   *   }
+   * }
+   * \endcode
+   */
+  class rowReader : public object, public status {
+  public:
+    /**
+     * Default constructor
+     */
+    rowReader();
+
+    /**
+     * Destructor.  Closes the file if still open.
+     */
+    virtual ~rowReader();
+
+    /**
+     * Open the given file and read its header.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Close the file
+     */
+    void close();
+
+    /**
+     * Number of rows of the image
+     */
+    int rows() const;
+
+    /**
+     * Number of columns of the image
+     */
+    int columns() const;
+
+    /**
+     * Index of the next row to be read
+     */
+    int getCurrentRow() const;
+
+    /**
+     * Read the next row of the file into the row \a row of \a dest, which
+     * must have exactly columns() columns.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool read(channel& dest,const int row);
+
+  private:
+    /**
+     * File formats
+     */
+    enum eFormat {
+      Unknown, /**< No file open */
+      PNM,     /**< Binary PGM or PPM */
+      PNG      /**< Portable network graphics */
+    };
+
+    /**
+     * Parse the header of a PGM/PPM file
+     */
+    bool openPNM();
+
+    /**
+     * Read one row of a PGM/PPM file
+     */
+    bool readPNM(float* dest);
+
+#if defined(HAVE_LIBPNG)
+    /**
+     * Parse the header of a PNG file
+     */
+    bool openPNG();
+
+    /**
+     * Read one row of a PNG file
+     */
+    bool readPNG(float* dest);
+#endif
+
+    /**
+     * Format of the open file
+     */
+    eFormat format_;
+
+    /**
+     * The open file
+     */
+    FILE* file_;
+
+    /**
+     * Image size
+     */
+    int rows_,columns_;
+
+    /**
+     * Next row to be read
+     */
+    int row_;
+
+    /**
+     * Number of components per pixel (1: gray, 3: RGB)
+     */
+    int components_;
+
+    /**
+     * Bytes per component (1 or 2)
+     */
+    int bytes_;
+
+    /**
+     * Factor to map a component sum into [0,1]
+     */
+    float norm_;
+
+    /**
+     * Raw data of one row
+     */
+    std::vector<ubyte> buffer_;
+
+    /**
+     * libpng read and info structures
+     */
+    void* png_;
+    void* pngInfo_;
+
+    /**
+     * Disable copy
+     */
+    rowReader(const rowReader&);
+    rowReader& operator=(const rowReader&);
+  };
+
+  /**
+   * Sequential writer of the rows of a gray valued image.
+   *
+   * The counterpart of lti::rowReader: the rows of a mask are written as
+   * soon as they are available, so that the image never has to be
+   * complete in memory.  The format is selected with the extension of the
+   * file name: ".png" (only if the LTI-Lib was configured with libpng)
+   * and ".pgm" are supported.
+   */
+  class rowWriter : public object, public status {
+  public:
+    /**
+     * Default constructor
+     */
+    rowWriter();
+
+    /**
+     * Destructor.  Closes the file if still open.
+     */
+    virtual ~rowWriter();
+
+    /**
+     * Create the given file for an image of the given size
+     *
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename,const int rows,const int columns);
+
+    /**
+     * Write the row \a row of \a src as the next row of the file.  The
+     * channel must have exactly the number of columns given in open().
+     *
+     * @return true if successful, false otherwise
+     */
+    bool write(const channel8& src,const int row);
+
+    /**
+     * Finish the file.  If not all rows were written the file is
+     * incomplete and false is returned.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool close();
+
+    /**
+     * Index of the next row to be written
+     */
+    int getCurrentRow() const;
+
+    /**
+     * Check if the format of the given file name can be written.
+     */
+    static bool supported(const std::string& filename);
+
+  private:
+    /**
+     * The open file
+     */
+    FILE* file_;
+
+    /**
+     * Write PNG instead of PGM
+     */
+    bool png_;
+
+    /**
+     * Image size
+     */
+    int rows_,columns_;
+
+    /**
+     * Next row to be written
+     */
+    int row_;
+
+    /**
+     * libpng write and info structures
+     */
+    void* pngWrite_;
+    void* pngInfo_;
+
+    /**
+     * Disable copy
+     */
+    rowWriter(const rowWriter&);
+    rowWriter& operator=(const rowWriter&);
+  };
+
+}
+
+#endif
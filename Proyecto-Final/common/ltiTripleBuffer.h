@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiTripleBuffer.h
+ *         Contains a lock-free exchange of the newest frame between a
+ *         producer thread and a consumer thread.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_TRIPLE_BUFFER_H_
+#define _LTI_TRIPLE_BUFFER_H_
+
+#include "ltiObject.h"
+
+#if !defined(__GNUC__)
+#include "ltiMutex.h"
+#endif
+
+namespace lti {
+
+  /**
+   * Triple buffer.
+   *
+   * Passes the newest of a stream of frames from one producer thread to
+   * one consumer thread, without locks and without allocating anything.
+   * The three buffers rotate: the producer always owns the back() buffer
+   * and the consumer the front() one, while the third one, in the
+   * middle, holds the last published frame.  publish() and take()
+   * exchange one of the owned buffers with the middle one with a single
+   * atomic operation, so that neither thread ever waits for the other.
+   *
+   * If the producer publishes a new frame before the consumer took the
+   * previous one, the previous one is dropped and its buffer is reused:
+   * the consumer always gets the newest frame, and a slow consumer never
+   * slows the producer down.  The number of dropped frames is counted.
+   *
+   * The buffers are reused, so that e.g. a lti::channel8 keeps its
+   * memory if all frames have the same size.
+   *
+   * Example:
+   * \code
+   * lti::tripleBuffer<lti::channel8> frames;
+   * // producer thread
+   * camera.apply(frames.back());
+   * frames.publish();
+   * // consumer thread
+   * if (frames.take()) {
+   *   detector.apply(frames.front(),result);
+   * }
+   * \endcode
+   */
+  template<class T>
+  class tripleBuffer : public object {
+  public:
+    /**
+     * Constructor
+     */
+    tripleBuffer();
+
+    /**
+     * Destructor
+     */
+    virtual ~tripleBuffer();
+
+    /**
+     * Buffer to be filled by the producer
+     */
+    T& back();
+
+    /**
+     * Make the back() buffer the newest frame, and get a new back()
+     * buffer.  Only the producer may call this method.
+     *
+     * @return false if the previous frame was dropped without being taken
+     */
+    bool publish();
+
+    /**
+     * Make the newest frame the front() buffer, if a frame was published
+     * since the last call.  Only the consumer may call this method.
+     *
+     * @return true if there is a new front() buffer
+     */
+    bool take();
+
+    /**
+     * Buffer with the frame taken by the consumer
+     */
+    T& front();
+
+    /**
+     * Number of frames published so far
+     */
+    int published() const;
+
+    /**
+     * Number of frames dropped so far
+     */
+    int dropped() const;
+
+  private:
+    /**
+     * Flag of the middle_ index set if it holds a frame not yet taken
+     */
+    static const int Fresh = 4;
+
+    /**
+     * Set the middle_ index and flag, returning the previous one, with
+     * the memory effects of the writes to the buffers ordered before
+     */
+    int exchange(const int value);
+
+    /**
+     * The buffers
+     */
+    T buffers_[3];
+
+    /**
+     * Index of the buffer owned by the producer
+     */
+    int back_;
+
+    /**
+     * Index of the buffer owned by the consumer
+     */
+    int front_;
+
+    /**
+     * Index of the third buffer, with the Fresh flag
+     */
+    volatile int middle_;
+
+    /**
+     * Counters, written only by the producer
+     */
+    //@{
+    volatile int published_;
+    volatile int dropped_;
+    //@}
+
+#if !defined(__GNUC__)
+    /**
+     * Protects middle_ without atomic operations
+     */
+    mutex lock_;
+#endif
+
+    /**
+     * Disable copy
+     */
+    tripleBuffer(const tripleBuffer& other);
+
+    /**
+     * Disable copy
+     */
+    tripleBuffer& operator=(const tripleBuffer& other);
+  };
+
+  // --------------------------------------------------
+  // implementation
+  // --------------------------------------------------
+
+  template<class T>
+  tripleBuffer<T>::tripleBuffer()
+    : object(),back_(0),front_(1),middle_(2),published_(0),dropped_(0) {
+  }
+
+  template<class T>
+  tripleBuffer<T>::~tripleBuffer() {
+  }
+
+  template<class T>
+  int tripleBuffer<T>::exchange(const int value) {
+#if defined(__GNUC__)
+    // the test-and-set is only an acquire barrier
+    __sync_synchronize();
+    return __sync_lock_test_and_set(&middle_,value);
+#else
+    lock_.lock();
+    const int old = middle_;
+    middle_ = value;
+    lock_.unlock();
+    return old;
+#endif
+  }
+
+  template<class T>
+  T& tripleBuffer<T>::back() {
+    return buffers_[back_];
+  }
+
+  template<class T>
+  bool tripleBuffer<T>::publish() {
+    const int old = exchange(back_ | Fresh);
+    back_ = old & ~Fresh;
+    published_ = published_ + 1;
+    if ((old & Fresh) != 0) {
+      dropped_ = dropped_ + 1;
+      return false;
+    }
+    return true;
+  }
+
+  template<class T>
+  bool tripleBuffer<T>::take() {
+    // only the consumer clears the flag, so that it cannot disappear
+    // before the exchange
+    if ((middle_ & Fresh) == 0) {
+      return false;
+    }
+    front_ = exchange(front_) & ~Fresh;
+    return true;
+  }
+
+  template<class T>
+  T& tripleBuffer<T>::front() {
+    return buffers_[front_];
+  }
+
+  template<class T>
+  int tripleBuffer<T>::published() const {
+    return published_;
+  }
+
+  template<class T>
+  int tripleBuffer<T>::dropped() const {
+    return dropped_;
+  }
+
+}
+
+#endif
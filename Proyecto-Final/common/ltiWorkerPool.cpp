@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiWorkerPool.cpp
+ *         Contains a small pool of worker threads used to distribute
+ *         independent pieces of work among the available processors.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiWorkerPool.h"
+#include "ltiMath.h"
+
+#include <unistd.h>
+
+namespace lti {
+
+  // --------------------------------------------------
+  // workerPool::job
+  // --------------------------------------------------
+
+  workerPool::job::~job() {
+  }
+
+  // --------------------------------------------------
+  // workerPool::worker
+  // --------------------------------------------------
+
+  workerPool::worker::worker(workerPool& pool,const int id)
+    : thread(),wakeUp(0),pool_(pool),id_(id) {
+  }
+
+  void workerPool::worker::run() {
+    while (wakeUp.wait() && !pool_.quit_) {
+      pool_.work(id_);
+      pool_.done_.post();
+    }
+  }
+
+  // --------------------------------------------------
+  // workerPool
+  // --------------------------------------------------
+
+  workerPool::workerPool(const int threads)
+    : object(),job_(0),items_(0),chunkSize_(1),next_(0),quit_(false),
+      done_(0) {
+    const int n = (threads > 0) ? threads : getNumberOfProcessors();
+
+    if (n > 1) {
+      workers_.resize(n,0);
+      for (int i=0;i<n;++i) {
+        workers_[i] = new worker(*this,i);
+        workers_[i]->start();
+      }
+    }
+  }
+
+  workerPool::~workerPool() {
+    quit_ = true;
+    for (unsigned int i=0;i<workers_.size();++i) {
+      workers_[i]->wakeUp.post();
+    }
+    for (unsigned int i=0;i<workers_.size();++i) {
+      workers_[i]->join();
+      delete workers_[i];
+      workers_[i]=0;
+    }
+  }
+
+  int workerPool::size() const {
+    return workers_.empty() ? 1 : static_cast<int>(workers_.size());
+  }
+
+  int workerPool::getNumberOfProcessors() {
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? static_cast<int>(n) : 1;
+  }
+
+  void workerPool::apply(job& theJob,const int items,const int chunkSize) {
+    if (items <= 0) {
+      return;
+    }
+
+    if (workers_.empty()) {
+      // single worker: just do it here
+      theJob.process(0,items,0);
+      return;
+    }
+
+    job_       = &theJob;
+    items_     = items;
+    chunkSize_ = max(1,chunkSize);
+    next_      = 0;
+
+    for (unsigned int i=0;i<workers_.size();++i) {
+      workers_[i]->wakeUp.post();
+    }
+    for (unsigned int i=0;i<workers_.size();++i) {
+      done_.wait();
+    }
+
+    job_ = 0;
+  }
+
+  bool workerPool::nextChunk(int& from,int& to) {
+    lock_.lock();
+    from = next_;
+    to = min(items_,from+chunkSize_);
+    next_ = to;
+    lock_.unlock();
+
+    return (from < to);
+  }
+
+  void workerPool::work(const int id) {
+    int from,to;
+    while (nextChunk(from,to)) {
+      job_->process(from,to,id);
+    }
+  }
+
+}
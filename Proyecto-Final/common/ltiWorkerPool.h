@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiWorkerPool.h
+ *         Contains a small pool of worker threads used to distribute
+ *         independent pieces of work (images, rows, bands) among the
+ *         available processors.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_WORKER_POOL_H_
+#define _LTI_WORKER_POOL_H_
+
+#include "ltiObject.h"
+#include "ltiThread.h"
+#include "ltiMutex.h"
+#include "ltiSemaphore.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Pool of worker threads.
+   *
+   * The pool creates its threads once, in the constructor, and keeps them
+   * sleeping until some job is given with apply().  The items of the job
+   * (indices 0 to \c items-1) are handed out in chunks to the workers, so
+   * that faster workers simply take more chunks.  apply() returns only
+   * after all items have been processed.
+   *
+   * Each worker has a fixed index between 0 and size()-1, which the jobs
+   * can use to access data private to the thread (for instance, one functor
+   * instance per thread), avoiding any locking in the inner loops.
+   *
+   * If the pool has only one worker, the job is processed in the calling
+   * thread and no additional thread is created at all.
+   *
+   * Example:
+   * \code
+   * class rowJob : public lti::workerPool::job {
+   * public:
+   *   virtual void process(const int from,const int to,const int worker) {
+   *     for (int y=from;y<to;++y) {
+   *       // process row y
+   *     }
+   *   }
+   * };
+   *
+   * lti::workerPool pool;
+   * rowJob job;
+   * pool.apply(job,img.rows(),16); // 16 rows per chunk
+   * \endcode
+   */
+  class workerPool : public object {
+  public:
+    /**
+     * Interface for the work distributed among the workers.
+     */
+    class job {
+    public:
+      /**
+       * Virtual destructor
+       */
+      virtual ~job();
+
+      /**
+       * Process the items in the interval [from,to[.
+       *
+       * This method is called concurrently from several threads, each time
+       * with a disjoint interval.
+       *
+       * @param from first item to be processed
+       * @param to item after the last one to be processed
+       * @param worker index of the calling worker, between 0 and
+       *               workerPool::size()-1
+       */
+      virtual void process(const int from,const int to,const int worker) = 0;
+    };
+
+    /**
+     * Constructor
+     *
+     * @param threads number of workers.  If zero or negative, as many
+     *                workers as online processors will be created.
+     */
+    workerPool(const int threads=0);
+
+    /**
+     * Destructor.  Stops and joins all workers.
+     */
+    virtual ~workerPool();
+
+    /**
+     * Number of workers in the pool
+     */
+    int size() const;
+
+    /**
+     * Process the items 0 to \a items-1 of the given job, distributing them
+     * in chunks of \a chunkSize items among the workers.
+     *
+     * The method blocks until all items have been processed.  It must not
+     * be called concurrently for the same pool.
+     */
+    void apply(job& theJob,const int items,const int chunkSize=1);
+
+    /**
+     * Number of processors currently online
+     */
+    static int getNumberOfProcessors();
+
+  private:
+    /**
+     * Each one of the threads in the pool
+     */
+    class worker : public thread {
+    public:
+      /**
+       * Constructor
+       */
+      worker(workerPool& pool,const int id);
+
+      /**
+       * Semaphore used to wake up the worker
+       */
+      semaphore wakeUp;
+
+    protected:
+      /**
+       * Thread body
+       */
+      virtual void run();
+
+    private:
+      /**
+       * Pool owning this worker
+       */
+      workerPool& pool_;
+
+      /**
+       * Index of this worker
+       */
+      const int id_;
+    };
+
+    friend class worker;
+
+    /**
+     * Process chunks of the current job until none is left.
+     */
+    void work(const int id);
+
+    /**
+     * Get the next chunk of the current job.
+     *
+     * @return false if there is nothing else to do
+     */
+    bool nextChunk(int& from,int& to);
+
+    /**
+     * Disable copy
+     */
+    workerPool(const workerPool& other);
+
+    /**
+     * Disable copy
+     */
+    workerPool& operator=(const workerPool& other);
+
+    /**
+     * The workers
+     */
+    std::vector<worker*> workers_;
+
+    /**
+     * Job being currently processed
+     */
+    job* job_;
+
+    /**
+     * Total number of items in the current job
+     */
+    int items_;
+
+    /**
+     * Items per chunk in the current job
+     */
+    int chunkSize_;
+
+    /**
+     * Next item to be handed out
+     */
+    int next_;
+
+    /**
+     * Flag to indicate the workers that they have to terminate
+     */
+    bool quit_;
+
+    /**
+     * Protects next_
+     */
+    mutex lock_;
+
+    /**
+     * Posted by each worker when it finishes its part of a job
+     */
+    semaphore done_;
+  };
+
+}
+
+#endif
@@ -1,4 +1,8 @@
 
+#include "disparity.h"
+
+// LTI-Lib Headers
+
 #include <ltiObject.h>
 #include <ltiMath.h>     // General lti:: math and <cmath> functionality
 #include <ltiTimer.h>    // To measure time
@@ -13,9 +17,16 @@
 #include <ltiColors.h>
 
 #include <ltiMatrixTransform.h>
+#include "ltiBlockMatchingDisparity.h"
+#include "ltiSemiGlobalMatching.h"
+#include "ltiPyramidDisparity.h"
+#include "ltiBoundedQueue.h"
+#include "ltiWorkerPool.h"
+#include <ltiThread.h>
 
 // Standard Headers: from ANSI C and GNU C Library
 #include <cstdlib>  // Standard Library for C++
+#include <cstdio>   // snprintf
 #include <getopt.h> // Functions to parse the command line arguments
 
 // Standard Headers: STL
@@ -35,7 +46,11 @@ using std::endl;
 #include "ltiDebug.h"
 
 
-disparity::disparity(int argc, char* argv[]) : range_(20) {
+disparity::disparity(int argc, char* argv[])
+  : range_(20),windowSize_(9),threads_(0),census_(false),sgm_(false),
+    paths_(8),costBits_(8),pyramid_(false),levels_(3),
+    check_(false),reuseSlices_(false),sequence_(false),first_(0),
+    output_("disparity%04d.png") {
   parse(argc,argv);
 }
 
@@ -45,9 +60,28 @@ disparity::disparity(int argc, char* argv[]) : range_(20) {
  */
 void disparity::usage() const {
   cout <<
-    "usage: disparity [options] <image1> <image2> \n\n" \
+    "usage: disparity [options] <image1> <image2> \n" \
+    "       disparity -s [options] <pattern1> <pattern2>\n\n" \
     "       -r val  Disparity range\n" \
     "       -l row  Generate an example row disparity\n" \
+    "       -w size Window size of the block matching map (odd)\n" \
+    "       -c      Census cost for the disparity map, instead of SAD\n" \
+    "       -g      Semi-global matching for the disparity map\n" \
+    "       -p n    Number of paths of the semi-global matching (4 or 8)\n" \
+    "       -b bits Bits of the semi-global matching costs (8 or 16)\n" \
+    "       -y n    Coarse-to-fine disparity map with n pyramid levels\n" \
+    "       -k      Left-right consistency check of the disparity map\n" \
+    "       -v file Compute the line disparities of all rows and store them\n" \
+    "               in the given file, from which they are shown\n" \
+    "       -u file Show the line disparities stored with -v in the file\n" \
+    "       -s      Sequence mode: compute and save the disparity maps of\n" \
+    "               the numbered pairs given by two printf patterns, e.g.\n" \
+    "               left%04d.png right%04d.png, until a file is missing\n" \
+    "       -f n    Index of the first pair of the sequence (default: 0)\n" \
+    "       -o pat  Pattern of the disparity maps of the sequence\n" \
+    "               (default: disparity%04d.png)\n" \
+    "       -j n    Number of threads of the disparity map (default: one\n" \
+    "               per CPU)\n" \
     "       -h      Show this help\n" \
     "       <image1> left input image\n" \
     "       <image2> right input image" << std::endl; 
@@ -57,6 +91,11 @@ void disparity::help() const {
   cout << 
     " +      Increase disparity.\n" \
     " -      Decrease disparity.\n" \
+    " m      Compute the dense disparity map.\n" \
+    " c      Toggle census/SAD cost of the disparity map.\n" \
+    " g      Toggle semi-global/block matching for the disparity map.\n" \
+    " y      Toggle coarse-to-fine search for the disparity map.\n" \
+    " k      Toggle the left-right consistency check of the map.\n" \
     " Arrows Increase/Decrease selected disparity.\n" \
     " ?      Print this message.\n" << std::endl;
 }
@@ -76,13 +115,26 @@ void disparity::parse(int argc, char*argv[]) {
     {"help",no_argument,0,'h'},
     {"range",required_argument,0,'r'},
     {"line",required_argument,0,'l'},
+    {"window",required_argument,0,'w'},
+    {"threads",required_argument,0,'j'},
+    {"census",no_argument,0,'c'},
+    {"sgm",no_argument,0,'g'},
+    {"paths",required_argument,0,'p'},
+    {"bits",required_argument,0,'b'},
+    {"pyramid",required_argument,0,'y'},
+    {"check",no_argument,0,'k'},
+    {"slices",required_argument,0,'v'},
+    {"use-slices",required_argument,0,'u'},
+    {"sequence",no_argument,0,'s'},
+    {"first",required_argument,0,'f'},
+    {"output",required_argument,0,'o'},
     {0,0,0,0}
   };
 
   int optionIdx;
   line_=-1; // indicate that no line analysis is desired
 
-  while ((c = getopt_long(argc, argv, "hr:l:", lopts,&optionIdx)) != -1) {
+  while ((c = getopt_long(argc, argv, "hcgksr:l:w:j:p:b:y:f:o:v:u:", lopts,&optionIdx)) != -1) {
     switch (c) {
     case 'r':
       range_=atoi(optarg);
@@ -90,6 +142,48 @@ void disparity::parse(int argc, char*argv[]) {
     case 'l':
       line_=atoi(optarg);
       break;
+    case 'w':
+      windowSize_=atoi(optarg);
+      break;
+    case 'j':
+      threads_=atoi(optarg);
+      break;
+    case 'c':
+      census_=true;
+      break;
+    case 'g':
+      sgm_=true;
+      break;
+    case 'p':
+      paths_=atoi(optarg);
+      break;
+    case 'b':
+      costBits_=atoi(optarg);
+      break;
+    case 'y':
+      pyramid_=true;
+      levels_=atoi(optarg);
+      break;
+    case 'k':
+      check_=true;
+      break;
+    case 'v':
+      sliceFile_=optarg;
+      reuseSlices_=false;
+      break;
+    case 'u':
+      sliceFile_=optarg;
+      reuseSlices_=true;
+      break;
+    case 's':
+      sequence_=true;
+      break;
+    case 'f':
+      first_=atoi(optarg);
+      break;
+    case 'o':
+      output_=optarg;
+      break;
     case 'h':
       usage();
       exit(EXIT_SUCCESS);
@@ -118,6 +212,48 @@ void disparity::parse(int argc, char*argv[]) {
 
 }
 
+void disparity::shiftPhases(const lti::channel& right) {
+  lti::matrixTransform<float>::parameters mtPar;
+  mtPar.interpolatorParams.boundaryType = lti::Constant;
+  lti::matrixTransform<float> mt(mtPar);
+
+  for (int k=0;k<Phases;++k) {
+    mt.setMatrix(lti::translationMatrix(lti::fpoint(float(k)/Phases,0)));
+    mt.apply(right,phases_[k]);
+  }
+}
+
+void disparity::shiftedDifference(const int row,
+                                  const lti::channel& left,
+                                  const int quarters,
+                                  float* diff) const {
+  // quarters = n*Phases + k, with 0 <= k < Phases also for negative shifts
+  const int n = (quarters >= 0) ? quarters/Phases :
+                                  -((Phases-1-quarters)/Phases);
+  const int k = quarters - n*Phases;
+
+  const int cols = left.columns();
+  const int last = cols-1;
+  const float* l = &left.at(row,0);
+  const float* r = &phases_[k].at(row,0);
+  const float* r0 = &phases_[0].at(row,0);
+
+  // outside of the image the shifted right image is its border pixel
+  const int xa = lti::within(n,0,cols);
+  const int xb = lti::within(cols+n,xa,cols);
+  int x=0;
+  for (;x<xa;++x) {
+    diff[x] = lti::abs(l[x]-r0[0]);
+  }
+  const float* rn = r-n;
+  for (;x<xb;++x) {
+    diff[x] = lti::abs(l[x]-rn[x]);
+  }
+  for (;x<cols;++x) {
+    diff[x] = lti::abs(l[x]-r0[last]);
+  }
+}
+
 void disparity::lineDisparity(const int line,
 			      const lti::channel& left,
 			      const lti::channel& right,
@@ -128,38 +264,475 @@ void disparity::lineDisparity(const int line,
     return;
   }
 
-  lti::matrixTransform<float>::parameters mtPar;
-  mtPar.interpolatorParams.boundaryType = lti::Constant;
-  lti::matrixTransform<float> mt(mtPar);
-  lti::channel tmpDisparity,transRight;
+  if (slices_.isOpen()) {
+    lti::channel8 slice;
+    if (!slices_.getSlice(line,slice)) {
+      std::cerr << slices_.getStatusString() << std::endl;
+      return;
+    }
+    disparity.castFrom(slice);
+    return;
+  }
 
-  int pxStep=4; // numbers of steps per pixel (should be 2^x)
-  float step=1.0f/pxStep;
+  // one row per quarter pixel shift, all read from the phases_
+  disparity.allocate(Phases*range_*2+1,right.columns());
 
-  disparity.allocate(pxStep*range_*2+1,right.columns());
+  for (int q=-Phases*range_;q<=Phases*range_;++q) {
+    shiftedDifference(line,left,q,&disparity.at(q+Phases*range_,0));
+  }
+}
 
-  // This is _very_ inefficient code, but it is made "just for fun"
-  // Some day, a disparity functor will be made...
+/**
+ * Each item is an image row, whose line disparity is quantized to 8 bits
+ * and written directly into the mapped file.  The quarter pixel shifts
+ * are read from the phases_, so that no row needs any interpolation.
+ */
+class disparity::sliceJob : public lti::workerPool::job {
+public:
+  sliceJob(const disparity& owner,
+           const lti::channel& left,
+           lti::costSliceFile& slices,
+           const int workers)
+    : owner_(owner),left_(left),slices_(slices),
+      buffers_(workers,std::vector<float>(left.columns())) {
+  }
 
-  for (float i=-range_;i<=range_;i+=step) {
-    lti::fmatrix trans = lti::translationMatrix(lti::fpoint(i,0));
-    mt.setMatrix(trans);
-    mt.apply(right,transRight);
-    
-    tmpDisparity.subtract(left,transRight);
-    tmpDisparity.apply(lti::abs);
+  virtual void process(const int from,const int to,const int worker) {
+    const int cols = left_.columns();
+    const int first = slices_.firstShift()*slices_.shiftsPerPixel();
+    float* diff = &buffers_[worker][0];
+
+    for (int y=from;y<to;++y) {
+      lti::ubyte* slice = slices_.slice(y);
+      for (int i=0;i<slices_.shifts();++i) {
+        owner_.shiftedDifference(y,left_,first+i,diff);
+        lti::ubyte* costs = slice + i*cols;
+        for (int x=0;x<cols;++x) {
+          costs[x] = static_cast<lti::ubyte>(lti::min(diff[x]*255.0f+0.5f,
+                                                      255.0f));
+        }
+      }
+    }
+  }
+
+private:
+  const disparity& owner_;
+  const lti::channel& left_;
+  lti::costSliceFile& slices_;
+  std::vector< std::vector<float> > buffers_;
+};
+
+bool disparity::costSlices(const lti::channel& left) {
+  if (reuseSlices_) {
+    if (!slices_.open(sliceFile_)) {
+      std::cerr << "Cost slices '" << sliceFile_ << "' could not be read: "
+                << slices_.getStatusString() << std::endl;
+      return false;
+    }
+    if ((slices_.rows() != left.rows()) ||
+        (slices_.columns() != left.columns())) {
+      std::cerr << "Cost slices '" << sliceFile_
+                << "' belong to images of another size" << std::endl;
+      slices_.close();
+      return false;
+    }
+    return true;
+  }
 
-    disparity.getRow((i+range_)*pxStep).copy(tmpDisparity.getRow(line));
+  if (!slices_.create(sliceFile_,left.rows(),left.columns(),
+                      2*Phases*range_+1,-range_,Phases)) {
+    std::cerr << "Cost slices '" << sliceFile_ << "' could not be created: "
+              << slices_.getStatusString() << std::endl;
+    return false;
   }
+
+  lti::timer chrono;
+  chrono.start();
+
+  lti::workerPool pool(threads_);
+  sliceJob job(*this,left,slices_,pool.size());
+  pool.apply(job,left.rows(),4);
+
+  chrono.stop();
+
+  std::cout << "  Cost slices of " << left.rows() << " rows in "
+            << chrono.getTime()/1000.0 << " ms ("
+            << (double(left.rows())*left.columns()*slices_.shifts())/
+               (1024.0*1024.0)
+            << " MB)" << std::endl;
+
+  return true;
+}
+
+bool disparity::disparityMap(const lti::channel& left,
+                             const lti::channel& right,
+                             lti::channel& map,
+                             const bool verbose) {
+  lti::blockMatchingDisparity::parameters par;
+  par.minDisparity = -range_;
+  par.maxDisparity = range_;
+  par.windowSize = windowSize_;
+  par.threads = threads_;
+  par.cost = census_ ? lti::blockMatchingDisparity::Census :
+                       lti::blockMatchingDisparity::SAD;
+  par.leftRightCheck = check_;
+
+  lti::timer chrono;
+
+  if (sgm_) {
+    lti::semiGlobalMatching::parameters sgmPar;
+    sgmPar.matching.minDisparity = par.minDisparity;
+    sgmPar.matching.maxDisparity = par.maxDisparity;
+    sgmPar.matching.threads = par.threads;
+    sgmPar.matching.cost = par.cost;
+    sgmPar.paths = paths_;
+    sgmPar.costBits = costBits_;
+
+    lti::semiGlobalMatching sgm(sgmPar);
+
+    chrono.start();
+    if (!sgm.apply(left,right,map)) {
+      std::cerr << sgm.getStatusString() << std::endl;
+      return false;
+    }
+    chrono.stop();
+  } else if (pyramid_) {
+    lti::pyramidDisparity::parameters pyrPar;
+    pyrPar.matching.copy(par);
+    pyrPar.levels = levels_;
+
+    lti::pyramidDisparity pyr(pyrPar);
+
+    chrono.start();
+    if (!pyr.apply(left,right,map)) {
+      std::cerr << pyr.getStatusString() << std::endl;
+      return false;
+    }
+    chrono.stop();
+  } else {
+    lti::blockMatchingDisparity matcher(par);
+    lti::channel8 consistent;
+
+    chrono.start();
+    if (!(check_ ? matcher.apply(left,right,map,consistent) :
+                   matcher.apply(left,right,map))) {
+      std::cerr << matcher.getStatusString() << std::endl;
+      return false;
+    }
+    chrono.stop();
+
+    if (verbose && check_ && !consistent.empty()) {
+      int n = 0;
+      for (int y=0;y<consistent.rows();++y) {
+        for (int x=0;x<consistent.columns();++x) {
+          if (consistent.at(y,x) == 0) {
+            ++n;
+          }
+        }
+      }
+      std::cout << "  Inconsistent pixels filled: "
+                << (100.0*n)/(consistent.rows()*consistent.columns())
+                << "%" << std::endl;
+    }
+  }
+
+  if (verbose) {
+    std::cout << "  Disparity map in " << chrono.getTime()/1000.0 << " ms"
+              << std::endl;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------
+// Sequence mode
+// ---------------------------------------------------------------------
+
+/**
+ * A stereo pair with its disparity map.  The frames are allocated once
+ * and recycled, so that their channels keep their memory from one pair
+ * to the next.  The time stamps, in microseconds since the start of the
+ * pipeline, give the latency of each stage.
+ */
+struct disparity::frame {
+  int index;
+  bool ok;
+  lti::channel left;
+  lti::channel right;
+  lti::channel map;
+
+  double decodeStart;
+  double decodeEnd;
+  double computeStart;
+  double computeEnd;
+  double writeStart;
+  double writeEnd;
+};
+
+std::string disparity::fileName(const std::string& pattern,const int index) {
+  char buffer[1024];
+  snprintf(buffer,sizeof(buffer),pattern.c_str(),index);
+  return buffer;
+}
+
+/**
+ * Takes empty frames, decodes the next stereo pair into them and passes
+ * them on, so that the next pair is already decoded while the current
+ * one is computed.  The sequence ends with the first missing or
+ * unreadable file, signaled with a null frame.
+ */
+class disparity::decoderThread : public lti::thread {
+public:
+  decoderThread(const std::string& leftPattern,
+                const std::string& rightPattern,
+                const int first,
+                lti::boundedQueue<frame*>& empty,
+                lti::boundedQueue<frame*>& decoded,
+                const lti::timer& clock)
+    : leftPattern_(leftPattern),rightPattern_(rightPattern),first_(first),
+      empty_(empty),decoded_(decoded),clock_(clock),failed_(false) {
+  }
+
+  /**
+   * True if an image of the sequence could not be decoded
+   */
+  bool failed() const {
+    return failed_;
+  }
+
+protected:
+  virtual void run() {
+    for (int i=first_;;++i) {
+      const std::string leftFile = fileName(leftPattern_,i);
+      const std::string rightFile = fileName(rightPattern_,i);
+      if (!std::ifstream(leftFile.c_str()).good() ||
+          !std::ifstream(rightFile.c_str()).good()) {
+        break; // end of the sequence
+      }
+
+      frame* f;
+      empty_.pop(f);
+      f->index = i;
+      f->ok = true;
+      f->decodeStart = clock_.getTime();
+
+      if (!loader_.load(leftFile,img_)) {
+        std::cerr << "Image '" << leftFile << "' could not be read: "
+                  << loader_.getStatusString() << std::endl;
+        empty_.push(f);
+        failed_ = true;
+        break;
+      }
+      f->left.castFrom(img_);
+
+      if (!loader_.load(rightFile,img_)) {
+        std::cerr << "Image '" << rightFile << "' could not be read: "
+                  << loader_.getStatusString() << std::endl;
+        empty_.push(f);
+        failed_ = true;
+        break;
+      }
+      f->right.castFrom(img_);
+
+      f->decodeEnd = clock_.getTime();
+      decoded_.push(f);
+    }
+    decoded_.push(0);
+  }
+
+private:
+  const std::string leftPattern_;
+  const std::string rightPattern_;
+  const int first_;
+  lti::boundedQueue<frame*>& empty_;
+  lti::boundedQueue<frame*>& decoded_;
+  const lti::timer& clock_;
+
+  lti::ioImage loader_;
+  lti::image img_;
+  bool failed_;
+};
+
+/**
+ * Writes the disparity maps of the computed frames, scaled from
+ * [-range,range] to [0,255], and returns the frames to the decoder.  It
+ * also prints the latency of each stage for every pair.
+ */
+class disparity::writerThread : public lti::thread {
+public:
+  writerThread(const std::string& pattern,
+               const int range,
+               lti::boundedQueue<frame*>& computed,
+               lti::boundedQueue<frame*>& empty,
+               const lti::timer& clock)
+    : pattern_(pattern),range_(range),computed_(computed),empty_(empty),
+      clock_(clock),frames_(0),failed_(0),
+      decode_(0.0),compute_(0.0),write_(0.0),latency_(0.0),
+      first_(0.0),last_(0.0) {
+  }
+
+  /**
+   * Number of disparity maps written
+   */
+  int frames() const {
+    return frames_;
+  }
+
+  /**
+   * Number of pairs that could not be computed or written
+   */
+  int failed() const {
+    return failed_;
+  }
+
+  /**
+   * Print the mean latencies and the sustained rate
+   */
+  void report() const {
+    if (frames_ == 0) {
+      std::cout << "No stereo pair processed." << std::endl;
+      return;
+    }
+    std::cout << frames_ << " stereo pairs (" << failed_ << " failed) in "
+              << (last_-first_)/1000000.0 << " s: "
+              << frames_*1000000.0/(last_-first_) << " fps sustained\n"
+              << "  Mean decode:  " << decode_/(1000.0*frames_) << " ms\n"
+              << "  Mean compute: " << compute_/(1000.0*frames_) << " ms\n"
+              << "  Mean write:   " << write_/(1000.0*frames_) << " ms\n"
+              << "  Mean latency: " << latency_/(1000.0*frames_) << " ms"
+              << std::endl;
+  }
+
+protected:
+  virtual void run() {
+    frame* f;
+    computed_.pop(f);
+    while (f != 0) {
+      f->writeStart = clock_.getTime();
+      const std::string file = fileName(pattern_,f->index);
+      if (f->ok) {
+        // from [-range_,range_] to [0,1] as in the viewer
+        if (range_ > 0) {
+          f->map.add(static_cast<float>(range_));
+          f->map.multiply(0.5f/range_);
+        }
+        out_.castFrom(f->map);
+        if (!saver_.save(file,out_)) {
+          std::cerr << "Map '" << file << "' could not be written: "
+                    << saver_.getStatusString() << std::endl;
+          f->ok = false;
+        }
+      }
+      f->writeEnd = clock_.getTime();
+
+      if (f->ok) {
+        std::cout << "  Pair " << f->index
+                  << ": decode " << (f->decodeEnd-f->decodeStart)/1000.0
+                  << " ms, compute " << (f->computeEnd-f->computeStart)/1000.0
+                  << " ms, write " << (f->writeEnd-f->writeStart)/1000.0
+                  << " ms, latency " << (f->writeEnd-f->decodeStart)/1000.0
+                  << " ms" << std::endl;
+        if (frames_ == 0) {
+          first_ = f->decodeStart;
+        }
+        ++frames_;
+        decode_ += f->decodeEnd-f->decodeStart;
+        compute_ += f->computeEnd-f->computeStart;
+        write_ += f->writeEnd-f->writeStart;
+        latency_ += f->writeEnd-f->decodeStart;
+        last_ = f->writeEnd;
+      } else {
+        ++failed_;
+      }
+
+      empty_.push(f);
+      computed_.pop(f);
+    }
+  }
+
+private:
+  const std::string pattern_;
+  const int range_;
+  lti::boundedQueue<frame*>& computed_;
+  lti::boundedQueue<frame*>& empty_;
+  const lti::timer& clock_;
+
+  lti::ioImage saver_;
+  lti::channel8 out_;
+
+  /**
+   * Statistics, in microseconds
+   */
+  //@{
+  int frames_;
+  int failed_;
+  double decode_;
+  double compute_;
+  double write_;
+  double latency_;
+  double first_;
+  double last_;
+  //@}
+};
+
+bool disparity::sequence() {
+  // the frames are recycled through the empty queue, so that at most
+  // Frames pairs are in memory; each queue can hold all of them and the
+  // final null frame
+  std::vector<frame> frames(Frames);
+  lti::boundedQueue<frame*> empty(Frames+1);
+  lti::boundedQueue<frame*> decoded(Frames+1);
+  lti::boundedQueue<frame*> computed(Frames+1);
+  for (int i=0;i<Frames;++i) {
+    empty.push(&frames[i]);
+  }
+
+  lti::timer clock;
+  clock.start();
+
+  decoderThread decoder(imgFile1_,imgFile2_,first_,empty,decoded,clock);
+  writerThread writer(output_,range_,computed,empty,clock);
+  decoder.start();
+  writer.start();
+
+  // the disparity is computed in this thread, while the decoder reads
+  // the next pair and the writer saves the previous map
+  frame* f;
+  decoded.pop(f);
+  while (f != 0) {
+    f->computeStart = clock.getTime();
+    if (f->left.size() != f->right.size()) {
+      std::cerr << "Both images of pair " << f->index
+                << " must have the same size" << std::endl;
+      f->ok = false;
+    } else {
+      f->ok = disparityMap(f->left,f->right,f->map,false);
+    }
+    f->computeEnd = clock.getTime();
+    computed.push(f);
+    decoded.pop(f);
+  }
+  computed.push(0);
+
+  decoder.join();
+  writer.join();
+  clock.stop();
+
+  writer.report();
+  return (writer.frames() > 0) && (writer.failed() == 0) &&
+         !decoder.failed();
 }
 
 bool disparity::apply() {
 
+  if (sequence_) {
+    return sequence();
+  }
+
   help();
 
   lti::ioImage loader;
   lti::image img;
-  lti::channel left,right,disparity,transRight;
+  lti::channel left,right,disparity;
   lti::ipoint pos;
 
   if (!loader.load(imgFile1_,img)) {
@@ -176,12 +749,26 @@ bool disparity::apply() {
   }
   right.castFrom(img);
 
+  if (left.size() != right.size()) {
+    std::cerr << "Both images must have the same size" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // all shifts of the viewer and the line disparities are offsets into
+  // these, computed only once
+  shiftPhases(right);
+
+  if (!sliceFile_.empty() && !costSlices(left)) {
+    exit(EXIT_FAILURE);
+  }
+
   static lti::viewer2D lview("Left image");
   static lti::viewer2D rview("Right image");
   lview.show(left);
   rview.show(right);
 
   static lti::viewer2D ldview("Disparity at line");
+  static lti::viewer2D mapview("Disparity map");
 
   if ((line_>=0) && (line_<right.rows())) {
     lti::channel ld;
@@ -203,23 +790,17 @@ bool disparity::apply() {
   }
 
 
-  lti::matrixTransform<float>::parameters mtPar;
-  mtPar.interpolatorParams.boundaryType = lti::Constant;
-  lti::matrixTransform<float> mt(mtPar);
-  
-
   lti::viewer2D::interaction action;
   lti::viewer2D view("disparity");
 
-  float d = 0;
+  // displacement in quarter pixels
+  int d = 0;
 
   do {
-    lti::fmatrix trans = lti::translationMatrix(lti::fpoint(d,0));
-    mt.setMatrix(trans);
-    mt.apply(right,transRight);
-    
-    disparity.subtract(left,transRight);
-    disparity.apply(lti::abs);
+    disparity.allocate(left.size());
+    for (int y=0;y<left.rows();++y) {
+      shiftedDifference(y,left,d,&disparity.at(y,0));
+    }
 
     view.show(disparity);
     view.waitInteraction(action,pos);
@@ -231,17 +812,47 @@ bool disparity::apply() {
       case '?':
         help();
         break;
+      case 'c':
+        census_ = !census_;
+        std::cout << (census_ ? "Census" : "SAD") << " cost" << std::endl;
+        break;
+      case 'g':
+        sgm_ = !sgm_;
+        std::cout << (sgm_ ? "Semi-global matching" : "Block matching")
+                  << std::endl;
+        break;
+      case 'k':
+        check_ = !check_;
+        std::cout << "Left-right check " << (check_ ? "on" : "off")
+                  << std::endl;
+        break;
+      case 'y':
+        pyramid_ = !pyramid_;
+        std::cout << (pyramid_ ? "Coarse-to-fine" : "Full range")
+                  << " search" << std::endl;
+        break;
+      case 'm': {
+        lti::channel map;
+        disparityMap(left,right,map);
+
+        // from [-range_,range_] to [0,1] to see it
+        if (range_ > 0) {
+          map.add(static_cast<float>(range_));
+          map.multiply(0.5f/range_);
+        }
+        mapview.show(map);
+      } break;
       case '+':
       case lti::viewer2D::UpKey: 
       case lti::viewer2D::RightKey:
-	d+=0.25;
-        std::cout << "  Displacement: " << d << std::endl;
+	++d;
+        std::cout << "  Displacement: " << float(d)/Phases << std::endl;
         break;
       case '-':
       case lti::viewer2D::DownKey: 
       case lti::viewer2D::LeftKey: 
-	d-=0.25;
-        std::cout << "  Displacement: " << d << std::endl;
+	--d;
+        std::cout << "  Displacement: " << float(d)/Phases << std::endl;
         break;
       default:
         std::cout << "Key " << action.key << " unassigned" << std::endl;
@@ -46,6 +46,7 @@
 
 #include <string>
 #include <ltiChannel.h>
+#include "ltiCostSliceFile.h"
 
 /**
  * This class shows disparity measures between a stereo pair
@@ -101,11 +102,173 @@ private:
   int line_;
 
   /**
-   * Line disparity
+   * Window size of the disparity map
+   */
+  int windowSize_;
+
+  /**
+   * Number of threads of the disparity map (0: one per processor)
+   */
+  int threads_;
+
+  /**
+   * Census instead of SAD cost in the disparity map
+   */
+  bool census_;
+
+  /**
+   * Semi-global matching instead of block matching in the disparity map
+   */
+  bool sgm_;
+
+  /**
+   * Number of paths of the semi-global matching
+   */
+  int paths_;
+
+  /**
+   * Bits of the matching costs of the semi-global matching
+   */
+  int costBits_;
+
+  /**
+   * Coarse-to-fine search on Gaussian pyramids in the disparity map
+   */
+  bool pyramid_;
+
+  /**
+   * Number of coarser pyramid levels of the coarse-to-fine search
+   */
+  int levels_;
+
+  /**
+   * Left-right consistency check and filling of the inconsistent pixels
+   * of the block matching disparity map
+   */
+  bool check_;
+
+  /**
+   * Number of sub-pixel shifts per pixel of the right image
+   */
+  static const int Phases = 4;
+
+  /**
+   * Right image shifted by 0, 1/4, 2/4 and 3/4 pixels.  Any shift in
+   * quarter pixels is an integer offset into one of them.
+   */
+  lti::channel phases_[Phases];
+
+  /**
+   * Interpolate the phases_ of the given right image
+   */
+  void shiftPhases(const lti::channel& right);
+
+  /**
+   * Absolute difference between the row of the left image and the same
+   * row of the right image shifted by quarters/Phases pixels, read from
+   * the phases_ with the border pixels replicated
+   */
+  void shiftedDifference(const int row,
+                         const lti::channel& left,
+                         const int quarters,
+                         float* diff) const;
+
+  /**
+   * Line disparity: one row per quarter pixel shift in [-range_,range_],
+   * read from slices_ if it is open
    */
   void lineDisparity(const int line,
 		     const lti::channel& left,
 		     const lti::channel& right,
 		     lti::channel& disparity);
 
+  /**
+   * File with the cost slices of all rows
+   */
+  std::string sliceFile_;
+
+  /**
+   * Use the existing sliceFile_ instead of computing it
+   */
+  bool reuseSlices_;
+
+  /**
+   * The mapped sliceFile_, if any.  The line disparities are read from
+   * it.
+   */
+  lti::costSliceFile slices_;
+
+  /**
+   * Compute the line disparities of all rows in parallel and store them
+   * in sliceFile_, or map the existing file if reuseSlices_
+   */
+  bool costSlices(const lti::channel& left);
+
+  /**
+   * Line disparities of a set of rows, stored into slices_
+   */
+  class sliceJob;
+
+  /**
+   * Process the image files as a sequence of stereo pairs instead of
+   * showing them
+   */
+  bool sequence_;
+
+  /**
+   * Index of the first pair of the sequence
+   */
+  int first_;
+
+  /**
+   * Pattern of the names of the disparity maps written in sequence mode
+   */
+  std::string output_;
+
+  /**
+   * Number of stereo pairs in flight in sequence mode: one per stage, so
+   * that all stages can work at once but no pair waits in a queue for
+   * longer than one stage
+   */
+  static const int Frames = 3;
+
+  /**
+   * Name of a file of a sequence: the pattern with the index inserted as
+   * by printf
+   */
+  static std::string fileName(const std::string& pattern,const int index);
+
+  /**
+   * Compute the disparity maps of the numbered stereo pairs given by the
+   * file patterns imgFile1_ and imgFile2_, decoding, computing and
+   * writing in a pipeline of three threads.
+   * \return false if no pair was processed or any pair failed
+   */
+  bool sequence();
+
+  /**
+   * A stereo pair travelling through the sequence pipeline
+   */
+  struct frame;
+
+  /**
+   * First stage of the sequence pipeline: decodes the stereo pairs
+   */
+  class decoderThread;
+
+  /**
+   * Last stage of the sequence pipeline: writes the disparity maps
+   */
+  class writerThread;
+
+  /**
+   * Dense disparity map in [-range_,range_] by block matching, by
+   * semi-global matching or coarse to fine.  If verbose, the time and
+   * the share of filled pixels are printed.
+   */
+  bool disparityMap(const lti::channel& left,
+                    const lti::channel& right,
+                    lti::channel& map,
+                    const bool verbose=true);
+
 };
@@ -0,0 +1,865 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiBlockMatchingDisparity.cpp
+ *         Dense disparity of a rectified stereo pair by block matching.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiBlockMatchingDisparity.h"
+#include "ltiWorkerPool.h"
+#include "ltiMath.h"
+
+#include <vector>
+#include <limits>
+
+namespace lti {
+
+  // --------------------------------------------------
+  // blockMatchingDisparity::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  blockMatchingDisparity::parameters::parameters()
+    : functor::parameters() {
+    minDisparity = 0;
+    maxDisparity = 32;
+    windowSize = 9;
+    cost = SAD;
+    censusWidth = 9;
+    censusHeight = 7;
+    leftRightCheck = false;
+    maxDifference = 1;
+    fillInconsistent = true;
+    threads = 0;
+  }
+
+  // copy constructor
+  blockMatchingDisparity::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  blockMatchingDisparity::parameters::~parameters() {
+  }
+
+  // copy member
+  blockMatchingDisparity::parameters&
+  blockMatchingDisparity::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    minDisparity = other.minDisparity;
+    maxDisparity = other.maxDisparity;
+    windowSize = other.windowSize;
+    cost = other.cost;
+    censusWidth = other.censusWidth;
+    censusHeight = other.censusHeight;
+    leftRightCheck = other.leftRightCheck;
+    maxDifference = other.maxDifference;
+    fillInconsistent = other.fillInconsistent;
+    threads = other.threads;
+
+    return *this;
+  }
+
+  // alias for copy method
+  blockMatchingDisparity::parameters&
+  blockMatchingDisparity::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& blockMatchingDisparity::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  blockMatchingDisparity::parameters*
+  blockMatchingDisparity::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  blockMatchingDisparity::parameters*
+  blockMatchingDisparity::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  /*
+   * Write the parameters in the given ioHandler
+   */
+  bool blockMatchingDisparity::parameters::write(ioHandler& handler,
+                                                 const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"minDisparity",minDisparity) && b;
+      b = lti::write(handler,"maxDisparity",maxDisparity) && b;
+      b = lti::write(handler,"windowSize",windowSize) && b;
+      b = lti::write(handler,"cost",cost) && b;
+      b = lti::write(handler,"censusWidth",censusWidth) && b;
+      b = lti::write(handler,"censusHeight",censusHeight) && b;
+      b = lti::write(handler,"leftRightCheck",leftRightCheck) && b;
+      b = lti::write(handler,"maxDifference",maxDifference) && b;
+      b = lti::write(handler,"fillInconsistent",fillInconsistent) && b;
+      b = lti::write(handler,"threads",threads) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  /*
+   * Read the parameters from the given ioHandler
+   */
+  bool blockMatchingDisparity::parameters::read(ioHandler& handler,
+                                                const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"minDisparity",minDisparity) && b;
+      b = lti::read(handler,"maxDisparity",maxDisparity) && b;
+      b = lti::read(handler,"windowSize",windowSize) && b;
+      b = lti::read(handler,"cost",cost) && b;
+      b = lti::read(handler,"censusWidth",censusWidth) && b;
+      b = lti::read(handler,"censusHeight",censusHeight) && b;
+      b = lti::read(handler,"leftRightCheck",leftRightCheck) && b;
+      b = lti::read(handler,"maxDifference",maxDifference) && b;
+      b = lti::read(handler,"fillInconsistent",fillInconsistent) && b;
+      b = lti::read(handler,"threads",threads) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // blockMatchingDisparity::rowPointers
+  // --------------------------------------------------
+
+  void blockMatchingDisparity::rowPointers::use(const channel& left,
+                                                const channel& right) {
+    sigLeft.clear();
+    sigRight.clear();
+    valLeft.resize(left.rows());
+    valRight.resize(right.rows());
+    for (int y=0;y<left.rows();++y) {
+      valLeft[y] = &left.at(y,0);
+      valRight[y] = &right.at(y,0);
+    }
+  }
+
+  void blockMatchingDisparity::rowPointers::use(
+                                         const std::vector<signature>& left,
+                                         const std::vector<signature>& right,
+                                         const int columns) {
+    valLeft.clear();
+    valRight.clear();
+    const int rows = static_cast<int>(left.size())/columns;
+    sigLeft.resize(rows);
+    sigRight.resize(rows);
+    for (int y=0;y<rows;++y) {
+      sigLeft[y] = &left[y*columns];
+      sigRight[y] = &right[y*columns];
+    }
+  }
+
+  // --------------------------------------------------
+  // blockMatchingDisparity::censusJob
+  // --------------------------------------------------
+
+  /**
+   * Each item is a row.  The bits of each signature are ordered as the
+   * neighbors in a raster scan of the neighborhood, skipping the center.
+   */
+  class blockMatchingDisparity::censusJob : public workerPool::job {
+  public:
+    censusJob(const channel& src,
+              const int width,
+              const int height,
+              std::vector<signature>& sig)
+      : src_(src),rx_(width/2),ry_(height/2),sig_(sig) {
+    }
+
+    virtual void process(const int from,const int to,const int) {
+      const int rows = src_.rows();
+      const int cols = src_.columns();
+
+      for (int y=from;y<to;++y) {
+        const float* c = &src_.at(y,0);
+        signature* s = &sig_[y*cols];
+        for (int x=0;x<cols;++x) {
+          s[x] = 0;
+        }
+
+        for (int ky=-ry_;ky<=ry_;++ky) {
+          const float* n = &src_.at(within(y+ky,0,rows-1),0);
+          for (int kx=-rx_;kx<=rx_;++kx) {
+            if ((kx == 0) && (ky == 0)) {
+              continue;
+            }
+            // one bit of all signatures of the row: only the first and
+            // last columns need the replicated border
+            const int xa = within(-kx,0,cols);
+            const int xb = within(cols-kx,xa,cols);
+            int x=0;
+            for (;x<xa;++x) {
+              s[x] = (s[x] << 1) | ((n[0] < c[x]) ? 1 : 0);
+            }
+            const float* nk = n+kx;
+            for (;x<xb;++x) {
+              s[x] = (s[x] << 1) | ((nk[x] < c[x]) ? 1 : 0);
+            }
+            for (;x<cols;++x) {
+              s[x] = (s[x] << 1) | ((n[cols-1] < c[x]) ? 1 : 0);
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    const channel& src_;
+    const int rx_;
+    const int ry_;
+    std::vector<signature>& sig_;
+  };
+
+  // --------------------------------------------------
+  // blockMatchingDisparity::costJob
+  // --------------------------------------------------
+
+  /**
+   * Each item is a band of rows.  The worker keeps the column sums of the
+   * window for all disparities (numDisparities x columns), which are
+   * initialized at the first row of the band and then slid down one row
+   * at a time.  Together with the row of costs built from them, this is
+   * all the cost volume a worker ever holds, a block small enough to stay
+   * in the cache while the whole row is evaluated.
+   *
+   * The pixels are given as row pointers, to the values of the channels
+   * for the SAD and to the census signatures for the Hamming distance.
+   * If a cost volume is given with store(), the scaled window costs are
+   * also written into it.  With check(), the disparities of the right
+   * pixels are taken from the same row of costs, and each row of the
+   * left disparities is checked against them as soon as it is complete.
+   */
+  class blockMatchingDisparity::costJob : public workerPool::job {
+  public:
+    costJob(const parameters& par,
+            const int columns,
+            channel& disparity,
+            const int bandHeight,
+            const int workers)
+      : columns_(columns),disparity_(disparity),
+        minDisp_(par.minDisparity),
+        numDisp_(par.maxDisparity-par.minDisparity+1),
+        radius_(par.windowSize/2),
+        bandHeight_(bandHeight),
+        costs8_(0),costs16_(0),stride_(0),scale_(0.0f),maxCost_(0),
+        check_(false),maxDifference_(par.maxDifference),
+        fill_(par.fillInconsistent),consistent_(0),
+        data_(workers) {
+    }
+
+    /**
+     * Check the left-right consistency of the disparities, and write
+     * 255 for the consistent pixels and 0 for the others into the
+     * given channel, if any.
+     */
+    void check(channel8* consistent) {
+      check_ = true;
+      consistent_ = consistent;
+    }
+
+    /**
+     * Write the window cost of each pixel and disparity, multiplied by
+     * scale, rounded and saturated at maxCost, into
+     * costs[(y*columns+x)*stride + d-minDisparity].  Only one of both
+     * pointers may be non-null.
+     */
+    void store(ubyte* costs8,
+               int16* costs16,
+               const int stride,
+               const float scale,
+               const int maxCost) {
+      costs8_ = costs8;
+      costs16_ = costs16;
+      stride_ = stride;
+      scale_ = scale;
+      maxCost_ = maxCost;
+    }
+
+    /**
+     * Rows of the input to be matched
+     */
+    rowPointers& pixels() {
+      return pixels_;
+    }
+
+    virtual void process(const int from,const int to,const int worker) {
+      const int rows = pixels_.rows();
+      for (int band=from;band<to;++band) {
+        const int y0 = band*bandHeight_;
+        const int y1 = min(y0+bandHeight_,rows);
+        if (pixels_.census()) {
+          processBand(pixels_.sigLeft,pixels_.sigRight,y0,y1,data_[worker]);
+        } else {
+          processBand(pixels_.valLeft,pixels_.valRight,y0,y1,data_[worker]);
+        }
+      }
+    }
+
+  private:
+    /**
+     * Buffers private to each worker
+     */
+    struct workerData {
+      /**
+       * Column sums of the window, one row per disparity
+       */
+      std::vector<float> colSums;
+
+      /**
+       * Smallest cost found so far for each pixel of the row
+       */
+      std::vector<float> best;
+
+      /**
+       * Smallest cost found so far for each pixel of the right row, and
+       * its disparity
+       */
+      std::vector<float> bestRight;
+      std::vector<float> dispRight;
+
+      /**
+       * Consistency of each pixel of the row
+       */
+      std::vector<ubyte> consistent;
+    };
+
+    /**
+     * Add sign*cost(left(x),right(x-d)) to col[x] for all x, with the
+     * right row replicating its border pixels
+     */
+    template<class T>
+    void accumulate(const T* l,
+                    const T* r,
+                    const int d,
+                    const float sign,
+                    float* col) const {
+      const int cols = columns_;
+
+      // left part: x-d < 0
+      const int xa = within(d,0,cols);
+      // right part: x-d >= cols
+      const int xb = within(cols+d,xa,cols);
+
+      int x=0;
+      for (;x<xa;++x) {
+        col[x] += sign*cost(l[x],r[0]);
+      }
+      const T* rd = r-d;
+      for (;x<xb;++x) {
+        col[x] += sign*cost(l[x],rd[x]);
+      }
+      for (;x<cols;++x) {
+        col[x] += sign*cost(l[x],r[cols-1]);
+      }
+    }
+
+    /**
+     * Compute the disparities of the rows [y0,y1)
+     */
+    template<class T>
+    void processBand(const std::vector<const T*>& left,
+                     const std::vector<const T*>& right,
+                     const int y0,
+                     const int y1,
+                     workerData& w) const {
+      const int cols = columns_;
+      const int last = static_cast<int>(left.size())-1;
+      const int r = radius_;
+
+      w.colSums.assign(numDisp_*cols,0.0f);
+      w.best.resize(cols);
+      if (check_) {
+        w.bestRight.resize(cols);
+        w.dispRight.resize(cols);
+        w.consistent.resize(cols);
+      }
+
+      // column sums of the first window of the band
+      for (int k=-r;k<=r;++k) {
+        const int yy = within(y0+k,0,last);
+        for (int i=0;i<numDisp_;++i) {
+          accumulate(left[yy],right[yy],minDisp_+i,1.0f,&w.colSums[i*cols]);
+        }
+      }
+
+      for (int y=y0;y<y1;++y) {
+        if (y > y0) {
+          // slide the window one row down
+          const int yin  = within(y+r,0,last);
+          const int yout = within(y-r-1,0,last);
+          for (int i=0;i<numDisp_;++i) {
+            float* col = &w.colSums[i*cols];
+            accumulate(left[yin],right[yin],minDisp_+i,1.0f,col);
+            accumulate(left[yout],right[yout],minDisp_+i,-1.0f,col);
+          }
+        }
+
+        float* disp = &disparity_.at(y,0);
+        float* best = &w.best[0];
+        for (int x=0;x<cols;++x) {
+          best[x] = std::numeric_limits<float>::max();
+        }
+        if (check_) {
+          w.bestRight.assign(cols,std::numeric_limits<float>::max());
+        }
+
+        for (int i=0;i<numDisp_;++i) {
+          const float* col = &w.colSums[i*cols];
+          const float d = static_cast<float>(minDisp_+i);
+
+          // sliding sum along the row, replicating the border columns
+          float sum = 0.0f;
+          for (int k=-r;k<=r;++k) {
+            sum += col[within(k,0,cols-1)];
+          }
+          for (int x=0;x<cols;++x) {
+            if (sum < best[x]) {
+              best[x] = sum;
+              disp[x] = d;
+            }
+            if (check_) {
+              // the same cost matches the right pixel x-d
+              const int xr = x-minDisp_-i;
+              if ((xr >= 0) && (xr < cols) && (sum < w.bestRight[xr])) {
+                w.bestRight[xr] = sum;
+                w.dispRight[xr] = d;
+              }
+            }
+            if (costs8_ != 0) {
+              costs8_[(y*cols+x)*stride_+i] =
+                static_cast<ubyte>(quantize(sum));
+            } else if (costs16_ != 0) {
+              costs16_[(y*cols+x)*stride_+i] =
+                static_cast<int16>(quantize(sum));
+            }
+            sum += col[min(x+r+1,cols-1)] - col[max(x-r,0)];
+          }
+        }
+
+        if (check_) {
+          consistency(disp,w);
+          if (consistent_ != 0) {
+            ubyte* c = &consistent_->at(y,0);
+            for (int x=0;x<cols;++x) {
+              c[x] = w.consistent[x];
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * Check the disparities of the row against those of the right row
+     * in w, and fill the runs of inconsistent pixels if requested
+     */
+    void consistency(float* disp,workerData& w) const {
+      const int cols = columns_;
+      ubyte* ok = &w.consistent[0];
+
+      // a pixel whose match lies outside of the right image is occluded
+      for (int x=0;x<cols;++x) {
+        const int xr = x-iround(disp[x]);
+        ok[x] = ((xr >= 0) && (xr < cols) &&
+                 (abs(w.dispRight[xr]-disp[x]) <= maxDifference_)) ? 255 : 0;
+      }
+
+      if (!fill_) {
+        return;
+      }
+
+      int x=0;
+      while (x < cols) {
+        if (ok[x] != 0) {
+          ++x;
+          continue;
+        }
+        const int a = x;
+        while ((x < cols) && (ok[x] == 0)) {
+          ++x;
+        }
+        // [a,x) is a run of inconsistent pixels between consistent ones
+        float value;
+        if ((a > 0) && (x < cols)) {
+          value = min(disp[a-1],disp[x]);
+        } else if (a > 0) {
+          value = disp[a-1];
+        } else if (x < cols) {
+          value = disp[x];
+        } else {
+          return; // no consistent pixel in the whole row
+        }
+        for (int i=a;i<x;++i) {
+          disp[i] = value;
+        }
+      }
+    }
+
+    /**
+     * Scaled, rounded and saturated cost.  The sliding sums may drift
+     * slightly below zero.
+     */
+    inline int quantize(const float sum) const {
+      return within(static_cast<int>(sum*scale_+0.5f),0,maxCost_);
+    }
+
+    const int columns_;
+    channel& disparity_;
+    const int minDisp_;
+    const int numDisp_;
+    const int radius_;
+    const int bandHeight_;
+
+    /**
+     * Cost volume given with store(), if any
+     */
+    //@{
+    ubyte* costs8_;
+    int16* costs16_;
+    int stride_;
+    float scale_;
+    int maxCost_;
+    //@}
+
+    /**
+     * Left-right consistency check, see check()
+     */
+    //@{
+    bool check_;
+    const float maxDifference_;
+    const bool fill_;
+    channel8* consistent_;
+    //@}
+
+    /**
+     * Rows of the input
+     */
+    rowPointers pixels_;
+
+    std::vector<workerData> data_;
+  };
+
+  // --------------------------------------------------
+  // blockMatchingDisparity
+  // --------------------------------------------------
+
+  // default constructor
+  blockMatchingDisparity::blockMatchingDisparity()
+    : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
+  }
+
+  // default constructor
+  blockMatchingDisparity::blockMatchingDisparity(const parameters& par)
+    : functor() {
+    setParameters(par);
+  }
+
+  // copy constructor
+  blockMatchingDisparity::
+  blockMatchingDisparity(const blockMatchingDisparity& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  blockMatchingDisparity::~blockMatchingDisparity() {
+  }
+
+  // copy member
+  blockMatchingDisparity&
+  blockMatchingDisparity::copy(const blockMatchingDisparity& other) {
+    functor::copy(other);
+    return (*this);
+  }
+
+  // alias for copy member
+  blockMatchingDisparity&
+  blockMatchingDisparity::operator=(const blockMatchingDisparity& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& blockMatchingDisparity::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  blockMatchingDisparity* blockMatchingDisparity::clone() const {
+    return new blockMatchingDisparity(*this);
+  }
+
+  // create a new instance
+  blockMatchingDisparity* blockMatchingDisparity::newInstance() const {
+    return new blockMatchingDisparity();
+  }
+
+  // return parameters
+  const blockMatchingDisparity::parameters&
+  blockMatchingDisparity::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool blockMatchingDisparity::apply(const channel& left,
+                                     const channel& right,
+                                     channel& disparity) const {
+    return match(left,right,disparity,0,0,0,0);
+  }
+
+  bool blockMatchingDisparity::apply(const channel& left,
+                                     const channel& right,
+                                     channel& disparity,
+                                     channel8& consistent) const {
+    return match(left,right,disparity,0,0,0,0,&consistent);
+  }
+
+  bool blockMatchingDisparity::apply(const channel& left,
+                                     const channel& right,
+                                     const int maxCost,
+                                     const int stride,
+                                     std::vector<ubyte>& costs) const {
+    costs.assign(left.rows()*left.columns()*stride,
+                 static_cast<ubyte>(within(maxCost,0,255)));
+    if (costs.empty()) {
+      // nothing to store, but the inputs are still checked
+      channel disparity;
+      return match(left,right,disparity,0,0,0,0);
+    }
+    channel disparity;
+    return match(left,right,disparity,&costs[0],0,stride,maxCost);
+  }
+
+  bool blockMatchingDisparity::apply(const channel& left,
+                                     const channel& right,
+                                     const int maxCost,
+                                     const int stride,
+                                     std::vector<int16>& costs) const {
+    costs.assign(left.rows()*left.columns()*stride,
+                 static_cast<int16>(within(maxCost,0,32767)));
+    if (costs.empty()) {
+      // nothing to store, but the inputs are still checked
+      channel disparity;
+      return match(left,right,disparity,0,0,0,0);
+    }
+    channel disparity;
+    return match(left,right,disparity,0,&costs[0],stride,maxCost);
+  }
+
+  bool blockMatchingDisparity::census(const channel& src,
+                                      std::vector<signature>& sig) const {
+    const parameters& par = getParameters();
+
+    if ((par.censusWidth < 1) || ((par.censusWidth % 2) == 0) ||
+        (par.censusHeight < 1) || ((par.censusHeight % 2) == 0) ||
+        (par.censusWidth*par.censusHeight-1 > 64)) {
+      setStatusString("The census neighborhood must have odd sizes and at "
+                      "most 65 pixels");
+      return false;
+    }
+
+    sig.resize(src.rows()*src.columns());
+    if (src.empty()) {
+      return true;
+    }
+
+    workerPool pool(par.threads);
+    censusJob job(src,par.censusWidth,par.censusHeight,sig);
+    pool.apply(job,src.rows(),16);
+
+    return true;
+  }
+
+  bool blockMatchingDisparity::match(const channel& left,
+                                     const channel& right,
+                                     channel& disparity,
+                                     ubyte* costs8,
+                                     int16* costs16,
+                                     const int stride,
+                                     const int maxCost,
+                                     channel8* consistent) const {
+    const parameters& par = getParameters();
+
+    if (left.size() != right.size()) {
+      setStatusString("Both images must have the same size");
+      return false;
+    }
+    if (par.maxDisparity < par.minDisparity) {
+      setStatusString("maxDisparity must not be smaller than minDisparity");
+      return false;
+    }
+    if ((par.windowSize < 1) || ((par.windowSize % 2) == 0)) {
+      setStatusString("The window size must be odd");
+      return false;
+    }
+    if ((par.cost == Census) &&
+        ((par.censusWidth < 1) || ((par.censusWidth % 2) == 0) ||
+         (par.censusHeight < 1) || ((par.censusHeight % 2) == 0) ||
+         (par.censusWidth*par.censusHeight-1 > 64))) {
+      setStatusString("The census neighborhood must have odd sizes and at "
+                      "most 65 pixels");
+      return false;
+    }
+    if (par.maxDifference < 0) {
+      setStatusString("maxDifference must not be negative");
+      return false;
+    }
+    if (((costs8 != 0) || (costs16 != 0)) &&
+        (stride < par.maxDisparity-par.minDisparity+1)) {
+      setStatusString("The stride of the costs must not be smaller than "
+                      "the number of disparities");
+      return false;
+    }
+
+    disparity.allocate(left.size());
+    if (consistent != 0) {
+      consistent->allocate(left.size());
+    }
+    if (left.empty()) {
+      return true;
+    }
+
+    workerPool pool(par.threads);
+
+    // a few bands per worker balance the load, while the bands are still
+    // much taller than the window whose column sums each one initializes
+    const int bands = min(left.rows(),4*pool.size());
+    const int bandHeight = (left.rows()+bands-1)/bands;
+
+    costJob job(par,left.columns(),disparity,bandHeight,pool.size());
+
+    // the stored costs are the mean cost per pixel of the window, scaled
+    // so that the largest possible one is maxCost
+    const float area = static_cast<float>(par.windowSize*par.windowSize);
+    const float range = (par.cost == Census) ?
+      static_cast<float>(par.censusWidth*par.censusHeight-1) : 1.0f;
+    job.store(costs8,costs16,stride,maxCost/(area*range),maxCost);
+    if (par.leftRightCheck || (consistent != 0)) {
+      job.check(consistent);
+    }
+
+    std::vector<signature> sigLeft,sigRight;
+    if (par.cost == Census) {
+      sigLeft.resize(left.rows()*left.columns());
+      sigRight.resize(right.rows()*right.columns());
+      censusJob cl(left,par.censusWidth,par.censusHeight,sigLeft);
+      pool.apply(cl,left.rows(),16);
+      censusJob cr(right,par.censusWidth,par.censusHeight,sigRight);
+      pool.apply(cr,right.rows(),16);
+      job.pixels().use(sigLeft,sigRight,left.columns());
+    } else {
+      job.pixels().use(left,right);
+    }
+
+    pool.apply(job,(left.rows()+bandHeight-1)/bandHeight);
+
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // Storable interface
+  // -------------------------------------------------------------------
+
+  bool read(ioHandler& handler,blockMatchingDisparity::eCostType& data) {
+    std::string str;
+    if (handler.read(str)) {
+      if (str.find("ensus") != std::string::npos) {
+        data = blockMatchingDisparity::Census;
+      } else {
+        data = blockMatchingDisparity::SAD;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool write(ioHandler& handler,
+             const blockMatchingDisparity::eCostType& data) {
+    switch(data) {
+    case blockMatchingDisparity::Census:
+      return handler.write("Census");
+    default:
+      return handler.write("SAD");
+    }
+    return false;
+  }
+
+}
@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiBlockMatchingDisparity.h
+ *         Dense disparity of a rectified stereo pair by block matching.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_BLOCK_MATCHING_DISPARITY_H_
+#define _LTI_BLOCK_MATCHING_DISPARITY_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+#include "ltiMath.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Block matching disparity.
+   *
+   * Computes the dense disparity map of a rectified stereo pair: the
+   * pixel (x,y) of the left image corresponds to the pixel (x-d,y) of the
+   * right one, and the disparity d in [parameters::minDisparity,
+   * parameters::maxDisparity] is the one with the smallest sum of
+   * absolute differences (SAD) over a square window of
+   * parameters::windowSize pixels.  Pixels outside of the images are
+   * replaced by the nearest border pixel.
+   *
+   * With parameters::cost set to Census, the absolute differences are
+   * replaced by the Hamming distance between census signatures: each
+   * pixel is described by a 64-bit word with one bit per pixel of a
+   * parameters::censusWidth x parameters::censusHeight neighborhood,
+   * set if that neighbor is darker than the center.  The signature only
+   * depends on the order of the gray values, so that the cost does not
+   * change with the gain or the offset of the exposure of each camera.
+   * The distance of two signatures is the population count of their
+   * exclusive or, a single instruction on processors with popcount.
+   *
+   * The costs are never computed window by window.  For each row, the
+   * SAD of all disparities (one row of the cost volume) is obtained
+   * with sliding sums: the column sums of the window are updated with
+   * the absolute differences of the entering and the leaving rows, and a
+   * second sliding sum along the row adds them horizontally.  Each cost
+   * then takes four additions, whatever the window size.  The rows are
+   * split into bands processed in parallel by a lti::workerPool; each
+   * band starts its own column sums, so that the rounding errors of the
+   * sliding sums cannot accumulate over the whole image.
+   *
+   * The window costs of left pixel x with disparity d are also those of
+   * right pixel x-d with the same disparity, so that with
+   * parameters::leftRightCheck the disparities of the right image are
+   * taken from the same row of costs, without a second cost volume.
+   * Pixels whose match in the right image does not match them back are
+   * occluded in the right image or mismatched; they are detected and
+   * optionally filled row by row, right after the row is computed.
+   *
+   * Example:
+   * \code
+   * lti::blockMatchingDisparity::parameters par;
+   * par.minDisparity = 0;
+   * par.maxDisparity = 64;
+   * lti::blockMatchingDisparity matcher(par);
+   * lti::channel disp;
+   * matcher.apply(left,right,disp);
+   * \endcode
+   */
+  class blockMatchingDisparity : public functor {
+  public:
+    /**
+     * Matching cost of two pixels
+     */
+    enum eCostType {
+      SAD,   /**< Absolute difference of the values */
+      Census /**< Hamming distance of the census signatures */
+    };
+
+    /**
+     * Census signature of one pixel
+     */
+    typedef unsigned long long signature;
+
+    /**
+     * The parameters for the class blockMatchingDisparity
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Smallest disparity searched.
+       *
+       * Default value: 0
+       */
+      int minDisparity;
+
+      /**
+       * Largest disparity searched.
+       *
+       * Default value: 32
+       */
+      int maxDisparity;
+
+      /**
+       * Size of the square matching window.  It must be odd.
+       *
+       * Default value: 9
+       */
+      int windowSize;
+
+      /**
+       * Matching cost of two pixels.
+       *
+       * Default value: SAD
+       */
+      eCostType cost;
+
+      /**
+       * Width of the neighborhood of the census signatures.  It must be
+       * odd, and censusWidth*censusHeight-1 must not exceed 64.
+       *
+       * Default value: 9
+       */
+      int censusWidth;
+
+      /**
+       * Height of the neighborhood of the census signatures.  It must be
+       * odd, and censusWidth*censusHeight-1 must not exceed 64.
+       *
+       * Default value: 7
+       */
+      int censusHeight;
+
+      /**
+       * If true, the disparity of the right image is also computed from
+       * the same costs, and the pixels whose left and right disparities
+       * differ by more than maxDifference are marked as inconsistent.
+       *
+       * Default value: false
+       */
+      bool leftRightCheck;
+
+      /**
+       * Largest difference between the disparity of a left pixel and the
+       * one of its match in the right image for the pixel to be
+       * consistent.
+       *
+       * Default value: 1
+       */
+      int maxDifference;
+
+      /**
+       * If true, each run of inconsistent pixels of a row gets the
+       * smaller disparity of the consistent pixels at its ends, i.e. the
+       * one of the farther surface, which is the one occluded in the
+       * right image.  Only used with leftRightCheck.
+       *
+       * Default value: true
+       */
+      bool fillInconsistent;
+
+      /**
+       * Number of threads.  If zero, one per processor.
+       *
+       * Default value: 0
+       */
+      int threads;
+    };
+
+    /**
+     * Default constructor
+     */
+    blockMatchingDisparity();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    blockMatchingDisparity(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    blockMatchingDisparity(const blockMatchingDisparity& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~blockMatchingDisparity();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    blockMatchingDisparity& copy(const blockMatchingDisparity& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    blockMatchingDisparity& operator=(const blockMatchingDisparity& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual blockMatchingDisparity* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual blockMatchingDisparity* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Compute the disparity map of the given stereo pair.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param disparity disparity of each pixel of the left image
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               channel& disparity) const;
+
+    /**
+     * Compute the disparity map of the given stereo pair with the left-right
+     * consistency check, even if parameters::leftRightCheck is false.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param disparity disparity of each pixel of the left image
+     * @param consistent 255 for the consistent pixels, 0 for the others
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               channel& disparity,
+               channel8& consistent) const;
+
+    /**
+     * Compute the matching cost of each pixel of the left image for each
+     * disparity, e.g. for a later aggregation.  Each cost is the mean
+     * cost per pixel of the window, scaled so that the largest possible
+     * value (1 for SAD, the number of bits for Census) becomes maxCost,
+     * rounded and saturated.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param maxCost largest cost, at most 255
+     * @param stride number of costs per pixel, at least the number of
+     *               disparities.  The entries of the disparities beyond
+     *               the last one are set to maxCost.
+     * @param costs the cost of disparity d at (x,y) is
+     *              costs[(y*columns+x)*stride + d-minDisparity]
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               const int maxCost,
+               const int stride,
+               std::vector<ubyte>& costs) const;
+
+    /**
+     * Compute the matching cost of each pixel of the left image for each
+     * disparity, e.g. for a later aggregation.  Each cost is the mean
+     * cost per pixel of the window, scaled so that the largest possible
+     * value (1 for SAD, the number of bits for Census) becomes maxCost,
+     * rounded and saturated.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param maxCost largest cost, at most 32767
+     * @param stride number of costs per pixel, at least the number of
+     *               disparities.  The entries of the disparities beyond
+     *               the last one are set to maxCost.
+     * @param costs the cost of disparity d at (x,y) is
+     *              costs[(y*columns+x)*stride + d-minDisparity]
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               const int maxCost,
+               const int stride,
+               std::vector<int16>& costs) const;
+
+    /**
+     * Compute the census signatures of all pixels of the given channel,
+     * with the neighborhood given by parameters::censusWidth and
+     * parameters::censusHeight.
+     *
+     * @param src channel whose pixels are described
+     * @param sig the signature of (x,y) is sig[y*columns+x]
+     * @return true if successful, false otherwise
+     */
+    bool census(const channel& src,std::vector<signature>& sig) const;
+
+    /**
+     * Matching cost of two values: their absolute difference
+     */
+    static inline float cost(const float a,const float b);
+
+    /**
+     * Matching cost of two census signatures: their Hamming distance
+     */
+    static inline float cost(const signature a,const signature b);
+
+    /**
+     * Rows of a stereo pair to be matched, through which the matching jobs
+     * of this class and of lti::pyramidDisparity read the pixels: the
+     * values of the channels for the SAD, or their census signatures.
+     * Only one of both pairs of row vectors is not empty.
+     */
+    class rowPointers {
+    public:
+      /**
+       * Match the values of both channels
+       */
+      void use(const channel& left,const channel& right);
+
+      /**
+       * Match the census signatures of both channels, with the given
+       * number of columns
+       */
+      void use(const std::vector<signature>& left,
+               const std::vector<signature>& right,
+               const int columns);
+
+      /**
+       * True if the census signatures are matched
+       */
+      inline bool census() const;
+
+      /**
+       * Number of rows
+       */
+      inline int rows() const;
+
+      /**
+       * Rows of the values of the channels
+       */
+      //@{
+      std::vector<const float*> valLeft,valRight;
+      //@}
+
+      /**
+       * Rows of the census signatures
+       */
+      //@{
+      std::vector<const signature*> sigLeft,sigRight;
+      //@}
+    };
+
+  protected:
+    /**
+     * Number of bits set in a signature
+     */
+    static inline int popcount(const signature w);
+
+    /**
+     * Disparities and, if any of the pointers is not null, the costs and
+     * the consistency of all pixels
+     */
+    bool match(const channel& left,
+               const channel& right,
+               channel& disparity,
+               ubyte* costs8,
+               int16* costs16,
+               const int stride,
+               const int maxCost,
+               channel8* consistent = 0) const;
+
+    /**
+     * Rows of the cost volume and their minima, computed in parallel
+     */
+    class costJob;
+
+    /**
+     * Census signatures of the rows, computed in parallel
+     */
+    class censusJob;
+  };
+
+  // --------------------------------------------------
+  // inline implementation
+  // --------------------------------------------------
+
+  inline int blockMatchingDisparity::popcount(const signature w) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    int n = 0;
+    for (signature v = w;v != 0;v &= v-1) {
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  inline float blockMatchingDisparity::cost(const float a,const float b) {
+    return abs(a-b);
+  }
+
+  inline float blockMatchingDisparity::cost(const signature a,
+                                            const signature b) {
+    return static_cast<float>(popcount(a^b));
+  }
+
+  inline bool blockMatchingDisparity::rowPointers::census() const {
+    return !sigLeft.empty();
+  }
+
+  inline int blockMatchingDisparity::rowPointers::rows() const {
+    return static_cast<int>(census() ? sigLeft.size() : valLeft.size());
+  }
+
+  /**
+   * Read a blockMatchingDisparity::eCostType
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler,blockMatchingDisparity::eCostType& data);
+
+  /**
+   * Write a blockMatchingDisparity::eCostType
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,
+             const blockMatchingDisparity::eCostType& data);
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiCostSliceFile.cpp
+ *         Memory mapped file with the 8-bit matching costs of all rows of
+ *         a stereo pair.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiCostSliceFile.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace lti {
+
+  /*
+   * Size of the file header in bytes
+   */
+  static const int HeaderSize = 64;
+
+  /*
+   * Magic string at the beginning of the file
+   */
+  static const char Magic[] = "LTICOST1";
+
+  costSliceFile::costSliceFile()
+    : object(),status(),data_(0),size_(0),writable_(false),
+      rows_(0),columns_(0),shifts_(0),firstShift_(0),shiftsPerPixel_(1) {
+  }
+
+  costSliceFile::~costSliceFile() {
+    close();
+  }
+
+  bool costSliceFile::create(const std::string& filename,
+                             const int rows,
+                             const int columns,
+                             const int shifts,
+                             const int firstShift,
+                             const int shiftsPerPixel) {
+    close();
+
+    if ((rows <= 0) || (columns <= 0) || (shifts <= 0) ||
+        (shiftsPerPixel <= 0)) {
+      setStatusString("Invalid size of the cost slices");
+      return false;
+    }
+
+    const int fd = ::open(filename.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+    if (fd < 0) {
+      setStatusString("Could not create file " + filename);
+      return false;
+    }
+
+    // the header is written with the file, the slices are filled later
+    // through the mapping
+    char header[HeaderSize];
+    memset(header,0,HeaderSize);
+    memcpy(header,Magic,8);
+    const int32 values[5] = {rows,columns,shifts,firstShift,shiftsPerPixel};
+    memcpy(header+8,values,sizeof(values));
+
+    const off_t size = static_cast<off_t>(HeaderSize) +
+      static_cast<off_t>(rows)*columns*shifts;
+
+    if ((::write(fd,header,HeaderSize) != HeaderSize) ||
+        (::ftruncate(fd,size) != 0)) {
+      ::close(fd);
+      setStatusString("Could not write file " + filename);
+      return false;
+    }
+
+    const bool ok = map(fd,true);
+    ::close(fd);
+    return ok;
+  }
+
+  bool costSliceFile::open(const std::string& filename) {
+    close();
+
+    const int fd = ::open(filename.c_str(),O_RDONLY);
+    if (fd < 0) {
+      setStatusString("Could not open file " + filename);
+      return false;
+    }
+
+    const bool ok = map(fd,false);
+    ::close(fd);
+    return ok;
+  }
+
+  bool costSliceFile::map(const int fd,const bool writable) {
+    struct stat info;
+    if ((fstat(fd,&info) != 0) || (info.st_size < HeaderSize)) {
+      setStatusString("Not a cost slice file");
+      return false;
+    }
+
+    void* ptr = mmap(0,static_cast<size_t>(info.st_size),
+                     writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                     MAP_SHARED,fd,0);
+    if (ptr == MAP_FAILED) {
+      setStatusString("Could not map the cost slice file");
+      return false;
+    }
+    data_ = static_cast<ubyte*>(ptr);
+    size_ = static_cast<size_t>(info.st_size);
+    writable_ = writable;
+
+    int32 values[5];
+    memcpy(values,data_+8,sizeof(values));
+    rows_ = values[0];
+    columns_ = values[1];
+    shifts_ = values[2];
+    firstShift_ = values[3];
+    shiftsPerPixel_ = values[4];
+
+    if ((memcmp(data_,Magic,8) != 0) ||
+        (rows_ <= 0) || (columns_ <= 0) || (shifts_ <= 0) ||
+        (shiftsPerPixel_ <= 0) ||
+        (size_ != static_cast<size_t>(HeaderSize) +
+                  static_cast<size_t>(rows_)*columns_*shifts_)) {
+      close();
+      setStatusString("Not a cost slice file");
+      return false;
+    }
+
+    return true;
+  }
+
+  void costSliceFile::close() {
+    if (data_ != 0) {
+      munmap(data_,size_);
+    }
+    data_ = 0;
+    size_ = 0;
+    writable_ = false;
+    rows_ = columns_ = shifts_ = firstShift_ = 0;
+    shiftsPerPixel_ = 1;
+  }
+
+  bool costSliceFile::isOpen() const {
+    return (data_ != 0);
+  }
+
+  int costSliceFile::rows() const {
+    return rows_;
+  }
+
+  int costSliceFile::columns() const {
+    return columns_;
+  }
+
+  int costSliceFile::shifts() const {
+    return shifts_;
+  }
+
+  int costSliceFile::firstShift() const {
+    return firstShift_;
+  }
+
+  int costSliceFile::shiftsPerPixel() const {
+    return shiftsPerPixel_;
+  }
+
+  ubyte* costSliceFile::slice(const int row) {
+    if (!writable_ || (row < 0) || (row >= rows_)) {
+      return 0;
+    }
+    return data_ + HeaderSize + static_cast<size_t>(row)*columns_*shifts_;
+  }
+
+  const ubyte* costSliceFile::slice(const int row) const {
+    if ((data_ == 0) || (row < 0) || (row >= rows_)) {
+      return 0;
+    }
+    return data_ + HeaderSize + static_cast<size_t>(row)*columns_*shifts_;
+  }
+
+  bool costSliceFile::getSlice(const int row,channel8& dest) const {
+    const ubyte* src = slice(row);
+    if (src == 0) {
+      setStatusString("Invalid row of the cost slices");
+      return false;
+    }
+
+    dest.allocate(shifts_,columns_);
+    for (int i=0;i<shifts_;++i) {
+      memcpy(&dest.at(i,0),src+i*columns_,columns_);
+    }
+    return true;
+  }
+
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiCostSliceFile.h
+ *         Memory mapped file with the 8-bit matching costs of all rows of
+ *         a stereo pair.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_COST_SLICE_FILE_H_
+#define _LTI_COST_SLICE_FILE_H_
+
+#include "ltiObject.h"
+#include "ltiStatus.h"
+#include "ltiTypes.h"
+#include "ltiChannel8.h"
+
+#include <string>
+
+namespace lti {
+
+  /**
+   * File of cost slices.
+   *
+   * A cost slice of an image row is a disparity-space image: one row
+   * for each shift of the right image and one column for each pixel,
+   * holding the matching cost of that pixel with that shift.  This class
+   * stores the slices of all rows of an image in one file, with the
+   * costs quantized to 8 bits, and maps the file into memory, so that the
+   * slice of any row is available at once without reading the whole
+   * file, and several processes can share it.
+   *
+   * The file has a header of 64 bytes, followed by the slices in the
+   * order of the image rows.  The header starts with the magic string
+   * "LTICOST1", followed by five 32-bit integers in the byte order of the
+   * machine: the number of rows and columns of the image, the number of
+   * shifts, the first shift and the number of shifts per pixel, so that
+   * the row i of each slice holds the costs of the shift
+   * firstShift + i/shiftsPerPixel.
+   *
+   * Example:
+   * \code
+   * lti::costSliceFile file;
+   * if (file.open("costs.slc")) {
+   *   lti::channel8 slice;
+   *   file.getSlice(240,slice);
+   * }
+   * \endcode
+   */
+  class costSliceFile : public object, public status {
+  public:
+    /**
+     * Default constructor
+     */
+    costSliceFile();
+
+    /**
+     * Destructor.  Unmaps and closes the file if still open.
+     */
+    virtual ~costSliceFile();
+
+    /**
+     * Create a file for the slices of an image of the given size, and map
+     * it for writing the slices with slice().  An existing file is
+     * overwritten.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool create(const std::string& filename,
+                const int rows,
+                const int columns,
+                const int shifts,
+                const int firstShift,
+                const int shiftsPerPixel);
+
+    /**
+     * Map an existing file for reading.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmap and close the file.  Everything written into a created file
+     * is stored.
+     */
+    void close();
+
+    /**
+     * True if a file is mapped
+     */
+    bool isOpen() const;
+
+    /**
+     * Number of rows of the image
+     */
+    int rows() const;
+
+    /**
+     * Number of columns of the image
+     */
+    int columns() const;
+
+    /**
+     * Number of shifts, i.e. rows of each slice
+     */
+    int shifts() const;
+
+    /**
+     * Shift of the first row of each slice
+     */
+    int firstShift() const;
+
+    /**
+     * Number of shifts per pixel
+     */
+    int shiftsPerPixel() const;
+
+    /**
+     * Costs of the given image row, shifts() rows of columns() costs.
+     * Only a created file can be written.
+     */
+    ubyte* slice(const int row);
+
+    /**
+     * Costs of the given image row, shifts() rows of columns() costs
+     */
+    const ubyte* slice(const int row) const;
+
+    /**
+     * Copy the slice of the given image row into a channel of shifts()
+     * rows and columns() columns.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool getSlice(const int row,channel8& dest) const;
+
+  private:
+    /**
+     * Map the file of the given descriptor, with the given protection,
+     * and check its header
+     */
+    bool map(const int fd,const bool writable);
+
+    /**
+     * The mapped file, or null
+     */
+    ubyte* data_;
+
+    /**
+     * Size of the mapping in bytes
+     */
+    size_t size_;
+
+    /**
+     * True if the file can be written
+     */
+    bool writable_;
+
+    /**
+     * Header values
+     */
+    //@{
+    int rows_;
+    int columns_;
+    int shifts_;
+    int firstShift_;
+    int shiftsPerPixel_;
+    //@}
+
+    /**
+     * Disable copy
+     */
+    costSliceFile(const costSliceFile&);
+    costSliceFile& operator=(const costSliceFile&);
+  };
+
+}
+
+#endif
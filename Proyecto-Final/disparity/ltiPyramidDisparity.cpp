@@ -0,0 +1,598 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiPyramidDisparity.cpp
+ *         Dense disparity of a rectified stereo pair, searched from coarse
+ *         to fine on Gaussian pyramids.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiPyramidDisparity.h"
+#include "ltiWorkerPool.h"
+#include "ltiMath.h"
+
+#include <vector>
+#include <limits>
+
+namespace lti {
+
+  // --------------------------------------------------
+  // pyramidDisparity::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  pyramidDisparity::parameters::parameters()
+    : functor::parameters() {
+    levels = 3;
+    searchRadius = 2;
+    subpixel = true;
+  }
+
+  // copy constructor
+  pyramidDisparity::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  pyramidDisparity::parameters::~parameters() {
+  }
+
+  // copy member
+  pyramidDisparity::parameters&
+  pyramidDisparity::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    matching.copy(other.matching);
+    levels = other.levels;
+    searchRadius = other.searchRadius;
+    subpixel = other.subpixel;
+
+    return *this;
+  }
+
+  // alias for copy method
+  pyramidDisparity::parameters&
+  pyramidDisparity::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& pyramidDisparity::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  pyramidDisparity::parameters*
+  pyramidDisparity::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  pyramidDisparity::parameters*
+  pyramidDisparity::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  /*
+   * Write the parameters in the given ioHandler
+   */
+  bool pyramidDisparity::parameters::write(ioHandler& handler,
+                                           const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"matching",matching) && b;
+      b = lti::write(handler,"levels",levels) && b;
+      b = lti::write(handler,"searchRadius",searchRadius) && b;
+      b = lti::write(handler,"subpixel",subpixel) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  /*
+   * Read the parameters from the given ioHandler
+   */
+  bool pyramidDisparity::parameters::read(ioHandler& handler,
+                                          const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"matching",matching) && b;
+      b = lti::read(handler,"levels",levels) && b;
+      b = lti::read(handler,"searchRadius",searchRadius) && b;
+      b = lti::read(handler,"subpixel",subpixel) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  /*
+   * Largest integer not greater than a/b, for b > 0
+   */
+  static inline int floorDiv(const int a,const int b) {
+    return (a >= 0) ? a/b : -((b-1-a)/b);
+  }
+
+  /*
+   * Smallest integer not smaller than a/b, for b > 0
+   */
+  static inline int ceilDiv(const int a,const int b) {
+    return -floorDiv(-a,b);
+  }
+
+  // --------------------------------------------------
+  // pyramidDisparity::refineJob
+  // --------------------------------------------------
+
+  /**
+   * Each item is a row.  The disparity of each pixel is predicted from
+   * the coarser map, scaled by factor, and only the candidates around
+   * it, plus one more on each side for the parabola, are evaluated.
+   *
+   * The window costs are the sliding sums of blockMatchingDisparity,
+   * restricted to the candidates of each pixel: the predictions of
+   * neighboring pixels are usually equal or close, so that each
+   * disparity is a candidate of a few runs of consecutive pixels.  For
+   * each run, the column sums of the window are computed directly and
+   * slid along the run.  The border pixels are replicated as in
+   * blockMatchingDisparity, so that the costs are the same.
+   *
+   * The pixels are given as row pointers, to the values of the channels
+   * for the SAD and to the census signatures for the Hamming distance.
+   */
+  class pyramidDisparity::refineJob : public workerPool::job {
+  public:
+    typedef blockMatchingDisparity::signature signature;
+
+    refineJob(const channel& coarse,
+              const int factor,
+              const int minDisparity,
+              const int maxDisparity,
+              const int windowSize,
+              const int searchRadius,
+              const bool subpixel,
+              channel& disparity,
+              const int workers)
+      : coarse_(coarse),factor_(factor),
+        minDisp_(minDisparity),maxDisp_(maxDisparity),
+        radius_(windowSize/2),searchRadius_(searchRadius),
+        subpixel_(subpixel),disparity_(disparity),data_(workers) {
+    }
+
+    /**
+     * Rows of the input to be matched
+     */
+    blockMatchingDisparity::rowPointers& pixels() {
+      return pixels_;
+    }
+
+    virtual void process(const int from,const int to,const int worker) {
+      for (int y=from;y<to;++y) {
+        if (pixels_.census()) {
+          processRow(pixels_.sigLeft,pixels_.sigRight,y,data_[worker]);
+        } else {
+          processRow(pixels_.valLeft,pixels_.valRight,y,data_[worker]);
+        }
+      }
+    }
+
+  private:
+    /**
+     * Buffers private to each worker
+     */
+    struct workerData {
+      /**
+       * First candidate of each pixel of the row
+       */
+      std::vector<int> first;
+
+      /**
+       * Costs of the candidates of each pixel of the row
+       */
+      std::vector<float> costs;
+
+      /**
+       * Column sums of the window for one disparity
+       */
+      std::vector<float> col;
+    };
+
+    /**
+     * Costs of disparity d for the pixels [xa,xb] of the row, whose
+     * windows have the rows l and r.  The cost of pixel x is written
+     * into w.costs[x*candidates + d-w.first[x]].
+     */
+    template<class T>
+    void evaluate(const T* const* l,
+                  const T* const* r,
+                  const int d,
+                  const int xa,
+                  const int xb,
+                  const int candidates,
+                  workerData& w) const {
+      const int cols = disparity_.columns();
+      const int rad = radius_;
+      const int size = 2*rad+1;
+
+      // column sums of all columns of the windows of the run
+      const int ca = max(xa-rad,0);
+      const int cb = min(xb+rad,cols-1);
+      float* col = &w.col[0];
+      for (int x=ca;x<=cb;++x) {
+        const int xr = within(x-d,0,cols-1);
+        float sum = 0.0f;
+        for (int k=0;k<size;++k) {
+          sum += blockMatchingDisparity::cost(l[k][x],r[k][xr]);
+        }
+        col[x] = sum;
+      }
+
+      // sliding sum along the run, replicating the border columns
+      float sum = 0.0f;
+      for (int j=-rad;j<=rad;++j) {
+        sum += col[within(xa+j,0,cols-1)];
+      }
+      for (int x=xa;x<=xb;++x) {
+        w.costs[x*candidates + d-w.first[x]] = sum;
+        sum += col[min(x+rad+1,cols-1)] - col[max(x-rad,0)];
+      }
+    }
+
+    /**
+     * Refine the disparities of row y
+     */
+    template<class T>
+    void processRow(const std::vector<const T*>& left,
+                    const std::vector<const T*>& right,
+                    const int y,
+                    workerData& w) const {
+      const int cols = disparity_.columns();
+      const int last = static_cast<int>(left.size())-1;
+      const int size = 2*radius_+1;
+
+      // rows of the windows of this row, replicating the border rows
+      std::vector<const T*> l(size),r(size);
+      for (int k=0;k<size;++k) {
+        const int yy = within(y+k-radius_,0,last);
+        l[k] = left[yy];
+        r[k] = right[yy];
+      }
+
+      // the candidates of each pixel: the searched interval around the
+      // prediction and one more disparity on each side
+      const int candidates = 2*searchRadius_+3;
+      w.first.resize(cols);
+      w.costs.assign(cols*candidates,std::numeric_limits<float>::max());
+      w.col.resize(cols);
+
+      const float* parent =
+        &coarse_.at(min(y/factor_,coarse_.lastRow()),0);
+      const int lastParent = coarse_.lastColumn();
+      int lowest = maxDisp_;
+      int highest = minDisp_;
+      for (int x=0;x<cols;++x) {
+        const int pred =
+          within(iround(factor_*parent[min(x/factor_,lastParent)]),
+                 minDisp_,maxDisp_);
+        w.first[x] = pred-searchRadius_-1;
+        lowest = min(lowest,max(w.first[x],minDisp_));
+        highest = min(max(highest,w.first[x]+candidates-1),maxDisp_);
+      }
+
+      // the runs of pixels for which d is a candidate
+      for (int d=lowest;d<=highest;++d) {
+        int x=0;
+        while (x < cols) {
+          while ((x < cols) &&
+                 ((d < w.first[x]) || (d >= w.first[x]+candidates))) {
+            ++x;
+          }
+          if (x < cols) {
+            const int xa = x;
+            while ((x < cols) &&
+                   (d >= w.first[x]) && (d < w.first[x]+candidates)) {
+              ++x;
+            }
+            evaluate(&l[0],&r[0],d,xa,x-1,candidates,w);
+          }
+        }
+      }
+
+      float* disp = &disparity_.at(y,0);
+      for (int x=0;x<cols;++x) {
+        // the minimum is searched without the extra candidates
+        const float* c = &w.costs[x*candidates];
+        int best = 1;
+        for (int i=2;i<candidates-1;++i) {
+          if (c[i] < c[best]) {
+            best = i;
+          }
+        }
+
+        float offset = 0.0f;
+        if (subpixel_ &&
+            (c[best-1] < std::numeric_limits<float>::max()) &&
+            (c[best+1] < std::numeric_limits<float>::max())) {
+          const float den = c[best-1] - 2.0f*c[best] + c[best+1];
+          if (den > 0.0f) {
+            offset = within(0.5f*(c[best-1]-c[best+1])/den,-0.5f,0.5f);
+          }
+        }
+        disp[x] = static_cast<float>(w.first[x]+best) + offset;
+      }
+    }
+
+    const channel& coarse_;
+    const int factor_;
+    const int minDisp_;
+    const int maxDisp_;
+    const int radius_;
+    const int searchRadius_;
+    const bool subpixel_;
+    channel& disparity_;
+
+    /**
+     * Rows of the input
+     */
+    blockMatchingDisparity::rowPointers pixels_;
+
+    std::vector<workerData> data_;
+  };
+
+  // --------------------------------------------------
+  // pyramidDisparity
+  // --------------------------------------------------
+
+  // default constructor
+  pyramidDisparity::pyramidDisparity()
+    : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
+  }
+
+  // default constructor
+  pyramidDisparity::pyramidDisparity(const parameters& par)
+    : functor() {
+    setParameters(par);
+  }
+
+  // copy constructor
+  pyramidDisparity::pyramidDisparity(const pyramidDisparity& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  pyramidDisparity::~pyramidDisparity() {
+  }
+
+  // copy member
+  pyramidDisparity&
+  pyramidDisparity::copy(const pyramidDisparity& other) {
+    functor::copy(other);
+    return (*this);
+  }
+
+  // alias for copy member
+  pyramidDisparity&
+  pyramidDisparity::operator=(const pyramidDisparity& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& pyramidDisparity::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  pyramidDisparity* pyramidDisparity::clone() const {
+    return new pyramidDisparity(*this);
+  }
+
+  // create a new instance
+  pyramidDisparity* pyramidDisparity::newInstance() const {
+    return new pyramidDisparity();
+  }
+
+  // return parameters
+  const pyramidDisparity::parameters&
+  pyramidDisparity::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  /*
+   * Smoothing with the binomial kernel [1 4 6 4 1]/16 along each axis,
+   * evaluated only at the even rows and columns that are kept
+   */
+  void pyramidDisparity::downsample(const channel& src,channel& dst) {
+    const int rows = src.rows();
+    const int cols = src.columns();
+    const int drows = (rows+1)/2;
+    const int dcols = (cols+1)/2;
+
+    channel tmp(rows,dcols);
+    for (int y=0;y<rows;++y) {
+      const float* s = &src.at(y,0);
+      float* t = &tmp.at(y,0);
+      for (int i=0;i<dcols;++i) {
+        const int x = 2*i;
+        t[i] = (       s[within(x-2,0,cols-1)] +
+                4.0f * s[within(x-1,0,cols-1)] +
+                6.0f * s[x] +
+                4.0f * s[within(x+1,0,cols-1)] +
+                       s[within(x+2,0,cols-1)]) * (1.0f/16.0f);
+      }
+    }
+
+    dst.allocate(drows,dcols);
+    for (int j=0;j<drows;++j) {
+      const int y = 2*j;
+      const float* t0 = &tmp.at(within(y-2,0,rows-1),0);
+      const float* t1 = &tmp.at(within(y-1,0,rows-1),0);
+      const float* t2 = &tmp.at(y,0);
+      const float* t3 = &tmp.at(within(y+1,0,rows-1),0);
+      const float* t4 = &tmp.at(within(y+2,0,rows-1),0);
+      float* d = &dst.at(j,0);
+      for (int i=0;i<dcols;++i) {
+        d[i] = (t0[i] + 4.0f*t1[i] + 6.0f*t2[i] + 4.0f*t3[i] + t4[i]) *
+               (1.0f/16.0f);
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  bool pyramidDisparity::apply(const channel& left,
+                               const channel& right,
+                               channel& disparity) const {
+    const parameters& par = getParameters();
+
+    if (left.size() != right.size()) {
+      setStatusString("Both images must have the same size");
+      return false;
+    }
+    if (par.levels < 0) {
+      setStatusString("The number of levels must not be negative");
+      return false;
+    }
+    if (par.searchRadius < 0) {
+      setStatusString("The search radius must not be negative");
+      return false;
+    }
+
+    // the coarser levels, the original images are level 0
+    // (reserved, so that the pointers to the last level stay valid)
+    std::vector<channel> leftPyr,rightPyr;
+    leftPyr.reserve(par.levels);
+    rightPyr.reserve(par.levels);
+    const int win = par.matching.windowSize;
+    const channel* lc = &left;
+    const channel* rc = &right;
+    while ((static_cast<int>(leftPyr.size()) < par.levels) &&
+           ((lc->rows()+1)/2 >= win) && ((lc->columns()+1)/2 >= win)) {
+      leftPyr.push_back(channel());
+      rightPyr.push_back(channel());
+      downsample(*lc,leftPyr.back());
+      downsample(*rc,rightPyr.back());
+      lc = &leftPyr.back();
+      rc = &rightPyr.back();
+    }
+    const int levels = static_cast<int>(leftPyr.size());
+
+    // the whole range, only at the coarsest level
+    blockMatchingDisparity::parameters bmPar(par.matching);
+    bmPar.minDisparity = floorDiv(par.matching.minDisparity,1 << levels);
+    bmPar.maxDisparity = ceilDiv(par.matching.maxDisparity,1 << levels);
+    blockMatchingDisparity matcher(bmPar);
+
+    channel coarse;
+    if (!matcher.apply(*lc,*rc,coarse)) {
+      setStatusString(matcher.getStatusString());
+      return false;
+    }
+
+    if ((levels == 0) && !par.subpixel) {
+      disparity.swap(coarse);
+      return true;
+    }
+
+    workerPool pool(par.matching.threads);
+    std::vector<blockMatchingDisparity::signature> sigLeft,sigRight;
+
+    // without coarser levels, the block matching result is only refined
+    // to sub-pixel precision
+    for (int level=max(levels-1,0);level>=0;--level) {
+      const channel& l = (level == 0) ? left : leftPyr[level-1];
+      const channel& r = (level == 0) ? right : rightPyr[level-1];
+
+      channel fine(l.size());
+      refineJob job(coarse,(levels == 0) ? 1 : 2,
+                    floorDiv(par.matching.minDisparity,1 << level),
+                    ceilDiv(par.matching.maxDisparity,1 << level),
+                    win,par.searchRadius,
+                    (level > 0) || par.subpixel,fine,pool.size());
+
+      if (par.matching.cost == blockMatchingDisparity::Census) {
+        if (!matcher.census(l,sigLeft) || !matcher.census(r,sigRight)) {
+          setStatusString(matcher.getStatusString());
+          return false;
+        }
+        job.pixels().use(sigLeft,sigRight,l.columns());
+      } else {
+        job.pixels().use(l,r);
+      }
+
+      pool.apply(job,l.rows(),8);
+      coarse.swap(fine);
+    }
+
+    disparity.swap(coarse);
+    return true;
+  }
+
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiPyramidDisparity.h
+ *         Dense disparity of a rectified stereo pair, searched from coarse
+ *         to fine on Gaussian pyramids.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_PYRAMID_DISPARITY_H_
+#define _LTI_PYRAMID_DISPARITY_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiBlockMatchingDisparity.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Coarse-to-fine disparity.
+   *
+   * The block matching disparity evaluates every disparity of the range
+   * for every pixel, so that its time grows linearly with the range.
+   * This functor builds Gaussian pyramids of both images, each level
+   * smoothed with the binomial kernel [1 4 6 4 1]/16 and subsampled by
+   * two, and searches the whole range only at the coarsest level, where
+   * it is 2^parameters::levels times narrower.  At each finer level the
+   * disparity of a pixel is predicted by doubling the one of its parent,
+   * and only the parameters::searchRadius disparities around the
+   * prediction are evaluated, so that the time of the refinement does not
+   * depend on the range at all.
+   *
+   * The window costs are those of lti::blockMatchingDisparity (see
+   * parameters::matching), with its sliding sums restricted to the runs
+   * of pixels that share a candidate.  The sub-pixel position of each
+   * minimum is obtained by fitting a parabola through the costs of the
+   * best disparity and its two neighbors, instead of searching
+   * fractional shifts.  The intermediate levels are refined in the same
+   * way, so that the predictions are rounded from sub-pixel disparities.
+   *
+   * Large, untextured regions or thin structures that disappear in the
+   * coarse levels can be mismatched there, and a wrong prediction cannot
+   * be corrected further than parameters::searchRadius per level.
+   *
+   * Example:
+   * \code
+   * lti::pyramidDisparity::parameters par;
+   * par.matching.minDisparity = 0;
+   * par.matching.maxDisparity = 255;
+   * par.levels = 3;
+   * lti::pyramidDisparity matcher(par);
+   * lti::channel disp;
+   * matcher.apply(left,right,disp);
+   * \endcode
+   */
+  class pyramidDisparity : public functor {
+  public:
+    /**
+     * The parameters for the class pyramidDisparity
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Matching cost: disparity range of the original images, cost type
+       * and window, which is the same at all levels, and the number of
+       * threads.
+       *
+       * Default value: the default blockMatchingDisparity::parameters
+       */
+      blockMatchingDisparity::parameters matching;
+
+      /**
+       * Number of levels coarser than the original images.  Fewer are
+       * used if the images become smaller than the matching window.
+       *
+       * Default value: 3
+       */
+      int levels;
+
+      /**
+       * Disparities evaluated at each finer level on each side of the
+       * prediction doubled from the coarser one.
+       *
+       * Default value: 2
+       */
+      int searchRadius;
+
+      /**
+       * If true, the disparities of the finest level are refined to
+       * sub-pixel precision with a parabola.  Otherwise they are integers.
+       *
+       * Default value: true
+       */
+      bool subpixel;
+    };
+
+    /**
+     * Default constructor
+     */
+    pyramidDisparity();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    pyramidDisparity(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    pyramidDisparity(const pyramidDisparity& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~pyramidDisparity();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    pyramidDisparity& copy(const pyramidDisparity& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    pyramidDisparity& operator=(const pyramidDisparity& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual pyramidDisparity* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual pyramidDisparity* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Compute the disparity map of the given stereo pair.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param disparity disparity of each pixel of the left image
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               channel& disparity) const;
+
+  protected:
+    /**
+     * Next coarser level of a Gaussian pyramid
+     */
+    static void downsample(const channel& src,channel& dst);
+
+    /**
+     * Refinement of the predicted disparities of one level, one row per
+     * item
+     */
+    class refineJob;
+  };
+
+}
+
+#endif
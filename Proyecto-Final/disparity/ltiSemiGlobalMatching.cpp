@@ -0,0 +1,631 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiSemiGlobalMatching.cpp
+ *         Dense disparity of a rectified stereo pair by semi-global
+ *         matching.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiSemiGlobalMatching.h"
+#include "ltiWorkerPool.h"
+#include "ltiMutex.h"
+#include "ltiMath.h"
+
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lti {
+
+  /*
+   * Largest 16-bit cost, used for the lanes beyond the last disparity
+   */
+  static const int16 MaxCost16 = 32767;
+
+  // --------------------------------------------------
+  // semiGlobalMatching::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  semiGlobalMatching::parameters::parameters()
+    : functor::parameters() {
+    matching.cost = blockMatchingDisparity::Census;
+    matching.windowSize = 3;
+    penalty1 = 8;
+    penalty2 = 32;
+    paths = 8;
+    costBits = 8;
+  }
+
+  // copy constructor
+  semiGlobalMatching::parameters::parameters(const parameters& other)
+    : functor::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  semiGlobalMatching::parameters::~parameters() {
+  }
+
+  // copy member
+  semiGlobalMatching::parameters&
+  semiGlobalMatching::parameters::copy(const parameters& other) {
+    functor::parameters::copy(other);
+
+    matching.copy(other.matching);
+    penalty1 = other.penalty1;
+    penalty2 = other.penalty2;
+    paths = other.paths;
+    costBits = other.costBits;
+
+    return *this;
+  }
+
+  // alias for copy method
+  semiGlobalMatching::parameters&
+  semiGlobalMatching::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& semiGlobalMatching::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  semiGlobalMatching::parameters*
+  semiGlobalMatching::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  semiGlobalMatching::parameters*
+  semiGlobalMatching::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  /*
+   * Write the parameters in the given ioHandler
+   */
+  bool semiGlobalMatching::parameters::write(ioHandler& handler,
+                                             const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"matching",matching) && b;
+      b = lti::write(handler,"penalty1",penalty1) && b;
+      b = lti::write(handler,"penalty2",penalty2) && b;
+      b = lti::write(handler,"paths",paths) && b;
+      b = lti::write(handler,"costBits",costBits) && b;
+    }
+
+    b = b && functor::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  /*
+   * Read the parameters from the given ioHandler
+   */
+  bool semiGlobalMatching::parameters::read(ioHandler& handler,
+                                            const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"matching",matching) && b;
+      b = lti::read(handler,"penalty1",penalty1) && b;
+      b = lti::read(handler,"penalty2",penalty2) && b;
+      b = lti::read(handler,"paths",paths) && b;
+      b = lti::read(handler,"costBits",costBits) && b;
+    }
+
+    b = b && functor::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // Vector helpers
+  // --------------------------------------------------
+
+#if defined(__SSE2__)
+  /*
+   * Eight costs as 16-bit lanes
+   */
+  static inline __m128i loadCosts(const int16* c) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+  }
+
+  static inline __m128i loadCosts(const ubyte* c) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const
+                                             __m128i*>(c)),
+                             _mm_setzero_si128());
+  }
+
+  /*
+   * Smallest of the eight lanes
+   */
+  static inline int16 minimum(__m128i v) {
+    v = _mm_min_epi16(v,_mm_srli_si128(v,8));
+    v = _mm_min_epi16(v,_mm_srli_si128(v,4));
+    v = _mm_min_epi16(v,_mm_srli_si128(v,2));
+    return static_cast<int16>(_mm_cvtsi128_si32(v));
+  }
+#endif
+
+  /*
+   * Saturated 16-bit addition of non-negative values
+   */
+  static inline int16 addSat(const int a,const int b) {
+    return static_cast<int16>(min(a+b,static_cast<int>(MaxCost16)));
+  }
+
+  // --------------------------------------------------
+  // semiGlobalMatching::pathJob
+  // --------------------------------------------------
+
+  /**
+   * Each item is one path direction (dx,dy): the predecessor of (x,y) is
+   * (x-dx,y-dy).  The rows are visited in the direction of dy and the
+   * pixels of each row in the direction of dx, so that the predecessor
+   * is always done.  The costs of each pixel are preceded by eight lanes
+   * with MaxCost16, which serve as the neighbor d-1 of the first
+   * disparity, and the lanes beyond the last disparity are kept at
+   * MaxCost16 as well.
+   */
+  template<class T>
+  class semiGlobalMatching::pathJob : public workerPool::job {
+  public:
+    /**
+     * Stripes of rows sharing one lock of the sum volume
+     */
+    static const int Locks = 64;
+
+    pathJob(const std::vector<T>& costs,
+            const int rows,
+            const int columns,
+            const int disparities,
+            const int stride,
+            const int penalty1,
+            const int penalty2,
+            std::vector<int16>& sum)
+      : costs_(costs),rows_(rows),columns_(columns),
+        disparities_(disparities),stride_(stride),
+        penalty1_(penalty1),penalty2_(penalty2),sum_(sum) {
+    }
+
+    virtual void process(const int from,const int to,const int) {
+      static const int dirs[8][2] = { { 1, 0},{-1, 0},{ 0, 1},{ 0,-1},
+                                      { 1, 1},{-1, 1},{ 1,-1},{-1,-1} };
+      for (int i=from;i<to;++i) {
+        aggregate(dirs[i][0],dirs[i][1]);
+      }
+    }
+
+  private:
+    /**
+     * Aggregate along all paths of the given direction
+     */
+    void aggregate(const int dx,const int dy) {
+      const int cols = columns_;
+      const int block = stride_+8;
+
+      // two rows of L_r and of their minima
+      std::vector<int16> prevL(cols*block+8,MaxCost16);
+      std::vector<int16> currL(cols*block+8,MaxCost16);
+      std::vector<int16> prevMin(cols),currMin(cols);
+
+      const int y0 = (dy >= 0) ? 0 : rows_-1;
+      const int sy = (dy >= 0) ? 1 : -1;
+      const int x0 = (dx >= 0) ? 0 : cols-1;
+      const int sx = (dx >= 0) ? 1 : -1;
+
+      for (int y=y0,ny=0;ny<rows_;y+=sy,++ny) {
+        for (int x=x0,nx=0;nx<cols;x+=sx,++nx) {
+          const T* c = &costs_[(y*cols+x)*stride_];
+          int16* out = &currL[x*block+8];
+          const int qx = x-dx;
+          const int qy = y-dy;
+
+          if ((qx < 0) || (qx >= cols) || (qy < 0) || (qy >= rows_)) {
+            // start of a path: just the matching costs
+            currMin[x] = start(c,out);
+          } else if (dy == 0) {
+            currMin[x] = step(&currL[qx*block+8],currMin[qx],c,out);
+          } else {
+            currMin[x] = step(&prevL[qx*block+8],prevMin[qx],c,out);
+          }
+        }
+
+        // add the finished row into the sum
+        lock_[y%Locks].lock();
+        for (int x=0;x<cols;++x) {
+          accumulate(&currL[x*block+8],&sum_[(y*cols+x)*stride_]);
+        }
+        lock_[y%Locks].unlock();
+
+        prevL.swap(currL);
+        prevMin.swap(currMin);
+      }
+    }
+
+    /**
+     * First pixel of a path
+     */
+    int16 start(const T* c,int16* out) const {
+      int16 m = MaxCost16;
+      for (int d=0;d<disparities_;++d) {
+        out[d] = static_cast<int16>(c[d]);
+        m = min(m,out[d]);
+      }
+      for (int d=disparities_;d<stride_;++d) {
+        out[d] = MaxCost16;
+      }
+      return m;
+    }
+
+    /**
+     * One step along the path: the costs of all disparities of the pixel
+     * given the ones of its predecessor, whose minimum is prevMin.
+     * Returns the minimum of the new costs.
+     */
+    int16 step(const int16* prev,
+               const int16 prevMin,
+               const T* c,
+               int16* out) const {
+#if defined(__SSE2__)
+      const __m128i p1 = _mm_set1_epi16(static_cast<int16>(penalty1_));
+      const __m128i jump = _mm_set1_epi16(addSat(prevMin,penalty2_));
+      const __m128i pm = _mm_set1_epi16(prevMin);
+      __m128i vmin = _mm_set1_epi16(MaxCost16);
+
+      int d=0;
+      for (;d+8<=disparities_;d+=8) {
+        const __m128i v = stepLanes(prev+d,c+d,p1,jump,pm);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+d),v);
+        vmin = _mm_min_epi16(vmin,v);
+      }
+      if (d < stride_) {
+        // last lanes: the ones beyond the last disparity stay at the top
+        const __m128i lane = _mm_set_epi16(7,6,5,4,3,2,1,0);
+        const __m128i pad =
+          _mm_and_si128(_mm_cmpgt_epi16(lane,
+                                        _mm_set1_epi16(static_cast<int16>(
+                                          disparities_-d-1))),
+                        _mm_set1_epi16(MaxCost16));
+        const __m128i v = _mm_max_epi16(stepLanes(prev+d,c+d,p1,jump,pm),
+                                        pad);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+d),v);
+        vmin = _mm_min_epi16(vmin,v);
+      }
+      return minimum(vmin);
+#else
+      int16 m = MaxCost16;
+      const int jump = prevMin+penalty2_;
+      for (int d=0;d<disparities_;++d) {
+        int best = min(static_cast<int>(prev[d]),jump);
+        best = min(best,prev[d-1]+penalty1_);
+        best = min(best,prev[d+1]+penalty1_);
+        out[d] = addSat(c[d],best-prevMin);
+        m = min(m,out[d]);
+      }
+      for (int d=disparities_;d<stride_;++d) {
+        out[d] = MaxCost16;
+      }
+      return m;
+#endif
+    }
+
+#if defined(__SSE2__)
+    /**
+     * Eight lanes of step()
+     */
+    static inline __m128i stepLanes(const int16* prev,
+                                    const T* c,
+                                    const __m128i& p1,
+                                    const __m128i& jump,
+                                    const __m128i& pm) {
+      const __m128i same =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev));
+      const __m128i lower =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev-1));
+      const __m128i upper =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev+1));
+      __m128i best = _mm_min_epi16(same,jump);
+      best = _mm_min_epi16(best,_mm_adds_epi16(lower,p1));
+      best = _mm_min_epi16(best,_mm_adds_epi16(upper,p1));
+      return _mm_adds_epi16(loadCosts(c),_mm_subs_epi16(best,pm));
+    }
+#endif
+
+    /**
+     * Saturated addition of the costs of one pixel into the sum
+     */
+    void accumulate(const int16* l,int16* s) const {
+#if defined(__SSE2__)
+      for (int d=0;d<stride_;d+=8) {
+        __m128i* p = reinterpret_cast<__m128i*>(s+d);
+        _mm_storeu_si128(p,_mm_adds_epi16(_mm_loadu_si128(p),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(l+d))));
+      }
+#else
+      for (int d=0;d<stride_;++d) {
+        s[d] = addSat(s[d],l[d]);
+      }
+#endif
+    }
+
+    const std::vector<T>& costs_;
+    const int rows_;
+    const int columns_;
+    const int disparities_;
+    const int stride_;
+    const int penalty1_;
+    const int penalty2_;
+    std::vector<int16>& sum_;
+    mutex lock_[Locks];
+  };
+
+  // --------------------------------------------------
+  // semiGlobalMatching::winnerJob
+  // --------------------------------------------------
+
+  /**
+   * Each item is a row.  The lanes beyond the last disparity hold
+   * MaxCost16, so that they can take part in the minimum.
+   */
+  class semiGlobalMatching::winnerJob : public workerPool::job {
+  public:
+    winnerJob(const std::vector<int16>& sum,
+              const int disparities,
+              const int stride,
+              const int minDisparity,
+              channel& disparity)
+      : sum_(sum),disparities_(disparities),stride_(stride),
+        minDisparity_(minDisparity),disparity_(disparity) {
+    }
+
+    virtual void process(const int from,const int to,const int) {
+      const int cols = disparity_.columns();
+      for (int y=from;y<to;++y) {
+        float* disp = &disparity_.at(y,0);
+        for (int x=0;x<cols;++x) {
+          disp[x] = static_cast<float>(minDisparity_ +
+                                       winner(&sum_[(y*cols+x)*stride_]));
+        }
+      }
+    }
+
+  private:
+    /**
+     * Index of the first smallest cost
+     */
+    int winner(const int16* s) const {
+#if defined(__SSE2__)
+      __m128i vmin = _mm_set1_epi16(MaxCost16);
+      for (int d=0;d<stride_;d+=8) {
+        vmin = _mm_min_epi16(vmin,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(s+d)));
+      }
+      const __m128i m = _mm_set1_epi16(minimum(vmin));
+      for (int d=0;d<stride_;d+=8) {
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(m,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(s+d))));
+        if (mask != 0) {
+          return d + __builtin_ctz(mask)/2;
+        }
+      }
+      return 0;
+#else
+      int best = 0;
+      for (int d=1;d<disparities_;++d) {
+        if (s[d] < s[best]) {
+          best = d;
+        }
+      }
+      return best;
+#endif
+    }
+
+    const std::vector<int16>& sum_;
+    const int disparities_;
+    const int stride_;
+    const int minDisparity_;
+    channel& disparity_;
+  };
+
+  // --------------------------------------------------
+  // semiGlobalMatching
+  // --------------------------------------------------
+
+  // default constructor
+  semiGlobalMatching::semiGlobalMatching()
+    : functor() {
+    parameters defaultParameters;
+    setParameters(defaultParameters);
+  }
+
+  // default constructor
+  semiGlobalMatching::semiGlobalMatching(const parameters& par)
+    : functor() {
+    setParameters(par);
+  }
+
+  // copy constructor
+  semiGlobalMatching::semiGlobalMatching(const semiGlobalMatching& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  semiGlobalMatching::~semiGlobalMatching() {
+  }
+
+  // copy member
+  semiGlobalMatching&
+  semiGlobalMatching::copy(const semiGlobalMatching& other) {
+    functor::copy(other);
+    return (*this);
+  }
+
+  // alias for copy member
+  semiGlobalMatching&
+  semiGlobalMatching::operator=(const semiGlobalMatching& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& semiGlobalMatching::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  semiGlobalMatching* semiGlobalMatching::clone() const {
+    return new semiGlobalMatching(*this);
+  }
+
+  // create a new instance
+  semiGlobalMatching* semiGlobalMatching::newInstance() const {
+    return new semiGlobalMatching();
+  }
+
+  // return parameters
+  const semiGlobalMatching::parameters&
+  semiGlobalMatching::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  // -------------------------------------------------------------------
+  // The apply() member functions
+  // -------------------------------------------------------------------
+
+  template<class T>
+  bool semiGlobalMatching::aggregate(const std::vector<T>& costs,
+                                     const int rows,
+                                     const int columns,
+                                     channel& disparity) const {
+    const parameters& par = getParameters();
+    const int disparities =
+      par.matching.maxDisparity-par.matching.minDisparity+1;
+    const int stride = 8*((disparities+7)/8);
+
+    // with 16 bits the costs are eight times finer, and so the penalties
+    const int k = (par.costBits == 16) ? 8 : 1;
+
+    std::vector<int16> sum(rows*columns*stride,0);
+    workerPool pool(par.matching.threads);
+
+    pathJob<T> paths(costs,rows,columns,disparities,stride,
+                     k*par.penalty1,k*par.penalty2,sum);
+    pool.apply(paths,par.paths);
+
+    disparity.allocate(rows,columns);
+    winnerJob winners(sum,disparities,stride,par.matching.minDisparity,
+                      disparity);
+    pool.apply(winners,rows,16);
+
+    return true;
+  }
+
+  bool semiGlobalMatching::apply(const channel& left,
+                                 const channel& right,
+                                 channel& disparity) const {
+    const parameters& par = getParameters();
+
+    if ((par.paths != 4) && (par.paths != 8)) {
+      setStatusString("The number of paths must be 4 or 8");
+      return false;
+    }
+    if ((par.costBits != 8) && (par.costBits != 16)) {
+      setStatusString("The cost volume must have 8 or 16 bits");
+      return false;
+    }
+    if ((par.penalty1 < 0) || (par.penalty2 < par.penalty1)) {
+      setStatusString("The penalties must satisfy 0 <= penalty1 <= penalty2");
+      return false;
+    }
+
+    const int disparities =
+      par.matching.maxDisparity-par.matching.minDisparity+1;
+    const int stride = 8*((max(disparities,1)+7)/8);
+
+    blockMatchingDisparity matcher(par.matching);
+
+    bool b;
+    if (par.costBits == 16) {
+      std::vector<int16> costs;
+      b = matcher.apply(left,right,8*255,stride,costs) &&
+          aggregate(costs,left.rows(),left.columns(),disparity);
+    } else {
+      std::vector<ubyte> costs;
+      b = matcher.apply(left,right,255,stride,costs) &&
+          aggregate(costs,left.rows(),left.columns(),disparity);
+    }
+
+    if (!b) {
+      setStatusString(matcher.getStatusString());
+    }
+    return b;
+  }
+
+}
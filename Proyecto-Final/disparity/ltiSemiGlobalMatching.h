@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiSemiGlobalMatching.h
+ *         Dense disparity of a rectified stereo pair by semi-global
+ *         matching.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_SEMI_GLOBAL_MATCHING_H_
+#define _LTI_SEMI_GLOBAL_MATCHING_H_
+
+#include "ltiFunctor.h"
+#include "ltiChannel.h"
+#include "ltiBlockMatchingDisparity.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Semi-global matching.
+   *
+   * The block matching disparity decides each pixel on its own, which
+   * fails in regions without texture.  Semi-global matching (Hirschmueller,
+   * 2008) adds a smoothness term: along each of parameters::paths
+   * straight paths (horizontal and vertical, and with 8 also the
+   * diagonals) the cost of reaching pixel p with disparity d is
+   *
+   * \f[ L_r(p,d) = C(p,d) + \min\left(L_r(p-r,d),
+   *     L_r(p-r,d\pm 1) + P_1, \min_k L_r(p-r,k) + P_2\right)
+   *     - \min_k L_r(p-r,k) \f]
+   *
+   * where C is the matching cost of lti::blockMatchingDisparity (see
+   * parameters::matching), and the disparity of each pixel is the one
+   * with the smallest sum of the \f$L_r\f$ of all paths.
+   *
+   * All aggregated costs are 16-bit integers with saturated arithmetic,
+   * so that eight disparities are processed at once with SSE2, including
+   * the minimum over all disparities that each step needs.  Each path
+   * direction is aggregated by its own worker of a lti::workerPool,
+   * which keeps only two rows of \f$L_r\f$ and adds each finished row
+   * into the sum, locking only that row.
+   *
+   * The memory is dominated by the matching cost volume, with
+   * parameters::costBits bits per cost, and the 16-bit sum volume, both
+   * with one entry per pixel and disparity (rounded up to a multiple of
+   * eight).  Storing the matching costs with 8 bits saves a third of it
+   * at the price of a coarser cost resolution.
+   *
+   * Example:
+   * \code
+   * lti::semiGlobalMatching::parameters par;
+   * par.matching.minDisparity = 0;
+   * par.matching.maxDisparity = 127;
+   * lti::semiGlobalMatching sgm(par);
+   * lti::channel disp;
+   * sgm.apply(left,right,disp);
+   * \endcode
+   */
+  class semiGlobalMatching : public functor {
+  public:
+    /**
+     * The parameters for the class semiGlobalMatching
+     */
+    class parameters : public functor::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Matching cost: disparity range, cost type and window, and the
+       * number of threads, which is also used for the aggregation.
+       *
+       * Default value: Census cost with a window of 3 pixels
+       */
+      blockMatchingDisparity::parameters matching;
+
+      /**
+       * Penalty for a change of one disparity between neighbors, in units
+       * of the matching cost, which lies in [0,255].
+       *
+       * Default value: 8
+       */
+      int penalty1;
+
+      /**
+       * Penalty for larger changes of the disparity between neighbors, in
+       * units of the matching cost, which lies in [0,255].
+       *
+       * Default value: 32
+       */
+      int penalty2;
+
+      /**
+       * Number of aggregation paths: 4 (horizontal and vertical) or 8
+       * (also the diagonals).
+       *
+       * Default value: 8
+       */
+      int paths;
+
+      /**
+       * Bits of each entry of the matching cost volume: 8 or 16.  With 16
+       * bits the costs have eight times the resolution.
+       *
+       * Default value: 8
+       */
+      int costBits;
+    };
+
+    /**
+     * Default constructor
+     */
+    semiGlobalMatching();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    semiGlobalMatching(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    semiGlobalMatching(const semiGlobalMatching& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~semiGlobalMatching();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    semiGlobalMatching& copy(const semiGlobalMatching& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    semiGlobalMatching& operator=(const semiGlobalMatching& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual semiGlobalMatching* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual semiGlobalMatching* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Compute the disparity map of the given stereo pair.
+     *
+     * @param left left image
+     * @param right right image, with the same size as the left one
+     * @param disparity disparity of each pixel of the left image
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& left,
+               const channel& right,
+               channel& disparity) const;
+
+  protected:
+    /**
+     * Aggregation along the paths, one direction per item
+     */
+    template<class T> class pathJob;
+
+    /**
+     * Disparity with the smallest aggregated cost, one row per item
+     */
+    class winnerJob;
+
+    /**
+     * Aggregate the given cost volume (ubyte or int16 costs)
+     */
+    template<class T>
+    bool aggregate(const std::vector<T>& costs,
+                   const int rows,
+                   const int columns,
+                   channel& disparity) const;
+  };
+
+}
+
+#endif
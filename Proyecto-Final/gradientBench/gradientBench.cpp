@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the lecture CE-5201 Digital Image Processing and
+ * Analysis, at the Costa Rica Institute of Technology.
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   gradientBench.cpp
+ *         Benchmark of the gradient kernels of lti::gradientFunctor on the
+ *         micrographs.
+ * \author agent
+ * \date   17.10.2026
+ * revisions ..: $Id$
+ */
+
+#include "gradientBench.h"
+
+// LTI-Lib Headers
+
+#include <ltiObject.h>
+#include <ltiMath.h>     // General lti:: math and <cmath> functionality
+#include <ltiTimer.h>    // To measure time
+
+#include <ltiGradientFunctor.h>
+#include <ltiCannyEdges.h>
+#include "ltiImageFiles.h"
+
+#include <ltiImage.h>
+#include <ltiIOImage.h>
+
+// Standard Headers: from ANSI C and GNU C Library
+#include <cstdlib>  // Standard Library for C++
+#include <cstring>
+#include <getopt.h> // Functions to parse the command line arguments
+#include <unistd.h>
+#if defined(__linux__)
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// Standard Headers: STL
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Debug
+
+// Ensure that the STL streaming is used.
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+/*
+ * The kernels in the order of lti::gradientFunctor::eKernelType, as cycled
+ * by the canny example
+ */
+static const lti::gradientFunctor::eKernelType kernels[] = {
+  lti::gradientFunctor::Ando,
+  lti::gradientFunctor::OGD,
+  lti::gradientFunctor::Difference,
+  lti::gradientFunctor::Roberts,
+  lti::gradientFunctor::Sobel,
+  lti::gradientFunctor::Prewitt,
+  lti::gradientFunctor::Robinson,
+  lti::gradientFunctor::Kirsch,
+  lti::gradientFunctor::Harris
+};
+
+static const char* kernelNames[] = {
+  "Ando",
+  "OGD",
+  "Difference",
+  "Roberts",
+  "Sobel",
+  "Prewitt",
+  "Robinson",
+  "Kirsch",
+  "Harris"
+};
+
+static const int numKernels = 9;
+
+/*
+ * Input types
+ */
+enum eInput {
+  Byte,  /*!< lti::channel8 */
+  Float, /*!< lti::channel */
+  RGB    /*!< lti::image */
+};
+
+static const char* inputNames[] = { "byte", "float", "RGB" };
+
+static const int numInputs = 3;
+
+/*
+ * Bytes moved between the memory and the processor, measured with the
+ * last level cache misses counted by the processor (Linux perf events).
+ * Each miss loads one cache line, so that the reads of every mask
+ * gradientFunctor applies, and the lines allocated for its outputs, are
+ * included; the write-backs of the modified lines are not counted.
+ */
+class trafficCounter {
+public:
+  trafficCounter() : fd_(-1),lineSize_(64.0) {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr,0,sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open,&attr,0,-1,-1,0));
+
+    const long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    if (line > 0) {
+      lineSize_ = static_cast<double>(line);
+    }
+#endif
+  }
+
+  ~trafficCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+
+  /*
+   * Whether the processor counters can be read (see
+   * /proc/sys/kernel/perf_event_paranoid otherwise)
+   */
+  bool available() const {
+    return (fd_ >= 0);
+  }
+
+  /*
+   * Reset and start counting
+   */
+  void start() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_,PERF_EVENT_IOC_RESET,0);
+      ioctl(fd_,PERF_EVENT_IOC_ENABLE,0);
+    }
+#endif
+  }
+
+  /*
+   * Stop counting and return the bytes moved since start(), or a negative
+   * value if the counters are not available
+   */
+  double stop() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_,PERF_EVENT_IOC_DISABLE,0);
+      uint64_t misses = 0;
+      if (read(fd_,&misses,sizeof(misses)) == sizeof(misses)) {
+        return static_cast<double>(misses)*lineSize_;
+      }
+    }
+#endif
+    return -1.0;
+  }
+
+private:
+  int fd_;
+  double lineSize_;
+};
+
+/*
+ * Fastest of several evaluations of the gradient.  The bytes moved by the
+ * fastest evaluation are added to the given traffic, which becomes
+ * negative if they could not be measured.
+ */
+template<class T>
+static double timeGradient(const lti::gradientFunctor& grad,
+                           const T& src,
+                           const int repetitions,
+                           trafficCounter& counter,
+                           double& traffic) {
+  lti::channel mag,arg;
+  lti::timer chrono;
+  double best = -1.0;
+  double bytes = -1.0;
+  for (int r=0;r<repetitions;++r) {
+    counter.start();
+    chrono.start();
+    grad.apply(src,mag,arg);
+    chrono.stop();
+    const double b = counter.stop();
+    const double t = chrono.getTime();
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+      bytes = b;
+    }
+  }
+  if ((bytes < 0.0) || (traffic < 0.0)) {
+    traffic = -1.0;
+  } else {
+    traffic += bytes;
+  }
+  return best;
+}
+
+gradientBench::gradientBench(int argc, char* argv[]) 
+  : reference_(0),kernelSize_(3),repetitions_(5) {
+  parse(argc,argv);
+}
+
+
+/*
+ * Help 
+ */
+void gradientBench::usage() const {
+  cout <<
+    "usage: gradientBench [options] [<image>|<dir> ...]\n\n" \
+    "       -r kernel Reference kernel for the edges (default: Ando)\n" \
+    "       -k size   Size of the Ando and OGD kernels (default: 3)\n" \
+    "       -n reps   Repetitions of each measurement (default: 5)\n" \
+    "       <image>   input image\n" \
+    "       <dir>     all images in the directory\n\n" \
+    "Without images the micrographs in ../../Micrografías are used.\n" \
+    "Kernels: Ando OGD Difference Roberts Sobel Prewitt Robinson " \
+    "Kirsch Harris" << std::endl; 
+}
+
+/*
+ * Parse the line command arguments
+ */
+void gradientBench::parse(int argc, char*argv[]) {
+
+  int c;
+
+  // structure for the long options. 
+  static struct option lopts[] = {
+    {"help",no_argument,0,'h'},
+    {"reference",required_argument,0,'r'},
+    {"kernel-size",required_argument,0,'k'},
+    {"repetitions",required_argument,0,'n'},
+    {0,0,0,0}
+  };
+
+  int optionIdx;
+
+  while ((c = getopt_long(argc, argv, "hr:k:n:", lopts,&optionIdx)) != -1) {
+    switch (c) {
+    case 'r': {
+      const std::string name(optarg);
+      int k=0;
+      while ((k < numKernels) && (name != kernelNames[k])) {
+        ++k;
+      }
+      if (k < numKernels) {
+        reference_=k;
+      } else {
+        cerr << "Unknown kernel '" << name << "'." << endl;
+      }
+    } break;
+    case 'k':
+      kernelSize_=lti::max(3,atoi(optarg));
+      break;
+    case 'n':
+      repetitions_=lti::max(1,atoi(optarg));
+      break;
+    case 'h':
+      usage();
+      exit(EXIT_SUCCESS);
+      break;
+    default:
+      cerr << "Option '-" << static_cast<char>(c) << "' not recognized." 
+           << endl;
+    }
+  }
+  
+  while (optind < argc) {
+    inputs_.push_back(argv[optind++]);
+  }
+
+  if (inputs_.empty()) {
+    inputs_.push_back("../../Micrografías");
+  }
+}
+
+bool gradientBench::apply() {
+  std::vector<std::string> files;
+  lti::collectImageFiles(inputs_,std::string(),files);
+
+  // the whole corpus is kept in memory, in the three input types
+  lti::ioImage loader;
+  std::vector<lti::image> imgs;
+  std::vector<lti::channel> chnls;
+  std::vector<lti::channel8> chnl8s;
+  double pixels = 0.0;
+
+  for (unsigned int i=0;i<files.size();++i) {
+    lti::image img;
+    if (!loader.load(files[i],img)) {
+      cerr << "Image '" << files[i] << "' could not be read: "
+           << loader.getStatusString() << endl;
+      continue;
+    }
+    imgs.push_back(img);
+    chnls.push_back(lti::channel());
+    chnls.back().castFrom(img);
+    chnl8s.push_back(lti::channel8());
+    chnl8s.back().castFrom(img);
+    pixels += static_cast<double>(img.rows())*img.columns();
+  }
+
+  if (imgs.empty()) {
+    cerr << "No images to evaluate." << endl;
+    usage();
+    return false;
+  }
+
+  cout << "Evaluating " << numKernels << " kernels on " << imgs.size()
+       << " images (" << pixels/1000000.0 << " Mpixel), best of "
+       << repetitions_ << " runs" << endl << endl;
+
+  // edges with the reference kernel, using the default Canny parameters
+  // on the float channels
+  lti::cannyEdges::parameters cannyPar;
+  cannyPar.gradientParameters.gradientKernelSize = kernelSize_;
+  std::vector<lti::channel8> refEdges(imgs.size());
+  cannyPar.gradientParameters.kernelType = kernels[reference_];
+  lti::cannyEdges refCanny(cannyPar);
+  for (unsigned int i=0;i<imgs.size();++i) {
+    refCanny.apply(chnls[i],refEdges[i]);
+  }
+
+  // microseconds and bytes moved per kernel and input type, and edge
+  // statistics
+  std::vector<double> times(numKernels*numInputs,0.0);
+  std::vector<double> traffic(numKernels*numInputs,0.0);
+  trafficCounter counter;
+  std::vector<double> edges(numKernels,0.0);
+  std::vector<double> changed(numKernels,0.0);
+  double refCount = 0.0;
+
+  for (int k=0;k<numKernels;++k) {
+    lti::gradientFunctor::parameters gradPar;
+    gradPar.kernelType = kernels[k];
+    gradPar.gradientKernelSize = kernelSize_;
+    gradPar.format = lti::gradientFunctor::Polar;
+    lti::gradientFunctor grad(gradPar);
+
+    cannyPar.gradientParameters.kernelType = kernels[k];
+    lti::cannyEdges canny(cannyPar);
+    lti::channel8 mask;
+
+    for (unsigned int i=0;i<imgs.size();++i) {
+      const int idx = k*numInputs;
+      times[idx+Byte] += timeGradient(grad,chnl8s[i],repetitions_,
+                                      counter,traffic[idx+Byte]);
+      times[idx+Float] += timeGradient(grad,chnls[i],repetitions_,
+                                       counter,traffic[idx+Float]);
+      times[idx+RGB] += timeGradient(grad,imgs[i],repetitions_,
+                                     counter,traffic[idx+RGB]);
+
+      canny.apply(chnls[i],mask);
+      const lti::ubyte edgeValue = cannyPar.edgeValue;
+      lti::channel8::const_iterator it,rit,eit;
+      for (it=mask.begin(),rit=refEdges[i].begin(),eit=mask.end();
+           it!=eit;++it,++rit) {
+        const bool e = (*it == edgeValue);
+        const bool r = (*rit == edgeValue);
+        if (e) {
+          edges[k]++;
+        }
+        if (r && (k == 0)) {
+          refCount++;
+        }
+        if (e != r) {
+          changed[k]++;
+        }
+      }
+    }
+    cerr << "." << std::flush;
+  }
+  cerr << endl;
+
+  // cost table
+  cout << std::left << std::setw(12) << "kernel"
+       << std::setw(7) << "input"
+       << std::right << std::setw(10) << "ns/pixel"
+       << std::setw(12) << "B/pixel*"
+       << std::setw(10) << "GB/s*" << endl;
+
+  for (int k=0;k<numKernels;++k) {
+    for (int t=0;t<numInputs;++t) {
+      const double us = times[k*numInputs+t];
+      const double ns = us*1000.0/pixels;
+      const double bytes = traffic[k*numInputs+t]/pixels;
+      cout << std::left << std::setw(12) << kernelNames[k]
+           << std::setw(7) << inputNames[t] << std::right << std::fixed
+           << std::setprecision(2) << std::setw(10) << ns;
+      if (bytes < 0.0) {
+        cout << std::setw(12) << "n/a" << std::setw(10) << "n/a" << endl;
+      } else {
+        cout << std::setprecision(1) << std::setw(12) << bytes
+             << std::setprecision(2) << std::setw(10) << bytes/ns << endl;
+      }
+    }
+  }
+  if (counter.available()) {
+    cout << "* measured as last level cache misses times the cache line "
+         << "size, in the" << endl
+         << "  fastest run; write-backs are not counted" << endl << endl;
+  } else {
+    cout << "* the processor counters are not available (see "
+         << "/proc/sys/kernel/" << endl
+         << "  perf_event_paranoid), so the memory traffic was not measured"
+         << endl << endl;
+  }
+
+  // accuracy table
+  cout << "Canny edges (float input) compared with the "
+       << kernelNames[reference_] << " kernel ("
+       << std::setprecision(0) << refCount << " edge pixels)" << endl;
+  cout << std::left << std::setw(12) << "kernel"
+       << std::right << std::setw(12) << "edges"
+       << std::setw(12) << "changed"
+       << std::setw(10) << "changed%" << endl;
+  for (int k=0;k<numKernels;++k) {
+    cout << std::left << std::setw(12) << kernelNames[k] << std::right
+         << std::setprecision(0) << std::setw(12) << edges[k]
+         << std::setw(12) << changed[k]
+         << std::setprecision(2) << std::setw(10)
+         << ((refCount > 0.0) ? 100.0*changed[k]/refCount : 0.0) << endl;
+  }
+
+  return true;
+}
+
+/*
+ * Main method
+ */
+int main(int argc, char* argv[]) {
+  
+  gradientBench me(argc,argv);
+  if (me.apply()) {
+    return EXIT_SUCCESS;
+  }
+
+  return EXIT_FAILURE;
+}
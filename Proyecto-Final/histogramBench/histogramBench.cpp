@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the lecture CE-5201 Digital Image Processing and
+ * Analysis, at the Costa Rica Institute of Technology.
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   histogramBench.cpp
+ *         Benchmark of lti::histogramEngine against the straightforward
+ *         histogram loops, on the micrographs.
+ * \author agent
+ * \date   17.10.2026
+ * revisions ..: $Id$
+ */
+
+#include "histogramBench.h"
+#include "ltiHistogramEngine.h"
+#include "ltiWorkerPool.h"
+#include "ltiImageFiles.h"
+
+// LTI-Lib Headers
+
+#include <ltiObject.h>
+#include <ltiMath.h>     // General lti:: math and <cmath> functionality
+#include <ltiTimer.h>    // To measure time
+
+#include <ltiImage.h>
+#include <ltiIOImage.h>
+
+// Standard Headers: from ANSI C and GNU C Library
+#include <cstdlib>  // Standard Library for C++
+#include <getopt.h> // Functions to parse the command line arguments
+
+// Standard Headers: STL
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Debug
+
+// Ensure that the STL streaming is used.
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+/*
+ * Evaluated methods
+ */
+enum eMethod {
+  Loop,       /*!< The loop of the thresholding example */
+  Single,     /*!< Engine, one thread and one histogram */
+  Interleaved,/*!< Engine, one thread and four interleaved histograms */
+  Parallel    /*!< Engine, all threads and four interleaved histograms */
+};
+
+static const char* methodNames[] = {
+  "loop",
+  "1 thread",
+  "1 thread x4",
+  "parallel x4"
+};
+
+static const int numMethods = 4;
+
+/*
+ * The straightforward loop for a channel8, as the thresholding example
+ * used to compute the histogram for the viewer
+ */
+static void loop(const lti::channel8& chnl,const int,lti::ivector& hist) {
+  hist.assign(256,0);
+  lti::channel8::const_iterator it(chnl.begin()),eit(chnl.end());
+  while (it!=eit) {
+    hist.at(*it)++;
+    ++it;
+  }
+}
+
+/*
+ * The straightforward loop for a channel, dividing each value by the
+ * width of the bins
+ */
+static void loop(const lti::channel& chnl,const int bins,lti::ivector& hist) {
+  hist.assign(bins,0);
+  const float width = 1.0f/bins;
+  lti::channel::const_iterator it(chnl.begin()),eit(chnl.end());
+  while (it!=eit) {
+    hist.at(lti::within(static_cast<int>(*it/width),0,bins-1))++;
+    ++it;
+  }
+}
+
+/*
+ * Fastest of several computations of the histogram with the given method
+ */
+template<class T>
+static double timeHistogram(const eMethod method,
+                            const T& chnl,
+                            const int bins,
+                            const int threads,
+                            const int repetitions,
+                            lti::ivector& hist) {
+  lti::histogramEngine::parameters par;
+  par.bins = bins;
+  par.copies = (method == Single) ? 1 : 4;
+  par.threads = (method == Parallel) ? threads : 1;
+  lti::histogramEngine engine(par);
+
+  lti::timer chrono;
+  double best = -1.0;
+  for (int r=0;r<repetitions;++r) {
+    chrono.start();
+    if (method == Loop) {
+      loop(chnl,bins,hist);
+    } else {
+      engine.apply(chnl,hist);
+    }
+    chrono.stop();
+    const double t = chrono.getTime();
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+/*
+ * Number of pixels counted in a different bin than in the reference
+ */
+static double differences(const lti::ivector& hist,const lti::ivector& ref) {
+  double diff = 0.0;
+  for (int i=0;i<hist.size();++i) {
+    diff += lti::abs(hist.at(i)-ref.at(i));
+  }
+  return diff/2.0;
+}
+
+histogramBench::histogramBench(int argc, char* argv[]) 
+  : bins_(1024),threads_(0),repetitions_(5) {
+  parse(argc,argv);
+}
+
+
+/*
+ * Help 
+ */
+void histogramBench::usage() const {
+  cout <<
+    "usage: histogramBench [options] [<image>|<dir> ...]\n\n" \
+    "       -b bins   Bins of the float histograms (default: 1024)\n" \
+    "       -j n      Threads of the parallel engine (default: one per\n" \
+    "                 processor)\n" \
+    "       -n reps   Repetitions of each measurement (default: 5)\n" \
+    "       <image>   input image\n" \
+    "       <dir>     all images in the directory\n\n" \
+    "Without images the micrographs in ../../Micrografías are used."
+       << std::endl; 
+}
+
+/*
+ * Parse the line command arguments
+ */
+void histogramBench::parse(int argc, char*argv[]) {
+
+  int c;
+
+  // structure for the long options. 
+  static struct option lopts[] = {
+    {"help",no_argument,0,'h'},
+    {"bins",required_argument,0,'b'},
+    {"threads",required_argument,0,'j'},
+    {"repetitions",required_argument,0,'n'},
+    {0,0,0,0}
+  };
+
+  int optionIdx;
+
+  while ((c = getopt_long(argc, argv, "hb:j:n:", lopts,&optionIdx)) != -1) {
+    switch (c) {
+    case 'b':
+      bins_=lti::max(1,atoi(optarg));
+      break;
+    case 'j':
+      threads_=lti::max(0,atoi(optarg));
+      break;
+    case 'n':
+      repetitions_=lti::max(1,atoi(optarg));
+      break;
+    case 'h':
+      usage();
+      exit(EXIT_SUCCESS);
+      break;
+    default:
+      cerr << "Option '-" << static_cast<char>(c) << "' not recognized." 
+           << endl;
+    }
+  }
+  
+  while (optind < argc) {
+    inputs_.push_back(argv[optind++]);
+  }
+
+  if (inputs_.empty()) {
+    inputs_.push_back("../../Micrografías");
+  }
+}
+
+bool histogramBench::apply() {
+  std::vector<std::string> files;
+  lti::collectImageFiles(inputs_,std::string(),files);
+
+  // the whole corpus is kept in memory, as bytes and as floats
+  lti::ioImage loader;
+  std::vector<lti::channel> chnls;
+  std::vector<lti::channel8> chnl8s;
+  double pixels = 0.0;
+
+  for (unsigned int i=0;i<files.size();++i) {
+    lti::image img;
+    if (!loader.load(files[i],img)) {
+      cerr << "Image '" << files[i] << "' could not be read: "
+           << loader.getStatusString() << endl;
+      continue;
+    }
+    chnls.push_back(lti::channel());
+    chnls.back().castFrom(img);
+    chnl8s.push_back(lti::channel8());
+    chnl8s.back().castFrom(img);
+    pixels += static_cast<double>(img.rows())*img.columns();
+  }
+
+  if (chnls.empty()) {
+    cerr << "No images to evaluate." << endl;
+    usage();
+    return false;
+  }
+
+  const int threads = (threads_ > 0) ? threads_ :
+    lti::workerPool::getNumberOfProcessors();
+
+  cout << "Histograms of " << chnls.size() << " images ("
+       << pixels/1000000.0 << " Mpixel), best of " << repetitions_
+       << " runs, " << threads << " threads in parallel" << endl << endl;
+
+  // microseconds and differing pixels per method, for bytes and floats
+  std::vector<double> times(2*numMethods,0.0);
+  std::vector<double> diffs(2*numMethods,0.0);
+
+  for (unsigned int i=0;i<chnls.size();++i) {
+    lti::ivector ref,hist;
+    for (int m=0;m<numMethods;++m) {
+      const eMethod method = static_cast<eMethod>(m);
+      times[m] += timeHistogram(method,chnl8s[i],256,threads,
+                                repetitions_,hist);
+      if (m == Loop) {
+        ref.copy(hist);
+      }
+      diffs[m] += differences(hist,ref);
+    }
+    for (int m=0;m<numMethods;++m) {
+      const eMethod method = static_cast<eMethod>(m);
+      times[numMethods+m] += timeHistogram(method,chnls[i],bins_,threads,
+                                           repetitions_,hist);
+      if (m == Loop) {
+        ref.copy(hist);
+      }
+      diffs[numMethods+m] += differences(hist,ref);
+    }
+    cerr << "." << std::flush;
+  }
+  cerr << endl;
+
+  cout << std::left << std::setw(8) << "input"
+       << std::setw(14) << "method"
+       << std::right << std::setw(10) << "ns/pixel"
+       << std::setw(12) << "Mpixel/s"
+       << std::setw(10) << "speedup"
+       << std::setw(12) << "differing" << endl;
+
+  for (int t=0;t<2;++t) {
+    const double loopTime = times[t*numMethods+Loop];
+    for (int m=0;m<numMethods;++m) {
+      const double us = times[t*numMethods+m];
+      cout << std::left << std::setw(8) << ((t == 0) ? "byte" : "float")
+           << std::setw(14) << methodNames[m] << std::right << std::fixed
+           << std::setprecision(2) << std::setw(10) << us*1000.0/pixels
+           << std::setprecision(1) << std::setw(12) << pixels/us
+           << std::setprecision(2) << std::setw(10) << loopTime/us
+           << std::setprecision(0) << std::setw(12) << diffs[t*numMethods+m]
+           << endl;
+    }
+  }
+  cout << "Byte histograms have 256 bins, float histograms " << bins_
+       << endl;
+
+  return true;
+}
+
+/*
+ * Main method
+ */
+int main(int argc, char* argv[]) {
+  
+  histogramBench me(argc,argv);
+  if (me.apply()) {
+    return EXIT_SUCCESS;
+  }
+
+  return EXIT_FAILURE;
+}
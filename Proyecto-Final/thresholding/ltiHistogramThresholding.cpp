@@ -0,0 +1,937 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiHistogramThresholding.cpp
+ *         Thresholding of a channel searching the thresholds in a histogram
+ *         computed only once per image, or with local adaptive thresholds.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#include "ltiHistogramThresholding.h"
+#include "ltiMath.h"
+#include "ltiMatrix.h"
+#include "ltiWorkerPool.h"
+#include "ltiHistogramEngine.h"
+
+#undef _LTI_DEBUG
+//#define _LTI_DEBUG 4
+#include "ltiDebug.h"
+
+namespace lti {
+  // --------------------------------------------------
+  // histogramThresholding::parameters
+  // --------------------------------------------------
+
+  // default constructor
+  histogramThresholding::parameters::parameters()
+    : thresholding::parameters() {
+    localMethod = Global;
+    windowSize = 31;
+    localK = 0.2f;
+    dynamicRange = 0.5f;
+    threads = 0;
+    classes = 3;
+  }
+
+  // copy constructor
+  histogramThresholding::parameters::parameters(const parameters& other)
+    : thresholding::parameters() {
+    copy(other);
+  }
+
+  // destructor
+  histogramThresholding::parameters::~parameters() {
+  }
+
+  // copy member
+  histogramThresholding::parameters&
+  histogramThresholding::parameters::copy(const parameters& other) {
+    thresholding::parameters::copy(other);
+
+    localMethod  = other.localMethod;
+    windowSize   = other.windowSize;
+    localK       = other.localK;
+    dynamicRange = other.dynamicRange;
+    threads      = other.threads;
+    classes      = other.classes;
+
+    return *this;
+  }
+
+  // alias for copy method
+  histogramThresholding::parameters&
+  histogramThresholding::parameters::operator=(const parameters& other) {
+    return copy(other);
+  }
+
+  // class name
+  const std::string& histogramThresholding::parameters::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone method
+  histogramThresholding::parameters*
+  histogramThresholding::parameters::clone() const {
+    return new parameters(*this);
+  }
+
+  // new instance
+  histogramThresholding::parameters*
+  histogramThresholding::parameters::newInstance() const {
+    return new parameters();
+  }
+
+  bool histogramThresholding::parameters::write(ioHandler& handler,
+                                                const bool complete) const {
+    bool b = true;
+    if (complete) {
+      b = handler.writeBegin();
+    }
+
+    if (b) {
+      b = lti::write(handler,"localMethod",localMethod) && b;
+      b = lti::write(handler,"windowSize",windowSize) && b;
+      b = lti::write(handler,"localK",localK) && b;
+      b = lti::write(handler,"dynamicRange",dynamicRange) && b;
+      b = lti::write(handler,"threads",threads) && b;
+      b = lti::write(handler,"classes",classes) && b;
+    }
+
+    b = b && thresholding::parameters::write(handler,false);
+
+    if (complete) {
+      b = b && handler.writeEnd();
+    }
+
+    return b;
+  }
+
+  bool histogramThresholding::parameters::read(ioHandler& handler,
+                                               const bool complete) {
+    bool b = true;
+    if (complete) {
+      b = handler.readBegin();
+    }
+
+    if (b) {
+      b = lti::read(handler,"localMethod",localMethod) && b;
+      b = lti::read(handler,"windowSize",windowSize) && b;
+      b = lti::read(handler,"localK",localK) && b;
+      b = lti::read(handler,"dynamicRange",dynamicRange) && b;
+      b = lti::read(handler,"threads",threads) && b;
+      b = lti::read(handler,"classes",classes) && b;
+    }
+
+    b = b && thresholding::parameters::read(handler,false);
+
+    if (complete) {
+      b = b && handler.readEnd();
+    }
+
+    return b;
+  }
+
+  // --------------------------------------------------
+  // histogramThresholding
+  // --------------------------------------------------
+
+  // default constructor
+  histogramThresholding::histogramThresholding()
+    : functor(),min_(0.0f),max_(0.0f) {
+    // create an instance of the parameters with the default values
+    parameters defaultParameters;
+    // set the default parameters
+    setParameters(defaultParameters);
+  }
+
+  // constructor with parameters
+  histogramThresholding::histogramThresholding(const parameters& par)
+    : functor(),min_(0.0f),max_(0.0f) {
+    // set the given parameters
+    setParameters(par);
+  }
+
+  // copy constructor
+  histogramThresholding::histogramThresholding(
+                                      const histogramThresholding& other)
+    : functor() {
+    copy(other);
+  }
+
+  // destructor
+  histogramThresholding::~histogramThresholding() {
+  }
+
+  // copy member
+  histogramThresholding&
+  histogramThresholding::copy(const histogramThresholding& other) {
+    functor::copy(other);
+
+    src_.copy(other.src_);
+    src8_.copy(other.src8_);
+    histogram_.copy(other.histogram_);
+    min_ = other.min_;
+    max_ = other.max_;
+
+    return *this;
+  }
+
+  // alias for copy member
+  histogramThresholding&
+  histogramThresholding::operator=(const histogramThresholding& other) {
+    return (copy(other));
+  }
+
+  // class name
+  const std::string& histogramThresholding::name() const {
+    _LTI_RETURN_CLASS_NAME
+  }
+
+  // clone member
+  histogramThresholding* histogramThresholding::clone() const {
+    return new histogramThresholding(*this);
+  }
+
+  // create a new instance
+  histogramThresholding* histogramThresholding::newInstance() const {
+    return new histogramThresholding();
+  }
+
+  // return parameters
+  const histogramThresholding::parameters&
+  histogramThresholding::getParameters() const {
+    const parameters* par =
+      dynamic_cast<const parameters*>(&functor::getParameters());
+    if (par == 0) {
+      throw invalidParametersException(name());
+    }
+    return *par;
+  }
+
+  const ivector& histogramThresholding::getHistogram() const {
+    return histogram_;
+  }
+
+  inline int histogramThresholding::bin(const float value) const {
+    const int bins = histogram_.size();
+    return within(static_cast<int>(value*bins),0,bins-1);
+  }
+
+  bool histogramThresholding::use(const channel& src) {
+    src_.copy(src);
+    src8_.clear();
+    histogram_.clear();
+    return computeHistogram(getParameters().histogramBins);
+  }
+
+  bool histogramThresholding::use(const channel8& src) {
+    src8_.copy(src);
+    src_.clear();
+    histogram_.clear();
+    return computeHistogram(getParameters().histogramBins);
+  }
+
+  bool histogramThresholding::use(const ivector& histogram,
+                                  const float minValue,
+                                  const float maxValue) {
+    if (histogram.size() != getParameters().histogramBins) {
+      setStatusString("The histogram must have parameters::histogramBins bins");
+      return false;
+    }
+    src_.clear();
+    src8_.clear();
+    histogram_.copy(histogram);
+    min_ = minValue;
+    max_ = maxValue;
+    return true;
+  }
+
+  bool histogramThresholding::computeHistogram(const int bins) {
+    if (bins <= 0) {
+      setStatusString("The number of histogram bins must be positive");
+      return false;
+    }
+
+    histogramEngine::parameters hPar;
+    hPar.bins = bins;
+    hPar.threads = getParameters().threads;
+    histogramEngine engine(hPar);
+
+    bool b;
+    if (!src8_.empty()) {
+      b = engine.apply(src8_,histogram_);
+    } else if (!src_.empty()) {
+      b = engine.apply(src_,histogram_);
+    } else {
+      setStatusString("No input channel given");
+      return false;
+    }
+
+    if (!b) {
+      setStatusString(engine.getStatusString());
+      return false;
+    }
+
+    min_ = engine.getMinimum();
+    max_ = engine.getMaximum();
+    return true;
+  }
+
+  int histogramThresholding::otsu(const int first,const int last) const {
+    // total mass and first moment of the interval
+    double n = 0.0,m = 0.0;
+    for (int k=first;k<=last;++k) {
+      n += histogram_.at(k);
+      m += static_cast<double>(k)*histogram_.at(k);
+    }
+
+    // background in [first,t-1], foreground in [t,last]
+    int best = first;
+    double bestVar = -1.0;
+    double n0 = 0.0,m0 = 0.0;
+    for (int t=first+1;t<=last;++t) {
+      n0 += histogram_.at(t-1);
+      m0 += static_cast<double>(t-1)*histogram_.at(t-1);
+      const double n1 = n-n0;
+      if ((n0 <= 0.0) || (n1 <= 0.0)) {
+        continue;
+      }
+      const double d = m0/n0 - (m-m0)/n1;
+      const double var = n0*n1*d*d;
+      if (var > bestVar) {
+        bestVar = var;
+        best = t;
+      }
+    }
+
+    return best;
+  }
+
+  int histogramThresholding::simple(const int first,
+                                    const int last,
+                                    const float deltaT) const {
+    double n = 0.0,m = 0.0;
+    for (int k=first;k<=last;++k) {
+      n += histogram_.at(k);
+      m += static_cast<double>(k)*histogram_.at(k);
+    }
+    if (n <= 0.0) {
+      return first;
+    }
+
+    // start at the mean and move to the mean of the class means
+    double t = m/n;
+    for (int i=0;i<256;++i) {
+      const int s = within(static_cast<int>(ceil(t)),first,last);
+      double n0 = 0.0,m0 = 0.0;
+      for (int k=first;k<s;++k) {
+        n0 += histogram_.at(k);
+        m0 += static_cast<double>(k)*histogram_.at(k);
+      }
+      const double n1 = n-n0;
+      if ((n0 <= 0.0) || (n1 <= 0.0)) {
+        break;
+      }
+      const double nt = 0.5*(m0/n0 + (m-m0)/n1);
+      const bool done = (abs(nt-t) < deltaT);
+      t = nt;
+      if (done) {
+        break;
+      }
+    }
+
+    return within(static_cast<int>(ceil(t)),first,last);
+  }
+
+  bool histogramThresholding::multiOtsu(const int classes,
+                                       std::vector<int>& starts) const {
+    const int bins = histogram_.size();
+    starts.clear();
+    if ((classes < 2) || (classes > bins)) {
+      setStatusString("The number of classes must be between 2 and the "
+                      "number of bins");
+      return false;
+    }
+
+    // mass and first moment of the bins [0,i[
+    std::vector<double> p(bins+1,0.0),s(bins+1,0.0);
+    for (int i=0;i<bins;++i) {
+      p[i+1] = p[i] + histogram_.at(i);
+      s[i+1] = s[i] + static_cast<double>(i)*histogram_.at(i);
+    }
+
+    // The between-class variance differs only by a constant from the sum
+    // of S^2/P over the classes.  best[c][j] is the largest sum for the
+    // bins [0,j[ split into c+1 classes, and from[c][j] the first bin of
+    // the last of them.
+    std::vector< std::vector<double> > best(classes,
+                                            std::vector<double>(bins+1,0.0));
+    std::vector< std::vector<int> > from(classes,std::vector<int>(bins+1,0));
+
+    for (int j=1;j<=bins;++j) {
+      best[0][j] = (p[j] > 0.0) ? s[j]*s[j]/p[j] : 0.0;
+    }
+
+    for (int c=1;c<classes;++c) {
+      for (int j=c+1;j<=bins;++j) {
+        double bestSum = -1.0;
+        int bestFrom = c;
+        for (int i=c;i<j;++i) {
+          const double dp = p[j]-p[i];
+          const double ds = s[j]-s[i];
+          const double sum = best[c-1][i] + ((dp > 0.0) ? ds*ds/dp : 0.0);
+          if (sum > bestSum) {
+            bestSum = sum;
+            bestFrom = i;
+          }
+        }
+        best[c][j] = bestSum;
+        from[c][j] = bestFrom;
+      }
+    }
+
+    // backtrack the class boundaries
+    starts.resize(classes-1);
+    int j = bins;
+    for (int c=classes-1;c>0;--c) {
+      j = from[c][j];
+      starts[c-1] = j;
+    }
+
+    return true;
+  }
+
+  bool histogramThresholding::thresholds(fvector& thresholds) {
+    const parameters& par = getParameters();
+
+    if (histogram_.size() != par.histogramBins) {
+      if (!computeHistogram(par.histogramBins)) {
+        return false;
+      }
+    }
+
+    std::vector<int> starts;
+    if (!multiOtsu(par.classes,starts)) {
+      return false;
+    }
+
+    const float fbins = static_cast<float>(histogram_.size());
+    thresholds.allocate(static_cast<int>(starts.size()));
+    for (unsigned int i=0;i<starts.size();++i) {
+      thresholds.at(i) = starts[i]/fbins;
+    }
+
+    return true;
+  }
+
+  bool histogramThresholding::label(channel8& labels) {
+    const parameters& par = getParameters();
+
+    if (histogram_.size() != par.histogramBins) {
+      if (!computeHistogram(par.histogramBins)) {
+        return false;
+      }
+    }
+
+    std::vector<int> starts;
+    if (!multiOtsu(par.classes,starts)) {
+      return false;
+    }
+
+    // class of each bin
+    const int bins = histogram_.size();
+    std::vector<ubyte> classOf(bins,0);
+    for (unsigned int c=0;c<starts.size();++c) {
+      for (int i=starts[c];i<bins;++i) {
+        classOf[i] = static_cast<ubyte>(c+1);
+      }
+    }
+
+    if (!src8_.empty()) {
+      ubyte lut[256];
+      for (int i=0;i<256;++i) {
+        lut[i] = classOf[bin(i/255.0f)];
+      }
+
+      labels.allocate(src8_.size());
+      for (int y=0;y<src8_.rows();++y) {
+        const ubyte* p = &src8_.at(y,0);
+        const ubyte* const e = p+src8_.columns();
+        ubyte* q = &labels.at(y,0);
+        for (;p!=e;++p,++q) {
+          *q = lut[*p];
+        }
+      }
+      return true;
+    }
+
+    labels.allocate(src_.size());
+    for (int y=0;y<src_.rows();++y) {
+      const float* p = &src_.at(y,0);
+      const float* const e = p+src_.columns();
+      ubyte* q = &labels.at(y,0);
+      for (;p!=e;++p,++q) {
+        *q = classOf[bin(*p)];
+      }
+    }
+    return true;
+  }
+
+  bool histogramThresholding::interval(float& from,float& to) {
+    const parameters& par = getParameters();
+
+    if (histogram_.size() != par.histogramBins) {
+      if (!computeHistogram(par.histogramBins)) {
+        return false;
+      }
+    }
+
+    const int bins = histogram_.size();
+    const float fbins = static_cast<float>(bins);
+    from = par.foreground.from;
+    to = par.foreground.to;
+
+    switch(par.method) {
+    case thresholding::Direct:
+      break;
+    case thresholding::Relative:
+      from = min_ + par.foreground.from*(max_-min_);
+      to = min_ + par.foreground.to*(max_-min_);
+      break;
+    case thresholding::Otsu:
+      from = otsu(0,bins-1)/fbins;
+      to = 1.0f;
+      break;
+    case thresholding::OtsuInterval:
+      from = otsu(bin(from),bin(to))/fbins;
+      break;
+    case thresholding::Simple:
+      from = simple(0,bins-1,par.deltaT)/fbins;
+      to = 1.0f;
+      break;
+    case thresholding::SimpleInterval:
+      from = simple(bin(from),bin(to),par.deltaT)/fbins;
+      break;
+    default:
+      setStatusString("Unknown thresholding method");
+      return false;
+    }
+
+    return true;
+  }
+
+  bool histogramThresholding::apply(channel8& mask) {
+    const parameters& par = getParameters();
+
+    if (par.localMethod != Global) {
+      return localThreshold(par,mask);
+    }
+
+    float from,to;
+    if (!interval(from,to)) {
+      return false;
+    }
+
+    if (!src8_.empty()) {
+      return apply(src8_,from,to,mask);
+    }
+    return apply(src_,from,to,mask);
+  }
+
+  bool histogramThresholding::apply(const channel8& src,
+                                    const float from,
+                                    const float to,
+                                    channel8& mask) const {
+    const parameters& par = getParameters();
+
+    const ubyte bg = static_cast<ubyte>(within(iround(255.0f*
+                                                      par.backgroundValue),
+                                               0,255));
+    const ubyte fg = static_cast<ubyte>(within(iround(255.0f*
+                                                      par.foregroundValue),
+                                               0,255));
+
+    // the whole decision for each of the 256 possible values
+    ubyte lut[256];
+    for (int i=0;i<256;++i) {
+      const float v = i/255.0f;
+      if ((v >= from) && (v <= to)) {
+        lut[i] = par.keepForeground ? static_cast<ubyte>(i) : fg;
+      } else {
+        lut[i] = par.keepBackground ? static_cast<ubyte>(i) : bg;
+      }
+    }
+
+    mask.allocate(src.size());
+    for (int y=0;y<src.rows();++y) {
+      const ubyte* p = &src.at(y,0);
+      const ubyte* const e = p+src.columns();
+      ubyte* q = &mask.at(y,0);
+      for (;p!=e;++p,++q) {
+        *q = lut[*p];
+      }
+    }
+    return true;
+  }
+
+  bool histogramThresholding::apply(const channel& src,
+                                    const float from,
+                                    const float to,
+                                    channel8& mask) const {
+    const parameters& par = getParameters();
+
+    const ubyte bg = static_cast<ubyte>(within(iround(255.0f*
+                                                      par.backgroundValue),
+                                               0,255));
+    const ubyte fg = static_cast<ubyte>(within(iround(255.0f*
+                                                      par.foregroundValue),
+                                               0,255));
+
+    mask.allocate(src.size());
+    for (int y=0;y<src.rows();++y) {
+      const float* p = &src.at(y,0);
+      const float* const e = p+src.columns();
+      ubyte* q = &mask.at(y,0);
+      for (;p!=e;++p,++q) {
+        if ((*p >= from) && (*p <= to)) {
+          *q = par.keepForeground ?
+            static_cast<ubyte>(within(iround(255.0f*(*p)),0,255)) : fg;
+        } else {
+          *q = par.keepBackground ?
+            static_cast<ubyte>(within(iround(255.0f*(*p)),0,255)) : bg;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool histogramThresholding::apply(bitMask& mask) {
+    const parameters& par = getParameters();
+
+    if (par.localMethod != Global) {
+      // the local thresholds through a plain mask of 0 and 255
+      parameters binPar(par);
+      binPar.keepBackground = binPar.keepForeground = false;
+      binPar.backgroundValue = 0.0f;
+      binPar.foregroundValue = 1.0f;
+      channel8 tmp;
+      if (!localThreshold(binPar,tmp)) {
+        return false;
+      }
+      mask.castFrom(tmp);
+      return true;
+    }
+
+    float from,to;
+    if (!interval(from,to)) {
+      return false;
+    }
+
+    if (!src8_.empty()) {
+      bool lut[256];
+      for (int i=0;i<256;++i) {
+        const float v = i/255.0f;
+        lut[i] = (v >= from) && (v <= to);
+      }
+
+      mask.allocate(src8_.rows(),src8_.columns());
+      const int cols = src8_.columns();
+      for (int y=0;y<src8_.rows();++y) {
+        const ubyte* p = &src8_.at(y,0);
+        bitMask::word* w = mask.row(y);
+        for (int x=0;x<cols;x+=bitMask::BitsPerWord,++w) {
+          const int n = min(cols-x,static_cast<int>(bitMask::BitsPerWord));
+          bitMask::word bits = 0;
+          for (int b=0;b<n;++b) {
+            bits |= static_cast<bitMask::word>(lut[p[x+b]]) << b;
+          }
+          *w = bits;
+        }
+      }
+      return true;
+    }
+
+    mask.allocate(src_.rows(),src_.columns());
+    const int cols = src_.columns();
+    for (int y=0;y<src_.rows();++y) {
+      const float* p = &src_.at(y,0);
+      bitMask::word* w = mask.row(y);
+      for (int x=0;x<cols;x+=bitMask::BitsPerWord,++w) {
+        const int n = min(cols-x,static_cast<int>(bitMask::BitsPerWord));
+        bitMask::word bits = 0;
+        for (int b=0;b<n;++b) {
+          bits |= static_cast<bitMask::word>((p[x+b] >= from) &&
+                                             (p[x+b] <= to)) << b;
+        }
+        *w = bits;
+      }
+    }
+    return true;
+  }
+
+  // -------------------------------------------------------------------
+  // Local adaptive thresholds
+  // -------------------------------------------------------------------
+
+  /**
+   * The integral images have one row and one column more than the input,
+   * so that the sum over the window [x0,x1]x[y0,y1] is
+   * I(y1+1,x1+1) - I(y0,x1+1) - I(y1+1,x0) + I(y0,x0).  Doubles hold the
+   * sums of squares of channel8 values exactly for any realistic size.
+   */
+  class histogramThresholding::localJob : public workerPool::job {
+  public:
+    /**
+     * What is computed for each item
+     */
+    enum ePhase {
+      Rows,     /**< Prefix sums along each row (one item per row) */
+      Columns,  /**< Prefix sums along the columns (one item per block of
+                 *   columns) */
+      Threshold /**< Mask of each row (one item per row) */
+    };
+
+    /**
+     * Columns of each item in the Columns phase, enough to keep each row
+     * access sequential
+     */
+    static const int BlockSize = 64;
+
+    localJob(const parameters& par,
+             const channel* src,
+             const channel8* src8,
+             channel8& mask)
+      : phase(Rows),par_(par),src_(src),src8_(src8),mask_(mask) {
+      rows_ = (src8_ != 0) ? src8_->rows() : src_->rows();
+      cols_ = (src8_ != 0) ? src8_->columns() : src_->columns();
+      scale_ = (src8_ != 0) ? 1.0/255.0 : 1.0;
+      half_ = max(0,par.windowSize/2);
+      bg_ = static_cast<ubyte>(within(iround(255.0f*par.backgroundValue),
+                                      0,255));
+      fg_ = static_cast<ubyte>(within(iround(255.0f*par.foregroundValue),
+                                      0,255));
+      sum_.allocate(rows_+1,cols_+1);
+      sum2_.allocate(rows_+1,cols_+1);
+      for (int x=0;x<=cols_;++x) {
+        sum_.at(0,x) = sum2_.at(0,x) = 0.0;
+      }
+      mask_.allocate(rows_,cols_);
+    }
+
+    virtual void process(const int from,const int to,const int) {
+      switch(phase) {
+      case Rows:
+        for (int y=from;y<to;++y) {
+          rowSums(y);
+        }
+        break;
+      case Columns:
+        columnSums(from*BlockSize,min(cols_+1,to*BlockSize));
+        break;
+      case Threshold:
+        for (int y=from;y<to;++y) {
+          threshold(y);
+        }
+        break;
+      }
+    }
+
+    /**
+     * Items of the Columns phase
+     */
+    int columnBlocks() const {
+      return (cols_+BlockSize)/BlockSize;
+    }
+
+    /**
+     * Current phase
+     */
+    ePhase phase;
+
+  private:
+    /**
+     * Value of the input at (y,x), in the units of the integral images
+     */
+    inline double value(const int y,const int x) const {
+      return (src8_ != 0) ? static_cast<double>(src8_->at(y,x)) :
+                            static_cast<double>(src_->at(y,x));
+    }
+
+    void rowSums(const int y) {
+      double* s = &sum_.at(y+1,0);
+      double* s2 = &sum2_.at(y+1,0);
+      double a = 0.0,a2 = 0.0;
+      s[0] = s2[0] = 0.0;
+      for (int x=0;x<cols_;++x) {
+        const double v = value(y,x);
+        a += v;
+        a2 += v*v;
+        s[x+1] = a;
+        s2[x+1] = a2;
+      }
+    }
+
+    void columnSums(const int from,const int to) {
+      for (int y=1;y<=rows_;++y) {
+        const double* p = &sum_.at(y-1,0);
+        const double* p2 = &sum2_.at(y-1,0);
+        double* s = &sum_.at(y,0);
+        double* s2 = &sum2_.at(y,0);
+        for (int x=from;x<to;++x) {
+          s[x] += p[x];
+          s2[x] += p2[x];
+        }
+      }
+    }
+
+    void threshold(const int y) {
+      const int y0 = max(0,y-half_);
+      const int y1 = min(rows_,y+half_+1);
+      const double* t = &sum_.at(y0,0);
+      const double* b = &sum_.at(y1,0);
+      const double* t2 = &sum2_.at(y0,0);
+      const double* b2 = &sum2_.at(y1,0);
+      const double k = par_.localK;
+      const double r = (par_.dynamicRange > 0.0f) ? par_.dynamicRange : 1.0;
+      ubyte* m = &mask_.at(y,0);
+
+      for (int x=0;x<cols_;++x) {
+        const int x0 = max(0,x-half_);
+        const int x1 = min(cols_,x+half_+1);
+        const double n = static_cast<double>(y1-y0)*(x1-x0);
+        const double s = b[x1] - t[x1] - b[x0] + t[x0];
+        const double s2 = b2[x1] - t2[x1] - b2[x0] + t2[x0];
+
+        const double mean = s/n;
+        const double dev = sqrt(max(0.0,s2/n - mean*mean))*scale_;
+        const double thresh = (par_.localMethod == Sauvola) ?
+          mean*scale_*(1.0 + k*(dev/r - 1.0)) :
+          mean*scale_ + k*dev;
+
+        const double v = value(y,x)*scale_;
+        if (v >= thresh) {
+          m[x] = par_.keepForeground ?
+            static_cast<ubyte>(within(iround(255.0*v),0,255)) : fg_;
+        } else {
+          m[x] = par_.keepBackground ?
+            static_cast<ubyte>(within(iround(255.0*v),0,255)) : bg_;
+        }
+      }
+    }
+
+    const parameters& par_;
+    const channel* src_;
+    const channel8* src8_;
+    channel8& mask_;
+    int rows_,cols_,half_;
+    double scale_;
+    ubyte bg_,fg_;
+
+    /**
+     * Integral images of the values and of their squares
+     */
+    dmatrix sum_,sum2_;
+  };
+
+  bool histogramThresholding::localThreshold(const parameters& par,
+                                             channel8& mask) const {
+    if (src8_.empty() && src_.empty()) {
+      setStatusString("No input channel given");
+      return false;
+    }
+
+    localJob job(par,
+                 src8_.empty() ? &src_ : 0,
+                 src8_.empty() ? 0 : &src8_,
+                 mask);
+    workerPool pool(par.threads);
+
+    job.phase = localJob::Rows;
+    pool.apply(job,mask.rows(),16);
+    job.phase = localJob::Columns;
+    pool.apply(job,job.columnBlocks());
+    job.phase = localJob::Threshold;
+    pool.apply(job,mask.rows(),16);
+
+    return true;
+  }
+
+  bool histogramThresholding::apply(const channel& src,channel8& mask) {
+    return use(src) && apply(mask);
+  }
+
+  bool histogramThresholding::apply(const channel8& src,channel8& mask) {
+    return use(src) && apply(mask);
+  }
+
+  // -------------------------------------------------------------------
+  // Storable interface
+  // -------------------------------------------------------------------
+
+  bool read(ioHandler& handler,histogramThresholding::eLocalMethod& data) {
+    std::string str;
+    if (handler.read(str)) {
+      if (str.find("iblack") != std::string::npos) {
+        data = histogramThresholding::Niblack;
+      } else if (str.find("auvola") != std::string::npos) {
+        data = histogramThresholding::Sauvola;
+      } else {
+        data = histogramThresholding::Global;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  bool write(ioHandler& handler,
+             const histogramThresholding::eLocalMethod& data) {
+    switch(data) {
+    case histogramThresholding::Niblack:
+      return handler.write("Niblack");
+    case histogramThresholding::Sauvola:
+      return handler.write("Sauvola");
+    default:
+      return handler.write("Global");
+    }
+    return false;
+  }
+
+}
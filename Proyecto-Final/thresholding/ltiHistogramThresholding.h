@@ -0,0 +1,527 @@
+/*
+ * Copyright (C) 2026 by agent
+ * 
+ * This file is part of the LTI-Computer Vision Library 2 (LTI-Lib-2)
+ *
+ * The LTI-Lib-2 is free software; you can redistribute it and/or
+ * modify it under the terms of the BSD License.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the authors nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** 
+ * \file   ltiHistogramThresholding.h
+ *         Thresholding of a channel searching the thresholds in a histogram
+ *         computed only once per image, or with local adaptive thresholds.
+ * \author agent
+ * \date   17.10.2026
+ *
+ * revisions ..: $Id$
+ */
+
+#ifndef _LTI_HISTOGRAM_THRESHOLDING_H_
+#define _LTI_HISTOGRAM_THRESHOLDING_H_
+
+#include "ltiFunctor.h"
+#include "ltiThresholding.h"
+#include "ltiChannel.h"
+#include "ltiChannel8.h"
+#include "ltiVector.h"
+#include "ltiBitMask.h"
+
+#include <vector>
+
+namespace lti {
+
+  /**
+   * Histogram based thresholding.
+   *
+   * lti::thresholding computes the histogram of the whole channel each
+   * time apply() is called, although for an interactive session or a
+   * batch of parameter variations the channel does not change.  This
+   * functor computes the histogram with parameters::histogramBins bins in
+   * use() (with lti::histogramEngine) and keeps it, so that the search of
+   * the thresholds for the methods Relative, Otsu, OtsuInterval, Simple
+   * and SimpleInterval only visits the bins.  The histogram is recomputed
+   * only if the number of bins changes.
+   *
+   * For a channel8 the mask is produced with a lookup table of 256
+   * entries, so that each pixel costs a single load and store.
+   *
+   * The methods are interpreted as follows, with the values of the
+   * channel in [0,1] (channel8 values are divided by 255):
+   * - Direct: the foreground is the interval given in the parameters.
+   * - Relative: the interval is relative to the minimum and maximum values
+   *   of the channel.
+   * - Otsu: the threshold maximizes the between-class variance of the
+   *   whole histogram, and the foreground is everything above it.
+   * - OtsuInterval: as Otsu, but considering only the bins within the
+   *   given interval, which keeps its upper limit.
+   * - Simple: the iterative selection of Ridler and Calvard, where the
+   *   threshold is the mean of the means of both classes, until it
+   *   changes less than parameters::deltaT bins.
+   * - SimpleInterval: as Simple, but considering only the bins within the
+   *   given interval.
+   *
+   * Micrographs with uneven illumination cannot be separated with a single
+   * interval.  If parameters::localMethod is not Global, the threshold of
+   * each pixel is computed from the mean \f$m\f$ and the standard
+   * deviation \f$s\f$ of the window of parameters::windowSize pixels
+   * around it, and the pixel is foreground if it is not below that
+   * threshold (the method and the interval are then ignored):
+   * - Niblack: \f$m + k s\f$
+   * - Sauvola: \f$m \left(1 + k (s/R - 1)\right)\f$
+   *
+   * with \f$k\f$ = parameters::localK and \f$R\f$ =
+   * parameters::dynamicRange.  Both statistics are taken from integral
+   * images of the values and of their squares, so that each pixel costs
+   * four lookups in each one, whatever the window size.  The rows are
+   * processed in parallel by a lti::workerPool.
+   *
+   * Samples with more than two phases are separated with label(), the
+   * multi-level Otsu method: the histogram is split into
+   * parameters::classes classes maximizing the between-class variance.
+   * With cumulative tables of the mass and the first moment of the bins,
+   * the contribution of any class is computed in constant time, and a
+   * dynamic programming search over the class boundaries finds the
+   * optimum in \f$O(KB^2)\f$ for \f$K\f$ classes and \f$B\f$ bins,
+   * instead of testing all \f$O(B^{K-1})\f$ combinations.
+   *
+   * Example:
+   * \code
+   * lti::histogramThresholding thresh(par);
+   * thresh.use(chnl8);
+   * for (int i=0;i<10;++i) {
+   *   par.foreground.from = i*0.1f;
+   *   thresh.setParameters(par);
+   *   thresh.apply(mask); // no histogram computation here
+   * }
+   * \endcode
+   */
+  class histogramThresholding : public functor {
+  public:
+    /**
+     * Local adaptive methods
+     */
+    enum eLocalMethod {
+      Global,  /**< One interval for the whole channel, given by
+                *   thresholding::parameters::method */
+      Niblack, /**< Mean plus k standard deviations of the window */
+      Sauvola  /**< Mean scaled by the relative standard deviation of the
+                *   window */
+    };
+
+    /**
+     * The parameters for the class histogramThresholding
+     */
+    class parameters : public thresholding::parameters {
+    public:
+      /**
+       * Default constructor
+       */
+      parameters();
+
+      /**
+       * Copy constructor
+       * @param other the parameters object to be copied
+       */
+      parameters(const parameters& other);
+
+      /**
+       * Destructor
+       */
+      ~parameters();
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& copy(const parameters& other);
+
+      /**
+       * Copy the contents of a parameters object
+       * @param other the parameters object to be copied
+       * @return a reference to this parameters object
+       */
+      parameters& operator=(const parameters& other);
+
+      /**
+       * Returns the complete name of the parameters class.
+       */
+      virtual const std::string& name() const;
+
+      /**
+       * Returns a pointer to a clone of the parameters
+       */
+      virtual parameters* clone() const;
+
+      /**
+       * Returns a pointer to a new instance of the parameters
+       */
+      virtual parameters* newInstance() const;
+
+      /**
+       * Write the parameters in the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool write(ioHandler& handler,const bool complete=true) const;
+
+      /**
+       * Read the parameters from the given ioHandler
+       * @param handler the ioHandler to be used
+       * @param complete if true (the default) the enclosing begin/end will
+       *        be also written, otherwise only the data block will be written.
+       * @return true if write was successful
+       */
+      virtual bool read(ioHandler& handler,const bool complete=true);
+
+      // ------------------------------------------------
+      // the parameters
+      // ------------------------------------------------
+
+      /**
+       * Local adaptive method, or Global to use the method of
+       * thresholding::parameters.
+       *
+       * Default value: Global
+       */
+      eLocalMethod localMethod;
+
+      /**
+       * Side of the square window for the local statistics.  Even values
+       * are increased by one.
+       *
+       * Default value: 31
+       */
+      int windowSize;
+
+      /**
+       * Weight k of the standard deviation in the local methods.
+       *
+       * Default value: 0.2
+       */
+      float localK;
+
+      /**
+       * Dynamic range R of the standard deviation in the Sauvola method,
+       * for values in [0,1].
+       *
+       * Default value: 0.5
+       */
+      float dynamicRange;
+
+      /**
+       * Number of threads for the histogram and the local methods.  If
+       * zero, one per processor.
+       *
+       * Default value: 0
+       */
+      int threads;
+
+      /**
+       * Number of classes of the multi-level Otsu method used by label().
+       *
+       * Default value: 3
+       */
+      int classes;
+    };
+
+    /**
+     * Default constructor
+     */
+    histogramThresholding();
+
+    /**
+     * Construct a functor using the given parameters
+     */
+    histogramThresholding(const parameters& par);
+
+    /**
+     * Copy constructor
+     * @param other the object to be copied
+     */
+    histogramThresholding(const histogramThresholding& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~histogramThresholding();
+
+    /**
+     * Copy data of "other" functor.
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    histogramThresholding& copy(const histogramThresholding& other);
+
+    /**
+     * Alias for copy member
+     * @param other the functor to be copied
+     * @return a reference to this functor object
+     */
+    histogramThresholding& operator=(const histogramThresholding& other);
+
+    /**
+     * Returns the complete name of the functor class
+     */
+    virtual const std::string& name() const;
+
+    /**
+     * Returns a pointer to a clone of this functor.
+     */
+    virtual histogramThresholding* clone() const;
+
+    /**
+     * Returns a pointer to a new instance of this functor.
+     */
+    virtual histogramThresholding* newInstance() const;
+
+    /**
+     * Returns used parameters
+     */
+    const parameters& getParameters() const;
+
+    /**
+     * Set the input channel and compute its histogram.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool use(const channel& src);
+
+    /**
+     * Set the input channel and compute its histogram.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool use(const channel8& src);
+
+    /**
+     * Use the given histogram instead of the one of a channel, for
+     * instance the sum of the histograms of a whole set of images.
+     *
+     * Only the threshold search (interval() and thresholds()) is possible
+     * afterwards, since there is no channel to apply them to.  Use
+     * apply(src,from,to,mask) to threshold each channel with the result.
+     *
+     * @param histogram histogram with parameters::histogramBins bins
+     *                  covering [0,1]
+     * @param minValue smallest value of the histogrammed data, in [0,1]
+     * @param maxValue largest value of the histogrammed data, in [0,1]
+     * @return true if successful, false otherwise
+     */
+    bool use(const ivector& histogram,
+             const float minValue=0.0f,
+             const float maxValue=1.0f);
+
+    /**
+     * Compute the foreground interval of the channel given with use() for
+     * the current parameters.
+     *
+     * @param from lower limit of the foreground, in [0,1]
+     * @param to upper limit of the foreground, in [0,1]
+     * @return true if successful, false otherwise
+     */
+    bool interval(float& from,float& to);
+
+    /**
+     * Threshold the channel given with use() with the current parameters.
+     *
+     * The background and foreground values of the parameters are scaled
+     * by 255.
+     *
+     * @param mask the resulting mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(channel8& mask);
+
+    /**
+     * Threshold the given channel.  This is equivalent to calling use()
+     * and then apply().
+     *
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& src,channel8& mask);
+
+    /**
+     * Threshold the given channel.  This is equivalent to calling use()
+     * and then apply().
+     *
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel8& src,channel8& mask);
+
+    /**
+     * Threshold the given channel with a known foreground interval, for
+     * instance one computed by interval() for another channel or for a
+     * histogram given with use().  The method, the local method and the
+     * input set with use() are ignored.
+     *
+     * @param src the channel
+     * @param from lower limit of the foreground, in [0,1]
+     * @param to upper limit of the foreground, in [0,1]
+     * @param mask the resulting mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel8& src,
+               const float from,
+               const float to,
+               channel8& mask) const;
+
+    /**
+     * Threshold the given channel with a known foreground interval, for
+     * instance one computed by interval() for another channel or for a
+     * histogram given with use().  The method, the local method and the
+     * input set with use() are ignored.
+     *
+     * @param src the channel
+     * @param from lower limit of the foreground, in [0,1]
+     * @param to upper limit of the foreground, in [0,1]
+     * @param mask the resulting mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(const channel& src,
+               const float from,
+               const float to,
+               channel8& mask) const;
+
+    /**
+     * Threshold the channel given with use() into a binary mask, where
+     * the foreground pixels are set.  The background and foreground values
+     * and the keep flags of the parameters are ignored.
+     *
+     * @param mask the resulting mask
+     * @return true if successful, false otherwise
+     */
+    bool apply(bitMask& mask);
+
+    /**
+     * Compute the parameters::classes-1 thresholds of the multi-level Otsu
+     * method for the channel given with use().
+     *
+     * @param thresholds the lower limits of all classes but the first one,
+     *                   in increasing order, in [0,1]
+     * @return true if successful, false otherwise
+     */
+    bool thresholds(fvector& thresholds);
+
+    /**
+     * Label the channel given with use() with the classes of the
+     * multi-level Otsu method.
+     *
+     * @param labels the class of each pixel, from 0 (darkest) to
+     *               parameters::classes-1 (brightest)
+     * @return true if successful, false otherwise
+     */
+    bool label(channel8& labels);
+
+    /**
+     * Histogram of the channel given with use(), with
+     * parameters::histogramBins bins covering [0,1].
+     */
+    const ivector& getHistogram() const;
+
+  protected:
+    /**
+     * Integral images and local thresholds, computed in parallel
+     */
+    class localJob;
+
+    /**
+     * Threshold with the local adaptive method of the given parameters
+     */
+    bool localThreshold(const parameters& par,channel8& mask) const;
+
+    /**
+     * Compute histogram_ with the given number of bins
+     */
+    bool computeHistogram(const int bins);
+
+    /**
+     * Threshold bin maximizing the between-class variance within the bins
+     * [first,last]
+     */
+    int otsu(const int first,const int last) const;
+
+    /**
+     * First bin of each class but the first one maximizing the
+     * between-class variance of the whole histogram
+     */
+    bool multiOtsu(const int classes,std::vector<int>& starts) const;
+
+    /**
+     * Threshold bin of the iterative selection within the bins
+     * [first,last]
+     */
+    int simple(const int first,const int last,const float deltaT) const;
+
+    /**
+     * Bin of the given value in [0,1]
+     */
+    inline int bin(const float value) const;
+
+    /**
+     * Input channel, only one of both is not empty
+     */
+    //@{
+    channel src_;
+    channel8 src8_;
+    //@}
+
+    /**
+     * Histogram of the input
+     */
+    ivector histogram_;
+
+    /**
+     * Extreme values of the input, in [0,1]
+     */
+    float min_,max_;
+  };
+
+  /**
+   * Read a histogramThresholding::eLocalMethod
+   *
+   * @ingroup gStorable
+   */
+  bool read(ioHandler& handler,histogramThresholding::eLocalMethod& data);
+
+  /**
+   * Write a histogramThresholding::eLocalMethod
+   *
+   * @ingroup gStorable
+   */
+  bool write(ioHandler& handler,
+             const histogramThresholding::eLocalMethod& data);
+}
+
+#endif
@@ -10,6 +10,11 @@
 #include <ltiLispStreamHandler.h>
 
 #include <ltiThresholding.h>
+#include "ltiHistogramThresholding.h"
+#include "ltiHistogramEngine.h"
+#include "ltiWorkerPool.h"
+#include "ltiImageFiles.h"
+#include <ltiMutex.h>
 
 #include <ltiDraw.h>
 #include <ltiViewer2D.h>
@@ -26,6 +31,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <vector>
 
 // Debug
 
@@ -40,7 +46,7 @@ using std::endl;
 
 
 thresh::thresh(int argc, char* argv[]) 
-  : task_(None) {
+  : task_(None),batch_(false),threads_(0),outputDir_(".") {
   parse(argc,argv);
 }
 
@@ -53,7 +59,13 @@ void thresh::usage() const {
     "usage: thresholding [options] <image> \n\n" \
     "       -f      Use gray-channel of floats\n" \
     "       -8      Use gray-channel of bytes\n" \
-    "       <image>  input image" << std::endl; 
+    "       -b      Batch mode: one global threshold for all images, with\n" \
+    "               the method of thresholding.lsp (e.g. Otsu), no viewer\n" \
+    "       -j n    Number of threads in batch mode (default: one per CPU)\n"\
+    "       -o dir  Output directory for the masks in batch mode\n" \
+    "       -L file File with one image name per line (batch mode)\n" \
+    "       <image>  input image\n" \
+    "       <dir>    all images in the directory (batch mode)" << std::endl; 
 }
 
 void thresh::help() const {
@@ -66,9 +78,14 @@ void thresh::help() const {
     " S      Simple adaption in interval.\n" \
     " d      Direct threshold.\n" \
     " r      Relative threshold.\n" \
+    " a      Cycle global/Niblack/Sauvola local thresholds (with -f or -8).\n" \
+    " w      Select local window size.\n" \
+    " k      Select local k.\n" \
+    " M      Toggle multi-level Otsu labels (with -f or -8).\n" \
+    " c      Select number of multi-level classes.\n" \
     " b      Toggle keep background\n" \
     " f      Toggle keep foreground\n" \
-    " Arrows Increase/Decrease selected threshold.\n" \
+    " Arrows Increase/Decrease selected threshold or local parameter.\n" \
     " ?      Print this message.\n" << std::endl;
 }
 
@@ -87,12 +104,16 @@ void thresh::parse(int argc, char*argv[]) {
     {"float",no_argument,0,'f'},
     {"byte",no_argument,0,'8'},
     {"help",no_argument,0,'h'},
+    {"batch",no_argument,0,'b'},
+    {"threads",required_argument,0,'j'},
+    {"output",required_argument,0,'o'},
+    {"list",required_argument,0,'L'},
     {0,0,0,0}
   };
 
   int optionIdx;
 
-  while ((c = getopt_long(argc, argv, "f8h", lopts,&optionIdx)) != -1) {
+  while ((c = getopt_long(argc, argv, "f8hbj:o:L:", lopts,&optionIdx)) != -1) {
     switch (c) {
     case 'f':
       task_=Float;
@@ -100,6 +121,19 @@ void thresh::parse(int argc, char*argv[]) {
     case '8':
       task_=Byte;
       break;
+    case 'b':
+      batch_=true;
+      break;
+    case 'j':
+      threads_=atoi(optarg);
+      break;
+    case 'o':
+      outputDir_=optarg;
+      break;
+    case 'L':
+      listFile_=optarg;
+      batch_=true;
+      break;
     case 'h':
       usage();
       exit(EXIT_SUCCESS);
@@ -113,13 +147,15 @@ void thresh::parse(int argc, char*argv[]) {
   if (optind < argc) {
     imgFile_ = argv[optind];
   }
-  
 
-}
+  while (optind < argc) {
+    inputs_.push_back(argv[optind++]);
+  }
 
+}
 
-bool thresh::apply() {
-  lti::thresholding::parameters thPar;
+void thresh::loadParameters(lti::histogramThresholding::parameters& thPar)
+  const {
   static const std::string filethresh("thresholding.lsp");
 
   lti::lispStreamHandler lsh;
@@ -134,17 +170,25 @@ bool thresh::apply() {
     out.close();
   }
   in.close();
+}
+
+bool thresh::apply() {
+  lti::histogramThresholding::parameters thPar;
+  loadParameters(thPar);
+
+  if (batch_) {
+    return batch();
+  }
 
   help();
 
-  lti::thresholding thresh;
+  lti::histogramThresholding hthresh(thPar);
 
   lti::ioImage loader;
   lti::image img;
   lti::channel chnl;
   lti::channel8 chnl8;
   lti::channel8 mask;
-  lti::imatrix imask;
   lti::ipoint pos;
 
   if (!loader.load(imgFile_,img)) {
@@ -159,37 +203,114 @@ bool thresh::apply() {
   static lti::viewer2D oview("input image");
   oview.show(chnl8);
 
-  // compute the histogram for display
-  lti::vector<int> histo(256,0);
-  lti::channel8::const_iterator it(chnl8.begin()),eit(chnl8.end());
-  
-  while (it!=eit) {
-    histo.at(*it)++;
-    ++it;
+  // The histogram is computed only here, and all threshold searches of
+  // the interactive loop reuse it
+  if (task_ == Float) {
+    hthresh.use(chnl);
+  } else {
+    hthresh.use(chnl8);
   }
-  
+
   static lti::viewer1D hview("Histogram");
-  hview.show(histo);
+  hview.show(hthresh.getHistogram());
 
 
   lti::viewer2D::interaction action;
   lti::viewer2D view("thresholding");
 
-  bool high = false; // flag to indicate if we change the low or the high thr.
+  // what the arrows change
+  enum eState {
+    LowThresh,
+    HighThresh,
+    Window,
+    LocalK,
+    Classes
+  };
+
+  eState state = LowThresh;
+
+  static const char* localNames[] = {
+    "Global",
+    "Niblack",
+    "Sauvola"
+  };
+
+  float from,to;
+  bool multiLevel = false;
+  lti::bitMask bits;
+  lti::fvector thresholds;
 
   do {
-    thresh.setParameters(thPar);
+    // the gray values of the binary masks
+    const lti::ubyte fg = static_cast<lti::ubyte>(
+      lti::within(lti::iround(255.0f*thPar.foregroundValue),0,255));
+    const lti::ubyte bg = static_cast<lti::ubyte>(
+      lti::within(lti::iround(255.0f*thPar.backgroundValue),0,255));
 
     switch(task_) {
     case Byte:
-      thresh.apply(chnl8,mask);
-      break;
     case Float:
-      thresh.apply(chnl,mask);
+      hthresh.setParameters(thPar);
+      if (multiLevel) {
+        if (hthresh.label(mask) && hthresh.thresholds(thresholds)) {
+          // spread the labels over the gray values to see them
+          const int step = 255/lti::max(1,thPar.classes-1);
+          lti::channel8::iterator it,eit;
+          for (it=mask.begin(),eit=mask.end();it!=eit;++it) {
+            *it = static_cast<lti::ubyte>(*it*step);
+          }
+          std::cout << "  Thresholds";
+          for (int i=0;i<thresholds.size();++i) {
+            std::cout << " " << thresholds.at(i);
+          }
+          std::cout << std::endl;
+        } else {
+          std::cout << hthresh.getStatusString() << std::endl;
+        }
+        break;
+      }
+      if (!hthresh.apply(mask)) {
+        std::cout << hthresh.getStatusString() << std::endl;
+        break;
+      }
+      if ((thPar.localMethod == lti::histogramThresholding::Global) &&
+          hthresh.interval(from,to)) {
+        std::cout << "  Thresholds [" << from << "," << to << "]"
+                  << std::endl;
+      }
+      // the area fraction is just a population count of the packed mask.
+      // Without the keep flags the foreground is exactly the pixels with
+      // the foreground value, so that the mask just computed is packed
+      // instead of thresholding again (twice as expensive for the local
+      // methods).
+      bool packed;
+      if (!thPar.keepForeground && !thPar.keepBackground && (fg != bg)) {
+        bits.castFrom(mask,fg);
+        packed = true;
+      } else {
+        packed = hthresh.apply(bits);
+      }
+      if (packed) {
+        std::cout << "  Foreground " << 100.0*bits.fraction() << "%"
+                  << std::endl;
+      }
       break;
     default:
-      thresh.apply(img,imask);
-      mask.castFrom(imask);
+      // the intensity channel is thresholded into a bit-packed mask, which
+      // is only expanded for the viewer.  The kept gray values of the keep
+      // flags do not fit in one bit, so they need the byte mask.
+      hthresh.setParameters(thPar);
+      if (thPar.keepForeground || thPar.keepBackground) {
+        if (!hthresh.apply(mask)) {
+          std::cout << hthresh.getStatusString() << std::endl;
+        }
+      } else if (hthresh.apply(bits)) {
+        bits.castTo(mask,bg,fg);
+        std::cout << "  Foreground " << 100.0*bits.fraction() << "%"
+                  << std::endl;
+      } else {
+        std::cout << hthresh.getStatusString() << std::endl;
+      }
       break;
     }      
 
@@ -200,13 +321,48 @@ bool thresh::apply() {
     case lti::viewer2D::KeyPressed:
       switch(action.key) {
       case 'h': 
-        high=true;
+        state=HighThresh;
         std::cout << "Setting high threshold" << std::endl;
         break;
       case 'l':
-        high=false;
+        state=LowThresh;
         std::cout << "Setting low threshold" << std::endl;
         break;
+      case 'a':
+        if (task_ == None) {
+          std::cout << "Use -f or -8 for the local thresholds" << std::endl;
+          break;
+        }
+        thPar.localMethod = static_cast<lti::histogramThresholding::
+          eLocalMethod>((thPar.localMethod+1) % 3);
+        std::cout << localNames[thPar.localMethod] << " thresholds"
+                  << std::endl;
+        break;
+      case 'w':
+        state=Window;
+        std::cout << "Setting local window size" << std::endl;
+        break;
+      case 'k':
+        state=LocalK;
+        std::cout << "Setting local k" << std::endl;
+        break;
+      case 'M':
+        if (task_ == None) {
+          std::cout << "Use -f or -8 for the multi-level labels" << std::endl;
+          break;
+        }
+        multiLevel = !multiLevel;
+        if (multiLevel) {
+          std::cout << "Multi-level Otsu with " << thPar.classes
+                    << " classes" << std::endl;
+        } else {
+          std::cout << "Foreground mask" << std::endl;
+        }
+        break;
+      case 'c':
+        state=Classes;
+        std::cout << "Setting number of classes" << std::endl;
+        break;
       case 'o':
         thPar.method = lti::thresholding::Otsu;
         std::cout << "Otsu method" << std::endl;
@@ -253,7 +409,22 @@ bool thresh::apply() {
         break;
       case 65362: // up
       case 65363: // right
-        if (high) {
+        if (state == Window) {
+          thPar.windowSize += 2;
+          std::cout << "  Window size " << thPar.windowSize << std::endl;
+          break;
+        }
+        if (state == LocalK) {
+          thPar.localK += 0.05f;
+          std::cout << "  Local k " << thPar.localK << std::endl;
+          break;
+        }
+        if (state == Classes) {
+          thPar.classes = lti::min(8,thPar.classes+1);
+          std::cout << "  Classes " << thPar.classes << std::endl;
+          break;
+        }
+        if (state == HighThresh) {
           thPar.foreground.to += 0.01;
           if (thPar.foreground.to >= 1.0f) {
             thPar.foreground.to = 1.0f;
@@ -274,7 +445,22 @@ bool thresh::apply() {
       case 65361: // left
       case 65364: // down
 
-        if (high) {
+        if (state == Window) {
+          thPar.windowSize = lti::max(3,thPar.windowSize-2);
+          std::cout << "  Window size " << thPar.windowSize << std::endl;
+          break;
+        }
+        if (state == LocalK) {
+          thPar.localK -= 0.05f;
+          std::cout << "  Local k " << thPar.localK << std::endl;
+          break;
+        }
+        if (state == Classes) {
+          thPar.classes = lti::max(2,thPar.classes-1);
+          std::cout << "  Classes " << thPar.classes << std::endl;
+          break;
+        }
+        if (state == HighThresh) {
           thPar.foreground.to -= 0.01;
           if (thPar.foreground.to <= thPar.foreground.from) {
             thPar.foreground.to = thPar.foreground.from;
@@ -309,6 +495,400 @@ bool thresh::apply() {
   return false;
 }
 
+/*
+ * Batch mode
+ */
+
+/**
+ * First pass of the batch mode: each item is one image file.
+ *
+ * Every worker decodes its images one after the other and adds their
+ * histograms into its own private histogram, so that the threads never
+ * share anything while counting.  Afterwards, reduce() adds the private
+ * histograms pairwise in a tree, also in parallel: in each step the
+ * worker histogram i receives the one at i+step, for all i multiple of
+ * 2*step, until the sum of all ends in the first one.
+ */
+class thresh::histogramJob : public lti::workerPool::job {
+public:
+  histogramJob(const std::vector<std::string>& files,
+               const int bins,
+               const eTasks task,
+               const int workers)
+    : files_(files),task_(task),step_(0),
+      data_(workers,static_cast<workerData*>(0)) {
+    for (int i=0;i<workers;++i) {
+      data_[i]=new workerData(bins);
+    }
+  }
+
+  ~histogramJob() {
+    for (unsigned int i=0;i<data_.size();++i) {
+      delete data_[i];
+      data_[i]=0;
+    }
+  }
+
+  virtual void process(const int from,const int to,const int worker) {
+    if (step_ > 0) {
+      // reduction: item i adds the histograms of the pair i
+      for (int i=from;i<to;++i) {
+        const int dest = 2*step_*i;
+        data_[dest]->merge(*data_[dest+step_]);
+      }
+      return;
+    }
+
+    workerData& d = *data_[worker];
+
+    for (int i=from;i<to;++i) {
+      const std::string& file = files_[i];
+      if (!d.loader.load(file,d.img)) {
+        report("Image '" + file + "' could not be read: " +
+               d.loader.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      bool ok;
+      if (task_ == Float) {
+        d.chnl.castFrom(d.img);
+        ok = d.engine.apply(d.chnl,d.hist);
+      } else {
+        d.chnl8.castFrom(d.img);
+        ok = d.engine.apply(d.chnl8,d.hist);
+      }
+
+      if (!ok) {
+        report("Histogram of '" + file + "' failed: " +
+               d.engine.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      d.total.add(d.hist);
+      d.minValue = lti::min(d.minValue,d.engine.getMinimum());
+      d.maxValue = lti::max(d.maxValue,d.engine.getMaximum());
+      d.processed++;
+      d.pixels += static_cast<double>(d.img.rows())*d.img.columns();
+    }
+  }
+
+  /**
+   * Add the histograms of all workers into the first one, with
+   * log2(workers) parallel steps of the given pool.
+   */
+  void reduce(lti::workerPool& pool) {
+    const int workers = static_cast<int>(data_.size());
+    for (step_=1;step_<workers;step_*=2) {
+      // number of pairs (i,i+step) with i multiple of 2*step
+      const int pairs = (workers-step_+2*step_-1)/(2*step_);
+      pool.apply(*this,pairs);
+    }
+    step_=0;
+  }
+
+  /**
+   * Histogram of all images, valid after reduce()
+   */
+  const lti::ivector& histogram() const {
+    return data_[0]->total;
+  }
+
+  /**
+   * Smallest value of all images, valid after reduce()
+   */
+  float minValue() const {
+    return data_[0]->minValue;
+  }
+
+  /**
+   * Largest value of all images, valid after reduce()
+   */
+  float maxValue() const {
+    return data_[0]->maxValue;
+  }
+
+  /**
+   * Number of images whose histogram was computed, valid after reduce()
+   */
+  int processed() const {
+    return data_[0]->processed;
+  }
+
+  /**
+   * Number of images that could not be read, valid after reduce()
+   */
+  int failed() const {
+    return data_[0]->failed;
+  }
+
+  /**
+   * Total number of pixels counted, valid after reduce()
+   */
+  double pixels() const {
+    return data_[0]->pixels;
+  }
+
+private:
+  /**
+   * Everything a worker needs for itself
+   */
+  struct workerData {
+    workerData(const int bins)
+      : total(bins,0),minValue(1.0f),maxValue(0.0f),
+        processed(0),failed(0),pixels(0.0) {
+      // the images are already distributed among the threads
+      lti::histogramEngine::parameters par;
+      par.bins = bins;
+      par.threads = 1;
+      engine.setParameters(par);
+    }
+
+    /**
+     * Add the accumulated data of other worker
+     */
+    void merge(const workerData& other) {
+      total.add(other.total);
+      minValue = lti::min(minValue,other.minValue);
+      maxValue = lti::max(maxValue,other.maxValue);
+      processed += other.processed;
+      failed += other.failed;
+      pixels += other.pixels;
+    }
+
+    lti::histogramEngine engine;
+    lti::ioImage loader;
+    lti::image img;
+    lti::channel chnl;
+    lti::channel8 chnl8;
+    lti::ivector hist;
+    lti::ivector total;
+    float minValue;
+    float maxValue;
+    int processed;
+    int failed;
+    double pixels;
+  };
+
+  /**
+   * Print an error message without mixing the output of several threads
+   */
+  void report(const std::string& msg) {
+    lock_.lock();
+    std::cerr << msg << std::endl;
+    lock_.unlock();
+  }
+
+  const std::vector<std::string>& files_;
+  const eTasks task_;
+
+  /**
+   * Distance between the histograms added in the current reduction step,
+   * or zero while counting
+   */
+  int step_;
+
+  std::vector<workerData*> data_;
+  lti::mutex lock_;
+};
+
+/**
+ * Second pass of the batch mode: each item is one image file, decoded
+ * again, thresholded with the global interval and saved.  Each worker
+ * holds only the image it is working on.
+ */
+class thresh::maskJob : public lti::workerPool::job {
+public:
+  maskJob(const std::vector<std::string>& files,
+          const lti::histogramThresholding::parameters& par,
+          const float from,
+          const float to,
+          const eTasks task,
+          const std::string& outputDir,
+          const int workers)
+    : files_(files),from_(from),to_(to),task_(task),outputDir_(outputDir),
+      data_(workers,static_cast<workerData*>(0)) {
+    for (int i=0;i<workers;++i) {
+      data_[i]=new workerData(par);
+    }
+  }
+
+  ~maskJob() {
+    for (unsigned int i=0;i<data_.size();++i) {
+      delete data_[i];
+      data_[i]=0;
+    }
+  }
+
+  virtual void process(const int from,const int to,const int worker) {
+    workerData& d = *data_[worker];
+
+    for (int i=from;i<to;++i) {
+      const std::string& file = files_[i];
+      if (!d.loader.load(file,d.img)) {
+        report("Image '" + file + "' could not be read: " +
+               d.loader.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      if (task_ == Float) {
+        d.chnl.castFrom(d.img);
+        d.thresh.apply(d.chnl,from_,to_,d.mask);
+      } else {
+        d.chnl8.castFrom(d.img);
+        d.thresh.apply(d.chnl8,from_,to_,d.mask);
+      }
+
+      const std::string out = lti::maskName(file,outputDir_,"-thresh","png");
+      if (!d.saver.save(out,d.mask)) {
+        report("Mask '" + out + "' could not be written: " +
+               d.saver.getStatusString());
+        d.failed++;
+        continue;
+      }
+
+      d.processed++;
+    }
+  }
+
+  /**
+   * Number of images processed successfully
+   */
+  int processed() const {
+    int n=0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->processed;
+    }
+    return n;
+  }
+
+  /**
+   * Number of images that could not be read or written
+   */
+  int failed() const {
+    int n=0;
+    for (unsigned int i=0;i<data_.size();++i) {
+      n+=data_[i]->failed;
+    }
+    return n;
+  }
+
+private:
+  /**
+   * Everything a worker needs for itself
+   */
+  struct workerData {
+    workerData(const lti::histogramThresholding::parameters& par)
+      : thresh(par),processed(0),failed(0) {
+    }
+
+    lti::histogramThresholding thresh;
+    lti::ioImage loader;
+    lti::ioImage saver;
+    lti::image img;
+    lti::channel chnl;
+    lti::channel8 chnl8;
+    lti::channel8 mask;
+    int processed;
+    int failed;
+  };
+
+  /**
+   * Print an error message without mixing the output of several threads
+   */
+  void report(const std::string& msg) {
+    lock_.lock();
+    std::cerr << msg << std::endl;
+    lock_.unlock();
+  }
+
+  const std::vector<std::string>& files_;
+  const float from_;
+  const float to_;
+  const eTasks task_;
+  const std::string outputDir_;
+  std::vector<workerData*> data_;
+  lti::mutex lock_;
+};
+
+bool thresh::batch() {
+  lti::histogramThresholding::parameters thPar;
+  loadParameters(thPar);
+
+  if (thPar.localMethod != lti::histogramThresholding::Global) {
+    cerr << "The local methods have no global threshold: using "
+         << "localMethod Global." << endl;
+    thPar.localMethod = lti::histogramThresholding::Global;
+  }
+
+  std::vector<std::string> files;
+  if (!lti::collectImageFiles(inputs_,listFile_,files)) {
+    cerr << "List file '" << listFile_ << "' could not be read." << endl;
+  }
+
+  if (files.empty()) {
+    cerr << "No images to process." << endl;
+    usage();
+    return false;
+  }
+
+  std::vector<std::string> conflicts;
+  if (!lti::uniqueMaskNames(files,outputDir_,"-thresh","png",conflicts)) {
+    for (unsigned int i=0;i<conflicts.size();++i) {
+      cerr << conflicts[i] << endl;
+    }
+    return false;
+  }
+
+  lti::workerPool pool(threads_);
+
+  cout << "Computing the histograms of " << files.size() << " images with "
+       << pool.size() << " threads..." << endl;
+
+  // first pass: decode all images and merge their histograms
+  lti::timer chrono;
+  chrono.start();
+  histogramJob hjob(files,thPar.histogramBins,task_,pool.size());
+  pool.apply(hjob,static_cast<int>(files.size()));
+  hjob.reduce(pool);
+  chrono.stop();
+
+  double secs = chrono.getTime()/1000000.0;
+  cout << "Histograms of " << hjob.processed() << " images ("
+       << hjob.failed() << " failed) in " << secs << " s: "
+       << hjob.pixels()/(secs*1000000.0) << " Mpixel/s" << endl;
+
+  if (hjob.processed() == 0) {
+    return false;
+  }
+
+  // the global threshold, computed once
+  lti::histogramThresholding hthresh(thPar);
+  float from,to;
+  if (!hthresh.use(hjob.histogram(),hjob.minValue(),hjob.maxValue()) ||
+      !hthresh.interval(from,to)) {
+    cerr << hthresh.getStatusString() << endl;
+    return false;
+  }
+
+  cout << "  Global thresholds [" << from << "," << to << "]" << endl;
+
+  // second pass: threshold and save the images one by one
+  chrono.start();
+  maskJob mjob(files,thPar,from,to,task_,outputDir_,pool.size());
+  pool.apply(mjob,static_cast<int>(files.size()));
+  chrono.stop();
+
+  secs = chrono.getTime()/1000000.0;
+  cout << "Saved " << mjob.processed() << " masks ("
+       << mjob.failed() << " failed) in " << secs << " s: "
+       << mjob.processed()/secs << " images/s" << endl;
+
+  return (hjob.failed() == 0) && (mjob.failed() == 0);
+}
+
 /*
  * Main method
  */
@@ -37,6 +37,8 @@
  */
 
 #include <string>
+#include <vector>
+#include "ltiHistogramThresholding.h"
 
 /**
  * This class is creates and shows adaptive shape models
@@ -83,6 +85,30 @@ private:
    */
   void help() const;
 
+  /**
+   * Read the parameters from thresholding.lsp, or create that file with
+   * the default values if it cannot be read.
+   */
+  void loadParameters(lti::histogramThresholding::parameters& thPar) const;
+
+  /**
+   * Headless processing of a whole set of images with one global
+   * threshold: the histograms of all images are merged, the threshold is
+   * computed once on the result, and then applied to all images.
+   * \return true if all images could be processed, false otherwise
+   */
+  bool batch();
+
+  /**
+   * Job computing the histograms of the images in batch mode
+   */
+  class histogramJob;
+
+  /**
+   * Job thresholding and saving the images in batch mode
+   */
+  class maskJob;
+
   /**
    * Attributes
    */
@@ -96,6 +122,32 @@ private:
    * Image file name
    */
   std::string imgFile_;
+
+  /**
+   * Batch mode: no viewer, threshold all given images with one global
+   * threshold and save the masks
+   */
+  bool batch_;
+
+  /**
+   * Number of worker threads in batch mode (0: one per processor)
+   */
+  int threads_;
+
+  /**
+   * Directory where the masks are saved in batch mode
+   */
+  std::string outputDir_;
+
+  /**
+   * File containing a list of images (one per line) for batch mode
+   */
+  std::string listFile_;
+
+  /**
+   * All images and directories given in the command line
+   */
+  std::vector<std::string> inputs_;
   //@}
 
 };
@@ -1,4 +1,10 @@
-((backgroundValue 0)
+((localMethod "Global")
+ (windowSize 31)
+ (localK 0.2)
+ (dynamicRange 0.5)
+ (threads 0)
+ (classes 3)
+ (backgroundValue 0)
  (foregroundValue 1)
  (foreground (0.5 1))
  (method "Direct")